@@ -0,0 +1,135 @@
+#include "AppConfig.h"
+
+#include <iostream>
+
+// Libconfig.
+#include <libconfig.h++>
+
+using namespace libconfig;
+
+// Lê um vetor (x, y, z) de uma configuração, com valor padrão quando ausente.
+static glm::vec3 read_vec3(const Setting& parent, const char* name, glm::vec3 fallback) {
+	if (!parent.exists(name)) {
+		return fallback;
+	}
+	const Setting& value = parent[name];
+	return glm::vec3((float)value[0], (float)value[1], (float)value[2]);
+}
+
+static void read_objects(const Setting& list, std::vector<ObjectConfig>& objects) {
+	objects.clear();
+	objects.resize(list.getLength());
+	for (int i = 0; i < list.getLength(); i++) {
+		const Setting& entry = list[i];
+		ObjectConfig& object = objects[i];
+		object.objPath = (const char*)entry.lookup("obj_path");
+		object.texturePath = (const char*)entry.lookup("texture_path");
+		object.position = read_vec3(entry, "position", object.position);
+		object.scale = read_vec3(entry, "scale", object.scale);
+		entry.lookupValue("rotation", object.rotation);
+		entry.lookupValue("zoom", object.zoom);
+		entry.lookupValue("orbit_radius", object.orbitRadius);
+		entry.lookupValue("orbit_height", object.orbitHeight);
+	}
+}
+
+bool parse_app_config(const std::string& path, AppConfig& config, std::string& error) {
+	try {
+		Config cfg;
+		cfg.readFile(path.c_str());
+
+		config.windowWidth = cfg.lookup("window_width");
+		config.windowHeight = cfg.lookup("window_height");
+		config.windowTitle = (const char*)cfg.lookup("window_title");
+
+		config.fov = cfg.lookup("fov");
+		config.cameraPosition = read_vec3(cfg.getRoot(), "position", config.cameraPosition);
+		config.cameraOrientation = read_vec3(cfg.getRoot(), "orientation", config.cameraOrientation);
+		config.viewX = read_vec3(cfg.getRoot(), "view_x", config.viewX);
+		config.viewY = read_vec3(cfg.getRoot(), "view_y", config.viewY);
+		config.viewZ = read_vec3(cfg.getRoot(), "view_z", config.viewZ);
+
+		config.lightPos = read_vec3(cfg.getRoot(), "light_pos", config.lightPos);
+		config.lightColor = read_vec3(cfg.getRoot(), "light_color", config.lightColor);
+
+		config.vertexShaderPath = (const char*)cfg.lookup("vertex_shader_path");
+		config.fragmentShaderPath = (const char*)cfg.lookup("fragment_shader_path");
+
+		cfg.lookupValue("loader_threads", config.loaderThreads);
+		cfg.lookupValue("indexed_geometry", config.indexedGeometry);
+		cfg.lookupValue("mesh_cache", config.meshCache);
+		cfg.lookupValue("texture_upload_kb", config.textureUploadKb);
+		cfg.lookupValue("texture_arrays", config.textureArrays);
+		cfg.lookupValue("print_stats", config.printStats);
+		cfg.lookupValue("instancing", config.instancing);
+		cfg.lookupValue("render_queue", config.renderQueue);
+		cfg.lookupValue("lod_pixel_error", config.lodPixelError);
+		cfg.lookupValue("frustum_culling", config.frustumCulling);
+		cfg.lookupValue("scene_bvh", config.sceneBvh);
+		cfg.lookupValue("stress_instances", config.stressInstances);
+
+		config.scenePath.clear();
+		cfg.lookupValue("scene_path", config.scenePath);
+		if (config.scenePath.empty()) {
+			read_objects(cfg.lookup("objects"), config.objects);
+		} else {
+			Config scene;
+			scene.readFile(config.scenePath.c_str());
+			read_objects(scene.lookup("objects"), config.objects);
+		}
+	} catch (const FileIOException&) {
+		error = "I/O error while reading file.";
+		return false;
+	} catch (const ParseException& pex) {
+		error = std::string("Parse error at ") + pex.getFile() + ":" + std::to_string(pex.getLine()) + " - " +
+				pex.getError();
+		return false;
+	} catch (const SettingException& sex) {
+		error = std::string("Setting error at ") + sex.getPath() + " - " + sex.what();
+		return false;
+	}
+	return true;
+}
+
+bool ConfigStore::load(const std::string& path, std::string& error) {
+	this->path = path;
+	AppConfig config;
+	if (!parse_app_config(path, config, error)) {
+		return false;
+	}
+	publish(config);
+	return true;
+}
+
+bool ConfigStore::reload(std::string& error) {
+	AppConfig config;
+	if (!parse_app_config(path, config, error)) {
+		return false;
+	}
+	publish(config);
+	return true;
+}
+
+void ConfigStore::publish(const AppConfig& config) {
+	std::atomic_store(&current, std::shared_ptr<const AppConfig>(std::make_shared<AppConfig>(config)));
+}
+
+void ConfigStore::startWatching() {
+	watcher.watch(path);
+	std::shared_ptr<const AppConfig> config = get();
+	if (config && !config->scenePath.empty()) {
+		watcher.watch(config->scenePath);
+	}
+	watcher.start([this](const std::vector<std::string>&) {
+		std::string error;
+		if (!reload(error)) {
+			std::cerr << path << ": " << error << " (configuracao anterior mantida)" << std::endl;
+			return;
+		}
+		// Um novo scene_path também passa a ser observado.
+		std::shared_ptr<const AppConfig> reloaded = get();
+		if (!reloaded->scenePath.empty()) {
+			watcher.watch(reloaded->scenePath);
+		}
+	});
+}
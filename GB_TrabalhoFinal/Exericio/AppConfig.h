@@ -0,0 +1,93 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "FileWatcher.h"
+
+// Objeto da lista objects da configuração.
+struct ObjectConfig {
+	std::string objPath;
+	std::string texturePath;
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::vec3 scale = glm::vec3(1.0f);
+	float rotation = 0.0f;
+	float zoom = 0.0f;
+	// Com orbitRadius maior que 0 o objeto orbita em torno do eixo y na altura orbitHeight (como o planeta).
+	float orbitRadius = 0.0f;
+	float orbitHeight = 0.0f;
+};
+
+// Conteúdo do config.txt já interpretado.
+struct AppConfig {
+	// Janela
+	int windowWidth = 800;
+	int windowHeight = 600;
+	std::string windowTitle;
+
+	// Câmera
+	float fov = 1.0f;
+	glm::vec3 cameraPosition = glm::vec3(0.0f);
+	glm::vec3 cameraOrientation = glm::vec3(0.0f);
+	glm::vec3 viewX = glm::vec3(0.0f);
+	glm::vec3 viewY = glm::vec3(0.0f);
+	glm::vec3 viewZ = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	// Luz
+	glm::vec3 lightPos = glm::vec3(0.0f);
+	glm::vec3 lightColor = glm::vec3(1.0f);
+
+	// Shader
+	std::string vertexShaderPath;
+	std::string fragmentShaderPath;
+
+	// Carregamento da geometria
+	int loaderThreads = 0;
+	bool indexedGeometry = true;
+	bool meshCache = true;
+	int textureUploadKb = 4096;	 // enviados por quadro
+	bool textureArrays = true;	 // texturas com o mesmo formato e dimensões em um GL_TEXTURE_2D_ARRAY
+
+	// Desenho
+	bool printStats = false;
+	bool instancing = true;
+	bool renderQueue = true;	 // desenhos de todos os lotes ordenados por estado (false = lote por lote)
+	float lodPixelError = 1.0f;	 // erro aceito, em pixels, na escolha do nível de detalhe (0 = sempre o completo)
+	bool frustumCulling = true;	 // descarta os objetos fora do frustum da câmera antes de desenhar
+	bool sceneBvh = true;		 // descarte consultando a BVH da cena (false = teste vetorizado em cada lote)
+	int stressInstances = 0;
+
+	// Cena: objects vem do config.txt ou, se scenePath não estiver vazio, desse arquivo.
+	std::string scenePath;
+	std::vector<ObjectConfig> objects;
+};
+
+// Lê o arquivo de configuração (e o da cena, se scene_path estiver definido). Em caso de erro retorna false com a
+// descrição em error.
+bool parse_app_config(const std::string& path, AppConfig& config, std::string& error);
+
+// Configuração da aplicação, interpretada uma única vez. Com startWatching, o config.txt e o arquivo da cena são
+// relidos em segundo plano quando mudam e um novo snapshot é publicado; a thread de renderização só lê snapshots
+// imutáveis (get), trocados de forma atômica.
+class ConfigStore {
+   public:
+	bool load(const std::string& path, std::string& error);
+	std::shared_ptr<const AppConfig> get() const { return std::atomic_load(&current); }
+
+	// Relê o arquivo e publica um novo snapshot; em caso de erro o snapshot atual é mantido.
+	bool reload(std::string& error);
+
+	void startWatching();
+	void stopWatching() { watcher.stop(); }
+
+   protected:
+	void publish(const AppConfig& config);
+
+	std::string path;
+	std::shared_ptr<const AppConfig> current;
+	FileWatcher watcher;
+};
@@ -54,6 +54,9 @@ class Camera {
 	void moveUp() { cameraPosition += cameraUp * cameraSpeed; }
 	void moveDown() { cameraPosition -= cameraUp * cameraSpeed; }
 
+	// A próxima posição do mouse passa a ser a referência (sem salto da câmera ao prender o cursor de novo).
+	void resetMousePosition() { cameraStartPosition = true; }
+
 	void updateMatrixByMousePosition(double xpos, double ypos) {
 		if (cameraStartPosition) {
 			mousePositionLastX = xpos;
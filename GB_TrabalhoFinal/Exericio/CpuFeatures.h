@@ -0,0 +1,42 @@
+#pragma once
+
+// Recursos do processador usados pelos caminhos vetorizados (FrustumCulling, MipGenerator e TriangleBvh). CPU_X86
+// marca os alvos x86-64, em que SSE2 sempre existe; as funções AVX2 levam CPU_TARGET_AVX2 e só são chamadas depois de
+// cpu_has_avx2().
+#if defined(__x86_64__) || defined(_M_X64)
+#define CPU_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CPU_TARGET_AVX2
+#else
+// Só as funções AVX2 são compiladas para AVX2; o resto do programa continua rodando em qualquer x86-64.
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// AVX2 no processador e habilitado pelo sistema (registradores YMM preservados). Consultado uma única vez.
+inline bool cpu_has_avx2() {
+#ifdef CPU_X86
+	static const bool avx2 = [] {
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		bool avx2 = (info[1] & (1 << 5)) != 0;
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		return avx2 && osxsave && (_xgetbv(0) & 6) == 6;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}();
+	return avx2;
+#else
+	return false;
+#endif
+}
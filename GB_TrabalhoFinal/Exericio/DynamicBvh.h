@@ -0,0 +1,636 @@
+#pragma once
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "FrustumCulling.h"
+
+// Caixa alinhada aos eixos. A caixa padrão é vazia (boundsMin > boundsMax) e não toca nada.
+struct Aabb {
+	glm::vec3 boundsMin = glm::vec3(FLT_MAX);
+	glm::vec3 boundsMax = glm::vec3(-FLT_MAX);
+
+	glm::vec3 center() const { return (boundsMin + boundsMax) * 0.5f; }
+	// Metade da área da superfície (só as proporções importam para a heurística).
+	float area() const {
+		glm::vec3 size = glm::max(boundsMax - boundsMin, glm::vec3(0.0f));
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+	void extend(const Aabb& box) {
+		boundsMin = glm::min(boundsMin, box.boundsMin);
+		boundsMax = glm::max(boundsMax, box.boundsMax);
+	}
+	void extend(glm::vec3 point) {
+		boundsMin = glm::min(boundsMin, point);
+		boundsMax = glm::max(boundsMax, point);
+	}
+	bool overlaps(const Aabb& box) const {
+		return boundsMin.x <= box.boundsMax.x && boundsMax.x >= box.boundsMin.x && boundsMin.y <= box.boundsMax.y &&
+			   boundsMax.y >= box.boundsMin.y && boundsMin.z <= box.boundsMax.z && boundsMax.z >= box.boundsMin.z;
+	}
+};
+
+inline Aabb aabb_union(const Aabb& a, const Aabb& b) {
+	Aabb box = a;
+	box.extend(b);
+	return box;
+}
+
+// Caixa no mundo de uma malha com caixa (center, extent: centro e meia-diagonal) nas coordenadas do modelo.
+inline Aabb transform_aabb(const glm::mat4& model, glm::vec3 center, glm::vec3 extent) {
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+	glm::vec3 worldExtent = glm::abs(glm::vec3(model[0])) * extent.x + glm::abs(glm::vec3(model[1])) * extent.y +
+							glm::abs(glm::vec3(model[2])) * extent.z;
+	return {worldCenter - worldExtent, worldCenter + worldExtent};
+}
+
+// Semirreta origin + t * direction, t >= 0 (direction não precisa ser unitária: as distâncias saem em múltiplos dela).
+struct Ray {
+	glm::vec3 origin;
+	glm::vec3 direction;
+};
+
+// Semirreta que sai da câmera pelo ponto da tela point (em NDC), desfazendo a projeção e a visualização: começa no
+// plano próximo e aponta para o ponto correspondente no plano distante.
+inline Ray unproject_ray(glm::vec2 point, const glm::mat4& viewProjection) {
+	glm::mat4 inverse = glm::inverse(viewProjection);
+	glm::vec4 nearPoint = inverse * glm::vec4(point, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverse * glm::vec4(point, 1.0f, 1.0f);
+	Ray ray;
+	ray.origin = glm::vec3(nearPoint) / nearPoint.w;
+	ray.direction = glm::normalize(glm::vec3(farPoint) / farPoint.w - ray.origin);
+	return ray;
+}
+
+// Semirreta do mundo nas coordenadas do modelo (inverseModel = inversa da matriz modelo), sem normalizar a direção:
+// as distâncias medidas nela continuam sendo as do mundo.
+inline Ray transform_ray(const glm::mat4& inverseModel, const Ray& ray) {
+	Ray local;
+	local.origin = glm::vec3(inverseModel * glm::vec4(ray.origin, 1.0f));
+	local.direction = glm::vec3(inverseModel * glm::vec4(ray.direction, 0.0f));
+	return local;
+}
+
+// Distância de entrada da semirreta na caixa, se ela entra antes de maxDistance.
+inline bool ray_aabb(const Aabb& box, glm::vec3 origin, glm::vec3 inverseDirection, float maxDistance,
+					 float& entry) {
+	glm::vec3 t0 = (box.boundsMin - origin) * inverseDirection;
+	glm::vec3 t1 = (box.boundsMax - origin) * inverseDirection;
+	glm::vec3 closer = glm::min(t0, t1), farther = glm::max(t0, t1);
+	entry = std::max(std::max(closer.x, closer.y), std::max(closer.z, 0.0f));
+	float exit = std::min(std::min(farther.x, farther.y), std::min(farther.z, maxDistance));
+	return entry <= exit;
+}
+
+// Partição pela heurística de área de superfície (SAH) com faixas, usada nas montagens de DynamicBvh e TriangleBvh: os
+// centros das caixas são distribuídos em SAH_BINS faixas da caixa dos centros em cada eixo e a divisão escolhida é a
+// de menor área * quantidade somada dos dois lados.
+const int SAH_BINS = 16;
+
+// Escala que leva a distância de um centro até centers.boundsMin ao índice da sua faixa (0 nos eixos sem extensão).
+inline glm::vec3 sah_bin_scale(const Aabb& centers) {
+	glm::vec3 extent = centers.boundsMax - centers.boundsMin;
+	glm::vec3 scale(0.0f);
+	for (int axis = 0; axis < 3; axis++) {
+		scale[axis] = extent[axis] > 0.0f ? SAH_BINS / extent[axis] : 0.0f;
+	}
+	return scale;
+}
+
+inline int sah_bin(float center, float minimum, float scale) {
+	return std::min(SAH_BINS - 1, (int)((center - minimum) * scale));
+}
+
+// Caixas e contagens das faixas dos três eixos. Partes somadas com merge em qualquer ordem dão o mesmo resultado
+// (mínimos, máximos e contagens são exatos).
+struct SahBins {
+	Aabb boxes[3][SAH_BINS];
+	size_t counts[3][SAH_BINS] = {};
+
+	void add(const Aabb& box, glm::vec3 center, const Aabb& centers, glm::vec3 scale) {
+		for (int axis = 0; axis < 3; axis++) {
+			int bin = sah_bin(center[axis], centers.boundsMin[axis], scale[axis]);
+			boxes[axis][bin].extend(box);
+			counts[axis][bin]++;
+		}
+	}
+
+	void merge(const SahBins& other) {
+		for (int axis = 0; axis < 3; axis++) {
+			for (int bin = 0; bin < SAH_BINS; bin++) {
+				boxes[axis][bin].extend(other.boxes[axis][bin]);
+				counts[axis][bin] += other.counts[axis][bin];
+			}
+		}
+	}
+};
+
+// Melhor divisão: os centros com faixa <= bin no eixo axis ficam à esquerda. axis = -1 quando nenhuma divisão deixa os
+// dois lados com caixas (centros iguais em todos os eixos).
+struct SahSplit {
+	int axis = -1;
+	int bin = 0;
+};
+
+inline SahSplit sah_best_split(const SahBins& bins, const Aabb& centers) {
+	SahSplit best;
+	float bestCost = FLT_MAX;
+	for (int axis = 0; axis < 3; axis++) {
+		if (centers.boundsMax[axis] <= centers.boundsMin[axis]) {
+			continue;
+		}
+		// Áreas e contagens à direita de cada divisão, depois a varredura da esquerda.
+		float rightArea[SAH_BINS];
+		size_t rightCount[SAH_BINS];
+		Aabb right;
+		size_t rightTotal = 0;
+		for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+			right.extend(bins.boxes[axis][bin]);
+			rightTotal += bins.counts[axis][bin];
+			rightArea[bin] = right.area();
+			rightCount[bin] = rightTotal;
+		}
+		Aabb left;
+		size_t leftTotal = 0;
+		for (int bin = 0; bin < SAH_BINS - 1; bin++) {
+			left.extend(bins.boxes[axis][bin]);
+			leftTotal += bins.counts[axis][bin];
+			if (leftTotal == 0 || rightCount[bin + 1] == 0) {
+				continue;
+			}
+			float cost = left.area() * leftTotal + rightArea[bin + 1] * rightCount[bin + 1];
+			if (cost < bestCost) {
+				bestCost = cost;
+				best.axis = axis;
+				best.bin = bin;
+			}
+		}
+	}
+	return best;
+}
+
+// Hierarquia de volumes envolventes (BVH) dinâmica sobre as entidades da cena, para descarte fora do frustum, seleção
+// com o mouse (raios) e consultas por região, sem percorrer todas as entidades.
+// - Cada entidade é uma folha (proxy) com a sua caixa no mundo e um valor do usuário (ex.: o índice da entidade).
+// - build monta a árvore inteira de uma vez pela heurística de área de superfície (SAH) com partição em faixas;
+//   rebuild refaz a árvore sobre as folhas atuais (os proxies continuam valendo).
+// - insert e remove alteram a árvore aos poucos: a folha nova desce pelo ramo de menor custo e os ancestrais são
+//   rebalanceados com rotações (como na árvore dinâmica do Box2D).
+// - update troca a caixa de uma folha e reajusta (refit) só os ancestrais, sem mudar a topologia; setBounds seguido
+//   de refit faz o mesmo para muitas folhas de uma vez. Com muitas entidades se afastando da posição original as
+//   caixas internas crescem e as consultas ficam mais lentas: rebuild recupera a qualidade.
+// As consultas só leem a árvore e podem rodar em várias threads ao mesmo tempo.
+class DynamicBvh {
+   public:
+	static const int NULL_NODE = -1;
+
+	void clear() {
+		nodes.clear();
+		root = NULL_NODE;
+		freeList = NULL_NODE;
+		leafCount = 0;
+	}
+
+	// Monta a árvore com as caixas informadas: o proxy (e o valor do usuário) da caixa i é i.
+	void build(const std::vector<Aabb>& boxes) {
+		clear();
+		nodes.reserve(boxes.size() * 2);
+		std::vector<int> leaves(boxes.size());
+		for (size_t i = 0; i < boxes.size(); i++) {
+			leaves[i] = allocateNode();
+			Node& leaf = nodes[leaves[i]];
+			leaf.box = boxes[i];
+			leaf.data = (uint32_t)i;
+			leaf.height = 0;
+		}
+		leafCount = (int)boxes.size();
+		buildTree(leaves);
+	}
+
+	// Refaz a árvore sobre as folhas atuais pela SAH, mantendo os proxies.
+	void rebuild() {
+		std::vector<int> leaves;
+		leaves.reserve(leafCount);
+		for (int i = 0; i < (int)nodes.size(); i++) {
+			if (nodes[i].height == 0) {
+				leaves.push_back(i);
+			} else if (nodes[i].height > 0) {
+				freeNode(i);
+			}
+		}
+		buildTree(leaves);
+	}
+
+	// Insere uma folha e retorna o seu proxy.
+	int insert(const Aabb& box, uint32_t data) {
+		int leaf = allocateNode();
+		nodes[leaf].box = box;
+		nodes[leaf].data = data;
+		nodes[leaf].height = 0;
+		insertLeaf(leaf);
+		leafCount++;
+		return leaf;
+	}
+
+	void remove(int proxy) {
+		removeLeaf(proxy);
+		freeNode(proxy);
+		leafCount--;
+	}
+
+	// Troca a caixa da folha e reajusta os ancestrais.
+	void update(int proxy, const Aabb& box) {
+		nodes[proxy].box = box;
+		for (int index = nodes[proxy].parent; index != NULL_NODE; index = nodes[index].parent) {
+			Node& node = nodes[index];
+			node.box = aabb_union(nodes[node.children[0]].box, nodes[node.children[1]].box);
+		}
+	}
+
+	// Troca a caixa da folha sem reajustar os ancestrais (refit deve ser chamado antes da próxima consulta).
+	void setBounds(int proxy, const Aabb& box) { nodes[proxy].box = box; }
+
+	// Reajusta todos os nós internos às caixas das folhas, de baixo para cima.
+	void refit() {
+		if (root == NULL_NODE) {
+			return;
+		}
+		// Pré-ordem invertida: os filhos de cada nó aparecem antes dele.
+		std::vector<int> order;
+		order.reserve(nodes.size());
+		order.push_back(root);
+		for (size_t i = 0; i < order.size(); i++) {
+			const Node& node = nodes[order[i]];
+			if (node.height > 0) {
+				order.push_back(node.children[0]);
+				order.push_back(node.children[1]);
+			}
+		}
+		for (size_t i = order.size(); i-- > 0;) {
+			Node& node = nodes[order[i]];
+			if (node.height > 0) {
+				node.box = aabb_union(nodes[node.children[0]].box, nodes[node.children[1]].box);
+			}
+		}
+	}
+
+	const Aabb& getBounds(int proxy) const { return nodes[proxy].box; }
+	uint32_t getData(int proxy) const { return nodes[proxy].data; }
+	int size() const { return leafCount; }
+	int getHeight() const { return root == NULL_NODE ? 0 : nodes[root].height; }
+
+	// Custo SAH da árvore: soma das áreas dos nós internos relativa à da raiz (quanto menor, menos nós visitados por
+	// consulta).
+	float getCost() const {
+		if (root == NULL_NODE || nodes[root].height == 0) {
+			return 0.0f;
+		}
+		float sum = 0.0f;
+		for (const Node& node : nodes) {
+			if (node.height > 0) {
+				sum += node.box.area();
+			}
+		}
+		float rootArea = nodes[root].box.area();
+		return rootArea > 0.0f ? sum / rootArea : 0.0f;
+	}
+
+	// visit(data) para cada folha que toca o frustum. Subárvores inteiramente dentro de um plano não testam mais
+	// esse plano; as inteiramente dentro de todos são visitadas sem testes.
+	template <typename Visitor>
+	void queryFrustum(const Frustum& frustum, Visitor visit) const {
+		if (root == NULL_NODE) {
+			return;
+		}
+		struct Entry {
+			int node;
+			int planes;	 // bits dos planos que ainda precisam ser testados
+		};
+		std::vector<Entry> stack;
+		stack.reserve(64);
+		stack.push_back({root, frustum.enabled ? 0x3F : 0});
+		while (!stack.empty()) {
+			Entry entry = stack.back();
+			stack.pop_back();
+			const Node& node = nodes[entry.node];
+			int planes = entry.planes;
+			if (planes != 0) {
+				glm::vec3 center = node.box.center();
+				glm::vec3 extent = (node.box.boundsMax - node.box.boundsMin) * 0.5f;
+				bool outside = false;
+				for (int p = 0; p < 6 && !outside; p++) {
+					if (!(planes & (1 << p))) {
+						continue;
+					}
+					const glm::vec4& plane = frustum.planes[p];
+					float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+					float reach = glm::dot(glm::abs(glm::vec3(plane)), extent);
+					outside = distance + reach < 0.0f;
+					if (distance - reach >= 0.0f) {
+						planes &= ~(1 << p);
+					}
+				}
+				if (outside) {
+					continue;
+				}
+			}
+			if (node.height == 0) {
+				visit(node.data);
+			} else {
+				stack.push_back({node.children[0], planes});
+				stack.push_back({node.children[1], planes});
+			}
+		}
+	}
+
+	// Percorre as folhas que a semirreta atravessa antes de maxDistance, das mais próximas para as mais distantes
+	// (pela entrada nas caixas). visit(data, entrada, maxDistance) retorna a nova distância máxima: a do acerto, para
+	// buscar o mais próximo (os nós além dele são descartados), ou maxDistance para visitar todas.
+	template <typename Visitor>
+	void queryRay(const Ray& ray, float maxDistance, Visitor visit) const {
+		if (root == NULL_NODE) {
+			return;
+		}
+		glm::vec3 inverseDirection = 1.0f / ray.direction;
+		struct Entry {
+			int node;
+			float entry;
+		};
+		std::vector<Entry> stack;
+		stack.reserve(64);
+		float entry;
+		if (!ray_aabb(nodes[root].box, ray.origin, inverseDirection, maxDistance, entry)) {
+			return;
+		}
+		stack.push_back({root, entry});
+		while (!stack.empty()) {
+			Entry top = stack.back();
+			stack.pop_back();
+			if (top.entry > maxDistance) {
+				continue;
+			}
+			const Node& node = nodes[top.node];
+			if (node.height == 0) {
+				maxDistance = visit(node.data, top.entry, maxDistance);
+				continue;
+			}
+			float entries[2];
+			bool hits[2];
+			for (int c = 0; c < 2; c++) {
+				hits[c] = ray_aabb(nodes[node.children[c]].box, ray.origin, inverseDirection, maxDistance, entries[c]);
+			}
+			// O filho mais próximo fica no topo da pilha.
+			int first = entries[1] < entries[0] ? 1 : 0;
+			if (hits[1 - first]) {
+				stack.push_back({node.children[1 - first], entries[1 - first]});
+			}
+			if (hits[first]) {
+				stack.push_back({node.children[first], entries[first]});
+			}
+		}
+	}
+
+	// visit(data) para cada folha cuja caixa toca box.
+	template <typename Visitor>
+	void queryOverlap(const Aabb& box, Visitor visit) const {
+		if (root == NULL_NODE) {
+			return;
+		}
+		std::vector<int> stack;
+		stack.reserve(64);
+		stack.push_back(root);
+		while (!stack.empty()) {
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+			if (!node.box.overlaps(box)) {
+				continue;
+			}
+			if (node.height == 0) {
+				visit(node.data);
+			} else {
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+
+   private:
+	// Folhas têm height 0, nós internos a altura da subárvore e nós livres -1 (com parent apontando o próximo livre).
+	struct Node {
+		Aabb box;
+		int parent = NULL_NODE;
+		int children[2] = {NULL_NODE, NULL_NODE};
+		int height = -1;
+		uint32_t data = 0;
+	};
+
+	int allocateNode() {
+		int index;
+		if (freeList != NULL_NODE) {
+			index = freeList;
+			freeList = nodes[index].parent;
+			nodes[index] = Node();
+		} else {
+			index = (int)nodes.size();
+			nodes.emplace_back();
+		}
+		return index;
+	}
+
+	void freeNode(int index) {
+		nodes[index].height = -1;
+		nodes[index].parent = freeList;
+		freeList = index;
+	}
+
+	// Folha durante a montagem: caixa e centro copiados para um array contíguo, particionado no lugar (sem buscar os
+	// nós espalhados pelo vetor a cada nível).
+	struct BuildLeaf {
+		Aabb box;
+		glm::vec3 center;
+		int node;
+	};
+
+	void buildTree(const std::vector<int>& leaves) {
+		std::vector<BuildLeaf> items(leaves.size());
+		for (size_t i = 0; i < leaves.size(); i++) {
+			const Aabb& box = nodes[leaves[i]].box;
+			items[i] = {box, box.center(), leaves[i]};
+		}
+		root = items.empty() ? NULL_NODE : buildRange(items.data(), (int)items.size(), NULL_NODE);
+	}
+
+	// Monta a subárvore das folhas leaves[0, count) e retorna a sua raiz. A partição testa SAH_BINS faixas dos
+	// centros em cada eixo; sem partição útil (centros iguais), divide ao meio.
+	int buildRange(BuildLeaf* leaves, int count, int parent) {
+		if (count == 1) {
+			nodes[leaves[0].node].parent = parent;
+			return leaves[0].node;
+		}
+
+		Aabb centers;
+		for (int i = 0; i < count; i++) {
+			centers.extend(leaves[i].center);
+		}
+		// Uma passada distribui as folhas nas faixas dos três eixos.
+		glm::vec3 scale = sah_bin_scale(centers);
+		SahBins bins;
+		for (int i = 0; i < count; i++) {
+			bins.add(leaves[i].box, leaves[i].center, centers, scale);
+		}
+
+		int middle = count / 2;
+		SahSplit split = sah_best_split(bins, centers);
+		if (split.axis >= 0) {
+			float minimum = centers.boundsMin[split.axis], axisScale = scale[split.axis];
+			BuildLeaf* right = std::partition(leaves, leaves + count, [&](const BuildLeaf& leaf) {
+				return sah_bin(leaf.center[split.axis], minimum, axisScale) <= split.bin;
+			});
+			middle = (int)(right - leaves);
+		}
+
+		int index = allocateNode();
+		int left = buildRange(leaves, middle, index);
+		int right = buildRange(leaves + middle, count - middle, index);
+		Node& node = nodes[index];
+		node.parent = parent;
+		node.children[0] = left;
+		node.children[1] = right;
+		node.box = aabb_union(nodes[left].box, nodes[right].box);
+		node.height = 1 + std::max(nodes[left].height, nodes[right].height);
+		return index;
+	}
+
+	void insertLeaf(int leaf) {
+		if (root == NULL_NODE) {
+			root = leaf;
+			nodes[leaf].parent = NULL_NODE;
+			return;
+		}
+
+		// Desce pelo filho em que a folha aumenta menos a área; para quando virar irmã do nó atual é mais barato.
+		const Aabb box = nodes[leaf].box;
+		int index = root;
+		while (nodes[index].height > 0) {
+			const Node& node = nodes[index];
+			float area = node.box.area();
+			float combinedArea = aabb_union(node.box, box).area();
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+			float childCosts[2];
+			for (int c = 0; c < 2; c++) {
+				const Node& child = nodes[node.children[c]];
+				float grown = aabb_union(box, child.box).area();
+				childCosts[c] = (child.height == 0 ? grown : grown - child.box.area()) + inheritanceCost;
+			}
+			if (cost < childCosts[0] && cost < childCosts[1]) {
+				break;
+			}
+			index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+		}
+
+		int sibling = index;
+		int oldParent = nodes[sibling].parent;
+		int newParent = allocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].box = aabb_union(box, nodes[sibling].box);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[newParent].children[0] = sibling;
+		nodes[newParent].children[1] = leaf;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+		if (oldParent == NULL_NODE) {
+			root = newParent;
+		} else {
+			replaceChild(oldParent, sibling, newParent);
+		}
+		fixAncestors(newParent);
+	}
+
+	void removeLeaf(int leaf) {
+		if (leaf == root) {
+			root = NULL_NODE;
+			return;
+		}
+		int parent = nodes[leaf].parent;
+		int grandParent = nodes[parent].parent;
+		int sibling = nodes[parent].children[0] == leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+		freeNode(parent);
+		if (grandParent == NULL_NODE) {
+			root = sibling;
+			nodes[sibling].parent = NULL_NODE;
+			return;
+		}
+		replaceChild(grandParent, parent, sibling);
+		nodes[sibling].parent = grandParent;
+		fixAncestors(grandParent);
+	}
+
+	void replaceChild(int parent, int oldChild, int newChild) {
+		Node& node = nodes[parent];
+		node.children[node.children[0] == oldChild ? 0 : 1] = newChild;
+	}
+
+	// Rebalanceia e reajusta caixa e altura de index até a raiz.
+	void fixAncestors(int index) {
+		while (index != NULL_NODE) {
+			index = balance(index);
+			Node& node = nodes[index];
+			const Node& left = nodes[node.children[0]];
+			const Node& right = nodes[node.children[1]];
+			node.height = 1 + std::max(left.height, right.height);
+			node.box = aabb_union(left.box, right.box);
+			index = node.parent;
+		}
+	}
+
+	// Se as alturas dos filhos de a diferem em mais de 1, sobe o filho mais alto (c) para o lugar de a e a recebe o
+	// neto mais baixo de c. Retorna o nó que ficou no lugar de a.
+	int balance(int a) {
+		Node& nodeA = nodes[a];
+		if (nodeA.height < 2) {
+			return a;
+		}
+		int heightDifference = nodes[nodeA.children[1]].height - nodes[nodeA.children[0]].height;
+		if (heightDifference >= -1 && heightDifference <= 1) {
+			return a;
+		}
+		int tall = heightDifference > 1 ? 1 : 0;
+		int c = nodeA.children[tall];
+		int b = nodeA.children[1 - tall];
+		Node& nodeC = nodes[c];
+		int f = nodeC.children[0], g = nodeC.children[1];
+		if (nodes[f].height < nodes[g].height) {
+			std::swap(f, g);
+		}
+
+		// c ocupa o lugar de a, com a e o neto mais alto (f) como filhos; a fica com b e o neto mais baixo (g).
+		nodeC.parent = nodeA.parent;
+		if (nodeC.parent == NULL_NODE) {
+			root = c;
+		} else {
+			replaceChild(nodeC.parent, a, c);
+		}
+		nodeC.children[0] = a;
+		nodeC.children[1] = f;
+		nodeA.parent = c;
+		nodeA.children[tall] = g;
+		nodes[g].parent = a;
+
+		nodeA.box = aabb_union(nodes[b].box, nodes[g].box);
+		nodeA.height = 1 + std::max(nodes[b].height, nodes[g].height);
+		nodeC.box = aabb_union(nodeA.box, nodes[f].box);
+		nodeC.height = 1 + std::max(nodeA.height, nodes[f].height);
+		return c;
+	}
+
+	std::vector<Node> nodes;
+	int root = NULL_NODE;
+	int freeList = NULL_NODE;
+	int leafCount = 0;
+};
@@ -0,0 +1,170 @@
+#include "FileWatcher.h"
+
+#include <chrono>
+#include <filesystem>
+#include <set>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Intervalo entre verificações no modo sem inotify.
+static const std::chrono::milliseconds POLL_INTERVAL(250);
+
+// Tempo de espera por mais eventos depois do primeiro: um salvamento costuma gerar vários.
+static const std::chrono::milliseconds SETTLE_TIME(50);
+
+static std::string watch_key(const std::string& path) {
+	return std::filesystem::absolute(path).lexically_normal().string();
+}
+
+void FileWatcher::watch(const std::string& path) {
+	std::lock_guard<std::mutex> lock(mutex);
+	std::string key = watch_key(path);
+	if (files.count(key)) {
+		return;
+	}
+	WatchedFile file;
+	file.path = path;
+	stat_source(path, file.stamp);
+	files[key] = file;
+#ifdef __linux__
+	if (inotifyFd >= 0) {
+		addDirectoryWatch(std::filesystem::path(key).parent_path().string());
+	}
+#endif
+}
+
+void FileWatcher::start(Callback callback) {
+	stop();
+	this->callback = callback;
+#ifdef __linux__
+	inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotifyFd >= 0) {
+		std::lock_guard<std::mutex> lock(mutex);
+		for (const auto& file : files) {
+			addDirectoryWatch(std::filesystem::path(file.first).parent_path().string());
+		}
+	}
+#endif
+	running = true;
+	thread = std::thread(&FileWatcher::run, this);
+}
+
+void FileWatcher::stop() {
+	running = false;
+	if (thread.joinable()) {
+		thread.join();
+	}
+#ifdef __linux__
+	if (inotifyFd >= 0) {
+		close(inotifyFd);
+		inotifyFd = -1;
+		directories.clear();
+	}
+#endif
+}
+
+void FileWatcher::run() {
+#ifdef __linux__
+	if (inotifyFd >= 0) {
+		runInotify();
+		return;
+	}
+#endif
+	runPolling();
+}
+
+void FileWatcher::collectChanged(const std::vector<std::string>& keys, std::vector<std::string>& changed) {
+	std::lock_guard<std::mutex> lock(mutex);
+	for (const std::string& key : keys) {
+		auto file = files.find(key);
+		if (file == files.end()) {
+			continue;
+		}
+		SourceStamp stamp;
+		if (!stat_source(file->second.path, stamp)) {
+			continue;  // removido ou ainda sendo trocado; o próximo evento traz a versão nova
+		}
+		if (stamp.size != file->second.stamp.size || stamp.time != file->second.stamp.time) {
+			file->second.stamp = stamp;
+			changed.push_back(file->second.path);
+		}
+	}
+}
+
+void FileWatcher::runPolling() {
+	while (running) {
+		std::this_thread::sleep_for(POLL_INTERVAL);
+
+		std::vector<std::string> keys;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (const auto& file : files) {
+				keys.push_back(file.first);
+			}
+		}
+		std::vector<std::string> changed;
+		collectChanged(keys, changed);
+		if (!changed.empty() && running) {
+			callback(changed);
+		}
+	}
+}
+
+#ifdef __linux__
+void FileWatcher::addDirectoryWatch(const std::string& directory) {
+	for (const auto& watched : directories) {
+		if (watched.second == directory) {
+			return;
+		}
+	}
+	int descriptor = inotify_add_watch(inotifyFd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (descriptor >= 0) {
+		directories[descriptor] = directory;
+	}
+}
+
+void FileWatcher::runInotify() {
+	alignas(inotify_event) char buffer[4096];
+	std::set<std::string> pending;
+	auto firstEvent = std::chrono::steady_clock::now();
+
+	while (running) {
+		pollfd descriptor = {inotifyFd, POLLIN, 0};
+		int ready = poll(&descriptor, 1, 20);
+
+		if (ready > 0) {
+			ssize_t length;
+			while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+				std::lock_guard<std::mutex> lock(mutex);
+				for (char* cursor = buffer; cursor < buffer + length;) {
+					const inotify_event* event = (const inotify_event*)cursor;
+					auto directory = directories.find(event->wd);
+					if (event->len > 0 && directory != directories.end()) {
+						std::string key = (std::filesystem::path(directory->second) / event->name).string();
+						if (files.count(key)) {
+							if (pending.empty()) {
+								firstEvent = std::chrono::steady_clock::now();
+							}
+							pending.insert(key);
+						}
+					}
+					cursor += sizeof(inotify_event) + event->len;
+				}
+			}
+		}
+
+		if (!pending.empty() && std::chrono::steady_clock::now() - firstEvent >= SETTLE_TIME) {
+			std::vector<std::string> changed;
+			collectChanged(std::vector<std::string>(pending.begin(), pending.end()), changed);
+			pending.clear();
+			if (!changed.empty() && running) {
+				callback(changed);
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SourceStamp.h"
+
+// Observa um conjunto de arquivos em uma thread própria e avisa quando algum deles muda.
+// No Linux usa inotify nos diretórios dos arquivos (assim também percebe editores que gravam em um arquivo temporário e
+// renomeiam); nas demais plataformas, ou se o inotify não estiver disponível, compara tamanho e data periodicamente.
+class FileWatcher {
+   public:
+	// Recebe os caminhos (como passados a watch) dos arquivos alterados. É chamada na thread do observador.
+	using Callback = std::function<void(const std::vector<std::string>& changed)>;
+
+	FileWatcher() {}
+	~FileWatcher() { stop(); }
+
+	FileWatcher(const FileWatcher&) = delete;
+	FileWatcher& operator=(const FileWatcher&) = delete;
+
+	// Passa a observar o arquivo (pode ser chamada antes ou depois de start; caminhos repetidos são ignorados).
+	void watch(const std::string& path);
+	void start(Callback callback);
+	void stop();
+
+   protected:
+	struct WatchedFile {
+		std::string path;
+		SourceStamp stamp;
+	};
+
+	void run();
+	void runPolling();
+	// Arquivos cuja data ou tamanho mudaram desde a última verificação (atualiza os registros).
+	void collectChanged(const std::vector<std::string>& keys, std::vector<std::string>& changed);
+#ifdef __linux__
+	void runInotify();
+	void addDirectoryWatch(const std::string& directory);
+	int inotifyFd = -1;
+	std::map<int, std::string> directories;	 // descritor do inotify -> diretório
+#endif
+
+	std::mutex mutex;
+	std::map<std::string, WatchedFile> files;  // chave: caminho absoluto normalizado
+	Callback callback;
+	std::thread thread;
+	std::atomic<bool> running{false};
+};
@@ -0,0 +1,199 @@
+#include "FrustumCulling.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CpuFeatures.h"
+
+// Alcance das instâncias sempre visíveis: maior que qualquer distância da cena, sem chegar ao infinito (0 * infinito
+// daria NaN nos planos com componentes nulos).
+static const float ALWAYS_VISIBLE_REACH = 1e30f;
+
+Frustum frustum_from_matrix(const glm::mat4& viewProjection) {
+	// Linhas da matriz (a GLM guarda as colunas).
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++) {
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+	Frustum frustum;
+	frustum.planes[0] = rows[3] + rows[0];
+	frustum.planes[1] = rows[3] - rows[0];
+	frustum.planes[2] = rows[3] + rows[1];
+	frustum.planes[3] = rows[3] - rows[1];
+	frustum.planes[4] = rows[3] + rows[2];
+	frustum.planes[5] = rows[3] - rows[2];
+	for (glm::vec4& plane : frustum.planes) {
+		float length = glm::length(glm::vec3(plane));
+		if (length > 0.0f) {
+			plane /= length;
+		}
+	}
+	frustum.enabled = true;
+	return frustum;
+}
+
+void CullBounds::resize(size_t count) {
+	for (std::vector<float>* component : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ, &radius}) {
+		component->resize(count);
+	}
+}
+
+void CullBounds::set(size_t i, const glm::mat4& model, glm::vec3 center, glm::vec3 extent, float localRadius) {
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+	// Meia-diagonal da caixa transformada (Arvo): cada eixo do mundo soma as projeções dos três eixos do modelo.
+	glm::vec3 worldExtent = glm::abs(glm::vec3(model[0])) * extent.x + glm::abs(glm::vec3(model[1])) * extent.y +
+							glm::abs(glm::vec3(model[2])) * extent.z;
+	float scale2 = std::max(glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+							std::max(glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+									 glm::dot(glm::vec3(model[2]), glm::vec3(model[2]))));
+	centerX[i] = worldCenter.x;
+	centerY[i] = worldCenter.y;
+	centerZ[i] = worldCenter.z;
+	extentX[i] = worldExtent.x;
+	extentY[i] = worldExtent.y;
+	extentZ[i] = worldExtent.z;
+	radius[i] = localRadius * std::sqrt(scale2);
+}
+
+void CullBounds::setAlwaysVisible(size_t i) {
+	centerX[i] = centerY[i] = centerZ[i] = 0.0f;
+	extentX[i] = extentY[i] = extentZ[i] = ALWAYS_VISIBLE_REACH;
+	radius[i] = ALWAYS_VISIBLE_REACH;
+}
+
+CullSimd cull_simd_supported() {
+#ifdef CPU_X86
+	return cpu_has_avx2() ? CULL_SIMD_AVX2 : CULL_SIMD_SSE2;
+#else
+	return CULL_SIMD_SCALAR;
+#endif
+}
+
+const char* cull_simd_name(CullSimd simd) {
+	switch (simd) {
+		case CULL_SIMD_SCALAR:
+			return "escalar";
+		case CULL_SIMD_SSE2:
+			return "SSE2";
+		case CULL_SIMD_AVX2:
+			return "AVX2";
+		default:
+			return "auto";
+	}
+}
+
+// Cada plano descarta a instância quando o centro fica atrás dele a uma distância maior que o alcance do volume na
+// direção da normal: o da caixa (soma das meias-diagonais pesadas por |normal|) ou o raio da esfera, o menor.
+static size_t cull_scalar(const Frustum& frustum, const CullBounds& bounds, size_t first, uint32_t* visible,
+						  size_t count) {
+	for (size_t i = first; i < bounds.size(); i++) {
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.planes) {
+			float distance = plane.x * bounds.centerX[i] + plane.y * bounds.centerY[i] + plane.z * bounds.centerZ[i] +
+							 plane.w;
+			float reach = std::fabs(plane.x) * bounds.extentX[i] + std::fabs(plane.y) * bounds.extentY[i] +
+						  std::fabs(plane.z) * bounds.extentZ[i];
+			inside &= distance + std::min(reach, bounds.radius[i]) >= 0.0f;
+		}
+		visible[count] = (uint32_t)i;
+		count += inside ? 1 : 0;
+	}
+	return count;
+}
+
+#ifdef CPU_X86
+// Mesmo teste, 4 instâncias por vez. Retorna quantas instâncias foram testadas (múltiplo de 4); count é atualizado.
+static size_t cull_sse2(const Frustum& frustum, const CullBounds& bounds, uint32_t* visible, size_t& count) {
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 zero = _mm_setzero_ps();
+	size_t tested = bounds.size() & ~(size_t)3;
+	for (size_t i = 0; i < tested; i += 4) {
+		__m128 cx = _mm_loadu_ps(&bounds.centerX[i]);
+		__m128 cy = _mm_loadu_ps(&bounds.centerY[i]);
+		__m128 cz = _mm_loadu_ps(&bounds.centerZ[i]);
+		__m128 ex = _mm_loadu_ps(&bounds.extentX[i]);
+		__m128 ey = _mm_loadu_ps(&bounds.extentY[i]);
+		__m128 ez = _mm_loadu_ps(&bounds.extentZ[i]);
+		__m128 r = _mm_loadu_ps(&bounds.radius[i]);
+		__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (const glm::vec4& plane : frustum.planes) {
+			__m128 nx = _mm_set1_ps(plane.x), ny = _mm_set1_ps(plane.y), nz = _mm_set1_ps(plane.z);
+			__m128 distance =
+				_mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)), _mm_mul_ps(nz, cz)),
+						   _mm_set1_ps(plane.w));
+			__m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+												 _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+									  _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, _mm_min_ps(reach, r)), zero));
+		}
+		// Compactação sem desvios: o índice é sempre escrito e só avança a saída quando a instância é visível.
+		int mask = _mm_movemask_ps(inside);
+		for (int lane = 0; lane < 4; lane++) {
+			visible[count] = (uint32_t)(i + lane);
+			count += (mask >> lane) & 1;
+		}
+	}
+	return tested;
+}
+
+// Mesmo teste, 8 instâncias por vez.
+CPU_TARGET_AVX2 static size_t cull_avx2(const Frustum& frustum, const CullBounds& bounds, uint32_t* visible,
+										 size_t& count) {
+	const __m256 signMask = _mm256_set1_ps(-0.0f);
+	const __m256 zero = _mm256_setzero_ps();
+	size_t tested = bounds.size() & ~(size_t)7;
+	for (size_t i = 0; i < tested; i += 8) {
+		__m256 cx = _mm256_loadu_ps(&bounds.centerX[i]);
+		__m256 cy = _mm256_loadu_ps(&bounds.centerY[i]);
+		__m256 cz = _mm256_loadu_ps(&bounds.centerZ[i]);
+		__m256 ex = _mm256_loadu_ps(&bounds.extentX[i]);
+		__m256 ey = _mm256_loadu_ps(&bounds.extentY[i]);
+		__m256 ez = _mm256_loadu_ps(&bounds.extentZ[i]);
+		__m256 r = _mm256_loadu_ps(&bounds.radius[i]);
+		__m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+		for (const glm::vec4& plane : frustum.planes) {
+			__m256 nx = _mm256_set1_ps(plane.x), ny = _mm256_set1_ps(plane.y), nz = _mm256_set1_ps(plane.z);
+			__m256 distance =
+				_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_mul_ps(ny, cy)),
+											_mm256_mul_ps(nz, cz)),
+							  _mm256_set1_ps(plane.w));
+			__m256 reach = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_andnot_ps(signMask, nx), ex),
+													   _mm256_mul_ps(_mm256_andnot_ps(signMask, ny), ey)),
+										 _mm256_mul_ps(_mm256_andnot_ps(signMask, nz), ez));
+			inside = _mm256_and_ps(inside,
+								   _mm256_cmp_ps(_mm256_add_ps(distance, _mm256_min_ps(reach, r)), zero, _CMP_GE_OQ));
+		}
+		int mask = _mm256_movemask_ps(inside);
+		for (int lane = 0; lane < 8; lane++) {
+			visible[count] = (uint32_t)(i + lane);
+			count += (mask >> lane) & 1;
+		}
+	}
+	return tested;
+}
+#endif
+
+size_t cull_bounds(const Frustum& frustum, const CullBounds& bounds, uint32_t* visible, CullSimd simd) {
+	static const CullSimd supported = cull_simd_supported();
+	if (simd == CULL_SIMD_AUTO || simd > supported) {
+		simd = supported;
+	}
+
+	if (!frustum.enabled) {
+		for (size_t i = 0; i < bounds.size(); i++) {
+			visible[i] = (uint32_t)i;
+		}
+		return bounds.size();
+	}
+
+	size_t count = 0;
+	size_t tested = 0;
+#ifdef CPU_X86
+	if (simd == CULL_SIMD_AVX2) {
+		tested = cull_avx2(frustum, bounds, visible, count);
+	} else if (simd == CULL_SIMD_SSE2) {
+		tested = cull_sse2(frustum, bounds, visible, count);
+	}
+#endif
+	return cull_scalar(frustum, bounds, tested, visible, count);
+}
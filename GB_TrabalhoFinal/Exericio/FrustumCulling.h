@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Descarte das instâncias fora do volume de visualização (frustum) da câmera, testadas em lote: as caixas e esferas
+// envolventes ficam em um array por componente (SoA) e cada instrução vetorizada testa 4 (SSE2) ou 8 (AVX2) instâncias
+// contra um plano. O caminho escalar (também usado nas instâncias que sobram no fim) faz as mesmas contas, na mesma
+// ordem.
+
+// Planos do frustum (esquerdo, direito, inferior, superior, próximo e distante) com a normal para dentro e
+// normalizada: um ponto p está dentro quando dot(xyz, p) + w >= 0 para todos. Sem enabled nada é descartado.
+struct Frustum {
+	glm::vec4 planes[6];
+	bool enabled = false;
+};
+
+// Planos extraídos de projection * view (Gribb e Hartmann), em coordenadas do mundo.
+Frustum frustum_from_matrix(const glm::mat4& viewProjection);
+
+// Volumes envolventes de um lote de instâncias em coordenadas do mundo: caixa alinhada aos eixos (centro e
+// meia-diagonal) e esfera de mesmo centro. O teste usa o menor dos dois em cada plano.
+struct CullBounds {
+	std::vector<float> centerX, centerY, centerZ;
+	std::vector<float> extentX, extentY, extentZ;
+	std::vector<float> radius;
+
+	size_t size() const { return radius.size(); }
+	void resize(size_t count);
+	// Volumes da instância i a partir da caixa (center, extent) e do raio da malha nas coordenadas do modelo.
+	void set(size_t i, const glm::mat4& model, glm::vec3 center, glm::vec3 extent, float localRadius);
+	// Instância sempre visível (ex.: com um zoom que a traz para dentro da tela de fora do frustum da câmera).
+	void setAlwaysVisible(size_t i);
+};
+
+enum CullSimd {
+	CULL_SIMD_AUTO,	 // o melhor disponível no processador
+	CULL_SIMD_SCALAR,
+	CULL_SIMD_SSE2,
+	CULL_SIMD_AVX2,
+};
+
+// Melhor conjunto de instruções disponível (nunca CULL_SIMD_AUTO) e o seu nome.
+CullSimd cull_simd_supported();
+const char* cull_simd_name(CullSimd simd);
+
+// Escreve em visible (com espaço para bounds.size() entradas), em ordem crescente, os índices das instâncias que
+// tocam o frustum e retorna quantas são. Um simd não suportado pelo processador é rebaixado para o melhor suportado.
+size_t cull_bounds(const Frustum& frustum, const CullBounds& bounds, uint32_t* visible,
+				   CullSimd simd = CULL_SIMD_AUTO);
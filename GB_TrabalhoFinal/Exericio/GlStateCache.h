@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+
+// GLAD
+#include <glad/glad.h>
+
+// Cópia do estado da OpenGL usado pelos desenhos (programa, VAO, GL_ARRAY_BUFFER, unidade de textura ativa, textura de
+// cada unidade e origem dos atributos de instância do VAO vinculado): vincular o que já está vinculado não chega ao
+// driver. Os valores começam desconhecidos; como o envio de texturas e a criação de VAOs vinculam por fora da cache,
+// reset deve ser chamado antes de cada quadro de desenho.
+class GlStateCache {
+   public:
+	static const int TEXTURE_UNITS = 2;
+
+	// Esquece o estado (tudo desconhecido) e zera os contadores.
+	void reset() {
+		program = vertexArray = arrayBuffer = activeUnit = UNKNOWN;
+		for (int unit = 0; unit < TEXTURE_UNITS; unit++) {
+			textureTargets[unit] = 0;
+			textures[unit] = UNKNOWN;
+		}
+		instanceBuffer = UNKNOWN;
+		binds = skipped = 0;
+	}
+
+	void useProgram(GLuint id) {
+		if (change(program, id)) {
+			glUseProgram(id);
+		}
+	}
+
+	// Outro VAO tem outros atributos de instância: a origem deles volta a ser desconhecida.
+	void bindVertexArray(GLuint id) {
+		if (change(vertexArray, id)) {
+			glBindVertexArray(id);
+			instanceBuffer = UNKNOWN;
+		}
+	}
+
+	void bindArrayBuffer(GLuint id) {
+		if (change(arrayBuffer, id)) {
+			glBindBuffer(GL_ARRAY_BUFFER, id);
+		}
+	}
+
+	void activeTexture(GLuint unit) {
+		if (change(activeUnit, unit)) {
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+	}
+
+	// Cada unidade é usada com um único alvo (MeshBatch.h: TEXTURE_UNIT_2D e TEXTURE_UNIT_ARRAY); trocar o alvo de uma
+	// unidade conta como troca de textura.
+	void bindTexture(GLuint unit, GLenum target, GLuint id) {
+		if (textureTargets[unit] != target || textures[unit] != id) {
+			activeTexture(unit);
+			glBindTexture(target, id);
+			textureTargets[unit] = target;
+			textures[unit] = id;
+			binds++;
+		} else {
+			skipped++;
+		}
+	}
+
+	// Os atributos de instância do VAO vinculado passam a ler buffer a partir do byte offset. Retorna true se os
+	// ponteiros devem ser refeitos (com o buffer vinculado em GL_ARRAY_BUFFER) e false se já leem dali.
+	bool changeInstanceSource(GLuint buffer, size_t offset) {
+		if (instanceBuffer == buffer && instanceOffset == offset) {
+			skipped++;
+			return false;
+		}
+		instanceBuffer = buffer;
+		instanceOffset = offset;
+		binds++;
+		return true;
+	}
+
+	// Vínculos enviados ao driver e evitados desde o último reset.
+	size_t getBinds() const { return binds; }
+	size_t getSkipped() const { return skipped; }
+
+   protected:
+	static const GLuint UNKNOWN = 0xFFFFFFFFu;	// nenhum nome da OpenGL chega a esse valor
+
+	bool change(GLuint& current, GLuint value) {
+		if (current == value) {
+			skipped++;
+			return false;
+		}
+		current = value;
+		binds++;
+		return true;
+	}
+
+	GLuint program = UNKNOWN;
+	GLuint vertexArray = UNKNOWN;
+	GLuint arrayBuffer = UNKNOWN;
+	GLuint activeUnit = UNKNOWN;
+	GLenum textureTargets[TEXTURE_UNITS] = {0, 0};
+	GLuint textures[TEXTURE_UNITS] = {UNKNOWN, UNKNOWN};
+	GLuint instanceBuffer = UNKNOWN;
+	size_t instanceOffset = 0;
+	size_t binds = 0;
+	size_t skipped = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+// GLAD
+#include <glad/glad.h>
+
+// Mede o tempo de GPU de um trecho de comandos com consultas GL_TIME_ELAPSED.
+// Usa duas consultas alternadas para ler o resultado do quadro anterior sem bloquear o atual.
+class GpuTimer {
+   public:
+	void initialize() {
+		glGenQueries(2, queries);
+		current = 0;
+		pending[0] = pending[1] = false;
+		totalMs = 0.0;
+		samples = 0;
+	}
+
+	void destroy() { glDeleteQueries(2, queries); }
+
+	void begin() {
+		collect(current);
+		glBeginQuery(GL_TIME_ELAPSED, queries[current]);
+	}
+
+	void end() {
+		glEndQuery(GL_TIME_ELAPSED);
+		pending[current] = true;
+		current = 1 - current;
+	}
+
+	int getSamples() const { return samples; }
+
+	// Média (em ms) das amostras acumuladas desde a última chamada.
+	double takeAverageMs() {
+		double average = samples > 0 ? totalMs / samples : 0.0;
+		totalMs = 0.0;
+		samples = 0;
+		return average;
+	}
+
+   protected:
+	void collect(int index) {
+		if (!pending[index]) {
+			return;
+		}
+		GLuint64 elapsed = 0;
+		glGetQueryObjectui64v(queries[index], GL_QUERY_RESULT, &elapsed);
+		pending[index] = false;
+		totalMs += (double)elapsed / 1.0e6;
+		samples++;
+	}
+
+	GLuint queries[2];
+	int current = 0;
+	bool pending[2] = {false, false};
+	double totalMs = 0.0;
+	int samples = 0;
+};
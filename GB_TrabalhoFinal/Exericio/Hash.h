@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Hash de 64 bits não criptográfico (rodadas no estilo do xxHash64), usado para detectar mudanças no conteúdo de
+// arquivos de origem.
+inline uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0) {
+	const uint64_t PRIME1 = 0x9E3779B185EBCA87ull;
+	const uint64_t PRIME2 = 0xC2B2AE3D27D4EB4Full;
+	const uint64_t PRIME3 = 0x165667B19E3779F9ull;
+	auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+
+	const uint8_t* p = (const uint8_t*)data;
+	const uint8_t* end = p + size;
+	uint64_t h = seed + PRIME3 + (uint64_t)size * PRIME1;
+
+	while (p + 8 <= end) {
+		uint64_t k;
+		memcpy(&k, p, 8);
+		k *= PRIME2;
+		k = rotl(k, 31);
+		k *= PRIME1;
+		h ^= k;
+		h = rotl(h, 27) * PRIME1 + PRIME3;
+		p += 8;
+	}
+	while (p < end) {
+		h ^= (*p) * PRIME3;
+		h = rotl(h, 11) * PRIME1;
+		p++;
+	}
+
+	h ^= h >> 33;
+	h *= PRIME2;
+	h ^= h >> 29;
+	h *= PRIME3;
+	h ^= h >> 32;
+	return h;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Escolha do nível de detalhe de cada instância pelo tamanho projetado na tela: o nível desenhado é o mais simples
+// cujo erro de simplificação (MeshData.h: MeshLod), visto da distância da instância, cobre no máximo pixelError pixels.
+struct LodSelection {
+	glm::vec3 cameraPosition = glm::vec3(0.0f);
+	float pixelsPerUnit = 0.0f;	 // pixels ocupados por uma unidade a uma distância 1 da câmera
+	float pixelError = 0.0f;	 // 0 = sempre a malha completa
+};
+
+// Menor distância considerada (o plano próximo da projeção da Camera), para objetos em volta da câmera.
+const float LOD_MIN_DISTANCE = 0.1f;
+
+// Parâmetros do quadro a partir da matriz de projeção em perspectiva da câmera e da altura da janela em pixels.
+inline LodSelection lod_selection(const glm::mat4& projection, float viewportHeight, glm::vec3 cameraPosition,
+								  float pixelError) {
+	return {cameraPosition, projection[1][1] * viewportHeight * 0.5f, pixelError};
+}
+
+// Nível da instância com matriz modelo model e escala do zoom zoomScale (em clip space). center e radius formam a
+// esfera envolvente da malha e errors[i] é o erro do nível i, crescente com i.
+inline int select_lod(const LodSelection& selection, const glm::mat4& model, float zoomScale, glm::vec3 center,
+					  float radius, const float* errors, int levelCount) {
+	if (selection.pixelError <= 0.0f || levelCount <= 1) {
+		return 0;
+	}
+	float scale = std::max(glm::length(glm::vec3(model[0])),
+						   std::max(glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2]))));
+	glm::vec3 worldCenter = glm::vec3(model * glm::vec4(center, 1.0f));
+	// Distância até a parte mais próxima da esfera envolvente.
+	float distance = std::max(glm::length(worldCenter - selection.cameraPosition) - radius * scale, LOD_MIN_DISTANCE);
+	float pixelsPerError = scale * selection.pixelsPerUnit * zoomScale / distance;
+
+	int level = 0;
+	while (level + 1 < levelCount && errors[level + 1] * pixelsPerError <= selection.pixelError) {
+		level++;
+	}
+	return level;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Arquivo mapeado em memória (somente leitura).
+// O conteúdo fica acessível via data()/size() enquanto o objeto existir, sem cópia para o heap.
+class MappedFile {
+   public:
+	MappedFile() {}
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path) {
+		close();
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+						   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(file, &fileSize);
+		length = (size_t)fileSize.QuadPart;
+		if (length == 0) {
+			return true;
+		}
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr) {
+			close();
+			return false;
+		}
+		address = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+#else
+		fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			close();
+			return false;
+		}
+		length = (size_t)st.st_size;
+		if (length == 0) {
+			return true;
+		}
+		void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+		address = mapped == MAP_FAILED ? nullptr : (const char*)mapped;
+		if (address != nullptr) {
+			madvise(mapped, length, MADV_SEQUENTIAL);
+		}
+#endif
+		if (address == nullptr) {
+			close();
+			return false;
+		}
+		return true;
+	}
+
+	void close() {
+#ifdef _WIN32
+		if (address != nullptr) UnmapViewOfFile(address);
+		if (mapping != nullptr) CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (address != nullptr) munmap((void*)address, length);
+		if (fd >= 0) ::close(fd);
+		fd = -1;
+#endif
+		address = nullptr;
+		length = 0;
+	}
+
+	const char* data() const { return address; }
+	size_t size() const { return length; }
+
+   protected:
+	const char* address = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	int fd = -1;
+#endif
+};
@@ -0,0 +1,69 @@
+#include "Material.h"
+
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+bool MaterialLibrary::load(const std::string& mtlFilePath) {
+	materials.assign(1, Material());
+
+	std::ifstream mtlFile(mtlFilePath);
+	if (!mtlFile.is_open()) {
+		std::cerr << "Failed to open MTL file: " << mtlFilePath << std::endl;
+		return false;
+	}
+
+	// Cada newmtl inicia um material novo; as propriedades seguintes pertencem a ele.
+	std::vector<Material> parsed;
+	std::string line;
+	while (std::getline(mtlFile, line)) {
+		std::istringstream iss(line);
+		std::string word;
+		iss >> word;
+		if (word == "newmtl") {
+			parsed.emplace_back();
+			std::getline(iss >> std::ws, parsed.back().name);
+			while (!parsed.back().name.empty() && isspace((unsigned char)parsed.back().name.back())) {
+				parsed.back().name.pop_back();
+			}
+			continue;
+		}
+		if (parsed.empty()) {
+			continue;
+		}
+
+		Material& material = parsed.back();
+		if (word == "Ka") {
+			iss >> material.Ka.r >> material.Ka.g >> material.Ka.b;
+		} else if (word == "Kd") {
+			iss >> material.Kd.r >> material.Kd.g >> material.Kd.b;
+		} else if (word == "Ks") {
+			iss >> material.Ks.r >> material.Ks.g >> material.Ks.b;
+		} else if (word == "Ke") {
+			iss >> material.Ke.r >> material.Ke.g >> material.Ke.b;
+		} else if (word == "Ns") {
+			iss >> material.Ns;
+		} else if (word == "Ni") {
+			iss >> material.Ni;
+		} else if (word == "d") {
+			iss >> material.d;
+		} else if (word == "illum") {
+			iss >> material.illum;
+		}
+	}
+
+	if (!parsed.empty()) {
+		materials.swap(parsed);
+	}
+	return true;
+}
+
+int MaterialLibrary::find(const std::string& name) const {
+	for (size_t i = 0; i < materials.size(); i++) {
+		if (materials[i].name == name) {
+			return (int)i;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Propriedades de superfície de um material (newmtl) do arquivo MTL.
+struct Material {
+	std::string name;
+	glm::vec3 Ka = glm::vec3(0.2f);	 // Ambient color
+	glm::vec3 Kd = glm::vec3(0.8f);	 // Diffuse color
+	glm::vec3 Ks = glm::vec3(0.5f);	 // Specular color
+	glm::vec3 Ke = glm::vec3(0.0f);	 // Emissive color
+	float Ns = 0.0f;				 // Specular exponent
+	float Ni = 1.0f;				 // Optical density
+	float d = 1.0f;					 // Dissolve
+	int illum = 2;					 // Illumination model
+};
+
+// Todos os materiais de um arquivo MTL. A biblioteca nunca fica vazia: sem arquivo (ou sem newmtl) ela contém um
+// material padrão.
+class MaterialLibrary {
+   public:
+	MaterialLibrary() : materials(1) {}
+
+	// Lê os materiais do arquivo, substituindo os atuais.
+	bool load(const std::string& mtlFilePath);
+
+	// Índice do material com o nome informado. Nomes desconhecidos (ou faces sem usemtl) usam o primeiro material.
+	int find(const std::string& name) const;
+
+	const std::vector<Material>& getMaterials() const { return materials; }
+
+   protected:
+	std::vector<Material> materials;
+};
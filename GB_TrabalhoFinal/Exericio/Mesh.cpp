@@ -1,11 +1,9 @@
 #include "Mesh.h"
 
-void Mesh::initialize(int id, GLuint VAO, int nVertices, Shader* shader, glm::vec3 position, glm::vec3 scale, float angle, glm::vec3 axis)
+void Mesh::initialize(int id, MeshBatch* batch, glm::vec3 position, glm::vec3 scale, float angle, glm::vec3 axis)
 {
 	this->id = id;
-	this->VAO = VAO;
-	this->nVertices = nVertices;
-	this->shader = shader;
+	this->batch = batch;
 	this->position = position;
 	this->scale = scale;
 	this->angle = angle;
@@ -16,17 +14,43 @@ int Mesh::getId() {
 	return id;
 }
 
+MeshBatch* Mesh::getBatch() {
+	return batch;
+}
+
+void Mesh::setTextureLayer(int layer) {
+	textureLayer = layer;
+}
+
+int Mesh::getTextureLayer() {
+	return textureLayer;
+}
+
 void Mesh::update(glm::mat4 model = glm::mat4(1))
 {
 	model = glm::translate(model, position);
 	model = glm::rotate(model, glm::radians(angle), axis);
 	model = glm::scale(model, scale);
-	shader->setMat4("model", glm::value_ptr(model));
+	this->model = model;
+}
+
+void Mesh::setModel(glm::mat4 model)
+{
+	this->model = model;
+}
+
+glm::mat4 Mesh::getModel()
+{
+	return model;
+}
+
+Aabb Mesh::getBounds()
+{
+	const MeshGeometry& geometry = batch->getGeometry();
+	return transform_aabb(model, geometry.center, geometry.extent);
 }
 
-void Mesh::draw()
+void Mesh::draw(bool highlight, float zoomScale)
 {
-	glBindVertexArray(VAO);
-	glDrawArrays(GL_TRIANGLES, 0, nVertices);
-	glBindVertexArray(0);
+	batch->add(model, highlight, zoomScale, textureLayer);
 }
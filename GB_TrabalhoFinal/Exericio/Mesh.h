@@ -5,31 +5,49 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// Shader
-#include "Shader.h"
+#include <vector>
+
+// Lote de instâncias (geometria compartilhada)
+#include "MeshBatch.h"
+
+// Caixa envolvente (Aabb)
+#include "DynamicBvh.h"
 
 class Mesh
 {
 public:
 	Mesh() {}
 	~Mesh() {}
-	void initialize(int id, GLuint VAO, int nVertices, Shader* shader, glm::vec3 position = glm::vec3(0.0, 0.0, 0.0), glm::vec3 scale = glm::vec3(1.0, 1.0, 1.0), float angle = 0.0, glm::vec3 axis = glm::vec3(0.0, 0.0, 1.0));
+	// batch: lote da geometria e textura do objeto, compartilhado com os outros objetos do mesmo OBJ e textura.
+	void initialize(int id, MeshBatch* batch, glm::vec3 position = glm::vec3(0.0, 0.0, 0.0),
+					glm::vec3 scale = glm::vec3(1.0, 1.0, 1.0), float angle = 0.0,
+					glm::vec3 axis = glm::vec3(0.0, 0.0, 1.0));
 	int getId();
+	MeshBatch* getBatch();
+	// Camada da textura do objeto no array do lote.
+	void setTextureLayer(int layer);
+	int getTextureLayer();
+	// Calcula a matriz modelo do objeto a partir de model e das transformações do objeto.
 	void update(glm::mat4 model);
-	void draw();
+	// Usa a matriz informada diretamente como matriz modelo.
+	void setModel(glm::mat4 model);
+	glm::mat4 getModel();
+	// Caixa envolvente do objeto no mundo: a caixa da geometria do lote transformada pela matriz modelo.
+	Aabb getBounds();
+	// Enfileira a instância do objeto no lote; o desenho acontece em MeshBatch::enqueue e draw_render_queue.
+	// highlight: destaca o objeto selecionado com uma cor emissiva; zoomScale: escala do zoom em clip space.
+	void draw(bool highlight = false, float zoomScale = 1.0f);
 
 protected:
 	int id;
-	GLuint VAO; //Identificador do Vertex Array Object - V�rtices e seus atributos
-	int nVertices;
+	MeshBatch* batch;
+	int textureLayer = 0;
+	glm::mat4 model = glm::mat4(1);
 
 	//Informações sobre as transformações a serem aplicadas no objeto
 	glm::vec3 position;
 	glm::vec3 scale;
 	float angle;
 	glm::vec3 axis;
-
-	//Referência (endereço) do shader
-	Shader* shader;
 };
 
@@ -0,0 +1,222 @@
+#include "MeshBatch.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "MeshData.h"
+
+void MeshBatch::initialize(const MeshGeometry& geometry, GLuint texture, GLenum textureTarget, const Shader& shader) {
+	this->texture = texture;
+	this->textureTarget = textureTarget;
+	setGeometry(geometry);
+	resolveUniforms(shader);
+	glGenBuffers(1, &instanceBuffer);
+}
+
+void MeshBatch::setGeometry(const MeshGeometry& geometry) {
+	this->geometry = geometry;
+	// Sem níveis, a malha completa é desenhada inteira (sem faixas).
+	if (this->geometry.levels.empty()) {
+		this->geometry.levels.push_back(MeshLevel());
+	}
+	levelErrors.clear();
+	for (const MeshLevel& level : this->geometry.levels) {
+		levelErrors.push_back(level.error);
+	}
+	const MeshLevel& full = this->geometry.levels[0];
+	fullTriangles = (size_t)(geometry.nIndices > 0 ? geometry.nIndices : geometry.nVertices) / 3;
+	if (!full.ranges.empty()) {
+		fullTriangles = 0;
+		for (const MeshRange& range : full.ranges) {
+			fullTriangles += (size_t)range.count / 3;
+		}
+	}
+}
+
+void MeshBatch::resolveUniforms(const Shader& shader) {
+	program = shader.ID;
+	rangeMaterialUniform = shader.getUniform<UniformInt>("rangeMaterial");
+	positionOffsetUniform = shader.getUniform<UniformVec3>("positionOffset");
+	positionScaleUniform = shader.getUniform<UniformVec3>("positionScale");
+	octahedralNormalUniform = shader.getUniform<UniformInt>("octahedralNormal");
+}
+
+void MeshBatch::destroy() {
+	glDeleteBuffers(1, &instanceBuffer);
+	instanceBuffer = 0;
+	instanceCapacity = 0;
+	instances.clear();
+}
+
+void MeshBatch::add(const glm::mat4& model, bool highlight, float zoomScale, int layer) {
+	float textureLayer = textureTarget == GL_TEXTURE_2D_ARRAY ? (float)layer : -1.0f;
+	instances.push_back(
+		{model, glm::vec4((float)geometry.materialBase, highlight ? 1.0f : 0.0f, zoomScale, textureLayer)});
+}
+
+// Aponta os atributos de instância do VAO vinculado para o buffer do lote, a partir da instância first.
+void MeshBatch::bindInstanceAttributes(size_t first) {
+	GLsizei stride = sizeof(MeshInstance);
+	size_t base = first * sizeof(MeshInstance);
+	for (GLuint column = 0; column < 4; column++) {
+		GLuint location = ATTRIBUTE_INSTANCE_MODEL + column;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+							  (GLvoid*)(base + offsetof(MeshInstance, model) + column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+	glVertexAttribPointer(ATTRIBUTE_INSTANCE_PARAMS, 4, GL_FLOAT, GL_FALSE, stride,
+						  (GLvoid*)(base + offsetof(MeshInstance, params)));
+	glEnableVertexAttribArray(ATTRIBUTE_INSTANCE_PARAMS);
+	glVertexAttribDivisor(ATTRIBUTE_INSTANCE_PARAMS, 1);
+}
+
+void MeshBatch::enqueue(RenderQueue& queue, GlStateCache& state, bool instanced, const LodSelection& lod,
+						const Frustum& frustum) {
+	drawnTriangles = 0;
+	culledInstances = 0;
+	if (instances.empty()) {
+		return;
+	}
+
+	// Volumes das instâncias no mundo, testados em lote contra os planos do frustum. Um zoom que afasta (escala menor
+	// que 1 em clip space) pode trazer para a tela um objeto de fora do frustum da câmera: essas instâncias nunca são
+	// descartadas.
+	size_t instanceCount = instances.size();
+	visible.resize(instanceCount);
+	size_t visibleCount = instanceCount;
+	if (frustum.enabled) {
+		bounds.resize(instanceCount);
+		for (size_t i = 0; i < instanceCount; i++) {
+			if (instances[i].params.z < 1.0f) {
+				bounds.setAlwaysVisible(i);
+			} else {
+				bounds.set(i, instances[i].model, geometry.center, geometry.extent, geometry.radius);
+			}
+		}
+		visibleCount = cull_bounds(frustum, bounds, visible.data());
+		culledInstances = instanceCount - visibleCount;
+	} else {
+		for (size_t i = 0; i < instanceCount; i++) {
+			visible[i] = (uint32_t)i;
+		}
+	}
+	if (visibleCount == 0) {
+		instances.clear();
+		return;
+	}
+
+	// Nível e distância até a câmera de cada instância visível e instâncias agrupadas por nível (ordenação por
+	// contagem, estável).
+	int levelCount = (int)geometry.levels.size();
+	std::vector<size_t> levelFirst(levelCount + 1, 0);
+	instanceLevels.resize(visibleCount);
+	for (size_t v = 0; v < visibleCount; v++) {
+		const MeshInstance& instance = instances[visible[v]];
+		instanceLevels[v] = select_lod(lod, instance.model, instance.params.z, geometry.center, geometry.radius,
+									   levelErrors.data(), levelCount);
+		levelFirst[instanceLevels[v] + 1]++;
+	}
+	for (int level = 0; level < levelCount; level++) {
+		levelFirst[level + 1] += levelFirst[level];
+	}
+	sorted.resize(visibleCount);
+	instanceDepths.resize(visibleCount);
+	std::vector<size_t> fill(levelFirst.begin(), levelFirst.end() - 1);
+	for (size_t v = 0; v < visibleCount; v++) {
+		size_t position = fill[instanceLevels[v]]++;
+		sorted[position] = instances[visible[v]];
+		glm::vec3 center = glm::vec3(sorted[position].model * glm::vec4(geometry.center, 1.0f));
+		instanceDepths[position] = glm::length(center - lod.cameraPosition);
+	}
+
+	// Envia as instâncias do quadro. O buffer é realocado (orphaning) para não esperar pelos desenhos do quadro
+	// anterior e só cresce quando a fila passa da capacidade.
+	state.bindArrayBuffer(instanceBuffer);
+	instanceCapacity = std::max(instanceCapacity, sorted.size());
+	glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(MeshInstance), nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sorted.size() * sizeof(MeshInstance), sorted.data());
+
+	// Um item por faixa de material de cada grupo: as instâncias de um nível ou, sem instanciamento, cada instância.
+	for (int level = 0; level < levelCount; level++) {
+		size_t first = levelFirst[level], count = levelFirst[level + 1] - first;
+		const std::vector<MeshRange>& ranges = geometry.levels[level].ranges;
+		size_t groupSize = instanced ? count : 1;
+		for (size_t group = first; group < first + count; group += groupSize) {
+			float depth = *std::min_element(&instanceDepths[group], &instanceDepths[group] + groupSize);
+			RenderItem item = {this, (uint32_t)group, (uint32_t)groupSize, level, -1};
+			if (ranges.empty()) {
+				queue.add(render_sort_key(program, texture, geometry.VAO, depth, 0), item);
+			}
+			for (size_t range = 0; range < ranges.size(); range++) {
+				item.range = (int)range;
+				queue.add(render_sort_key(program, texture, geometry.VAO, depth, ranges[range].material), item);
+			}
+		}
+	}
+
+	instances.clear();
+}
+
+void MeshBatch::drawItem(const RenderItem& item, GlStateCache& state) {
+	state.useProgram(program);
+	state.bindVertexArray(geometry.VAO);
+	GLuint unit = textureTarget == GL_TEXTURE_2D_ARRAY ? TEXTURE_UNIT_ARRAY : TEXTURE_UNIT_2D;
+	state.bindTexture(unit, textureTarget, texture);
+
+	// Outro grupo de instâncias (ou outro lote no mesmo VAO): atributos de instância e decodificação dos vértices.
+	if (state.changeInstanceSource(instanceBuffer, item.first * sizeof(MeshInstance))) {
+		state.bindArrayBuffer(instanceBuffer);
+		bindInstanceAttributes(item.first);
+		const VertexDecode& decode = geometry.decode;
+		positionOffsetUniform.set(&decode.positionOffset.x);
+		positionScaleUniform.set(&decode.positionScale.x);
+		octahedralNormalUniform.set(decode.octahedralNormal ? 1 : 0);
+	}
+
+	GLsizei instanceCount = (GLsizei)item.count;
+	if (item.range < 0) {
+		rangeMaterialUniform.set(0);
+		if (geometry.nIndices > 0) {
+			glDrawElementsInstanced(GL_TRIANGLES, geometry.nIndices, geometry.indexType, 0, instanceCount);
+			drawnTriangles += (size_t)geometry.nIndices / 3 * instanceCount;
+		} else {
+			glDrawArraysInstanced(GL_TRIANGLES, 0, geometry.nVertices, instanceCount);
+			drawnTriangles += (size_t)geometry.nVertices / 3 * instanceCount;
+		}
+		return;
+	}
+
+	const MeshRange& range = geometry.levels[item.level].ranges[item.range];
+	size_t indexSize = geometry.indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+	rangeMaterialUniform.set(range.material);
+	if (geometry.nIndices > 0) {
+		glDrawElementsInstanced(GL_TRIANGLES, range.count, geometry.indexType, (GLvoid*)(range.first * indexSize),
+								instanceCount);
+	} else {
+		glDrawArraysInstanced(GL_TRIANGLES, range.first, range.count, instanceCount);
+	}
+	drawnTriangles += (size_t)range.count / 3 * instanceCount;
+}
+
+void MeshBatch::unbind(GlStateCache& state) {
+	GLuint unit = textureTarget == GL_TEXTURE_2D_ARRAY ? TEXTURE_UNIT_ARRAY : TEXTURE_UNIT_2D;
+	state.bindTexture(unit, textureTarget, 0);
+	state.activeTexture(0);
+	state.bindArrayBuffer(0);
+	state.bindVertexArray(0);
+}
+
+int draw_render_queue(const RenderQueue& queue, GlStateCache& state, bool unbind) {
+	for (size_t i = 0; i < queue.size(); i++) {
+		queue[i].batch->drawItem(queue[i], state);
+		if (unbind && (i + 1 == queue.size() || queue[i + 1].batch != queue[i].batch)) {
+			queue[i].batch->unbind(state);
+		}
+	}
+	if (!unbind) {
+		state.bindVertexArray(0);
+		state.activeTexture(0);
+	}
+	return (int)queue.size();
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Shader
+#include "Shader.h"
+
+#include "FrustumCulling.h"
+#include "GlStateCache.h"
+#include "LodSelection.h"
+#include "RenderQueue.h"
+#include "TriangleBvh.h"
+
+// Faixa de elementos (índices com EBO, vértices sem EBO) desenhada com um dos materiais da malha.
+struct MeshRange {
+	int first;
+	int count;
+	int material;  // índice na lista de materiais da malha
+};
+
+// Unidades de textura do shader: tex_buffer (texturas 2D) e tex_array (camadas de GL_TEXTURE_2D_ARRAY).
+const GLuint TEXTURE_UNIT_2D = 0;
+const GLuint TEXTURE_UNIT_ARRAY = 1;
+
+// Decodificação dos vértices compactados (MeshOptimizer.h: pack_mesh) no vertex shader: a posição lida em [0, 1] vira
+// positionOffset + posição * positionScale (a caixa envolvente da malha) e, com octahedralNormal, a normal chega em
+// coordenadas octaédricas. Os valores padrão deixam os vértices em float como estão.
+struct VertexDecode {
+	glm::vec3 positionOffset = glm::vec3(0.0f);
+	glm::vec3 positionScale = glm::vec3(1.0f);
+	bool octahedralNormal = false;
+};
+
+// Nível de detalhe da geometria: faixas de material do nível e erro da simplificação (nas unidades do modelo).
+struct MeshLevel {
+	std::vector<MeshRange> ranges;
+	float error = 0.0f;
+};
+
+// Geometria desenhada pelos lotes de um OBJ: VAO com nIndices índices do tipo indexType (0 = sem EBO), níveis de
+// detalhe (levels[0] = malha completa, os demais usam o mesmo VAO), posição dos materiais no MaterialBlock,
+// decodificação dos vértices e volumes envolventes nas coordenadas do modelo: caixa (centro e meia-diagonal, para o
+// descarte fora do frustum) e esfera de mesmo centro (para o descarte e a escolha do nível).
+struct MeshGeometry {
+	GLuint VAO = 0;
+	int nVertices = 0;
+	int nIndices = 0;
+	GLenum indexType = GL_UNSIGNED_INT;
+	std::vector<MeshLevel> levels;
+	int materialBase = 0;
+	VertexDecode decode;
+	glm::vec3 center = glm::vec3(0.0f);
+	glm::vec3 extent = glm::vec3(0.0f);
+	float radius = 0.0f;
+	std::shared_ptr<const TriangleBvh> triangles;  // triângulos da malha completa, para a seleção com o mouse
+};
+
+// Dados por instância lidos pelo vertex shader (atributos com divisor 1).
+struct MeshInstance {
+	glm::mat4 model;
+	// x = primeiro material do objeto no MaterialBlock, y = selecionado, z = escala do zoom, w = camada da textura no
+	// array (-1 = textura 2D)
+	glm::vec4 params;
+};
+
+// Lote de instâncias de uma mesma geometria (VAO) com a mesma textura ou o mesmo array de texturas. Os objetos
+// enfileiram as suas instâncias a cada quadro e o lote as envia de uma vez, com um item na RenderQueue (uma chamada
+// glDraw*Instanced) por faixa de material de cada nível de detalhe usado. Com um array, cada instância escolhe a sua
+// camada, e objetos com texturas diferentes saem juntos.
+// Vários lotes podem compartilhar o VAO (mesmo OBJ com texturas diferentes): cada um aponta os atributos de instância
+// para o próprio buffer antes de desenhar.
+class MeshBatch {
+   public:
+	// textureTarget: GL_TEXTURE_2D ou GL_TEXTURE_2D_ARRAY.
+	void initialize(const MeshGeometry& geometry, GLuint texture, GLenum textureTarget, const Shader& shader);
+	void destroy();
+
+	// Troca a geometria do lote (recarga de uma malha alterada); as instâncias e a textura continuam as mesmas.
+	void setGeometry(const MeshGeometry& geometry);
+	// Resolve de novo o programa e os uniforms usados pelo lote (após recompilar o shader).
+	void resolveUniforms(const Shader& shader);
+
+	const MeshGeometry& getGeometry() const { return geometry; }
+	int getMaterialBase() const { return geometry.materialBase; }
+	int getInstanceCount() const { return (int)instances.size(); }
+	// Triângulos desenhados pelos itens da última chamada de enqueue.
+	size_t getDrawnTriangles() const { return drawnTriangles; }
+	// Instâncias descartadas fora do frustum na última chamada de enqueue e os triângulos que elas teriam na malha
+	// completa.
+	size_t getCulledInstances() const { return culledInstances; }
+	size_t getCulledTriangles() const { return culledInstances * fullTriangles; }
+	// Triângulos de uma instância na malha completa.
+	size_t getFullTriangles() const { return fullTriangles; }
+
+	// layer: camada da instância no array do lote (ignorada nos lotes com textura 2D).
+	void add(const glm::mat4& model, bool highlight, float zoomScale, int layer = 0);
+
+	// Envia as instâncias enfileiradas para o buffer do lote, esvazia a fila e adiciona os desenhos a queue. As
+	// instâncias cujos volumes envolventes ficam fora de frustum são descartadas (nenhuma sem frustum.enabled) e as
+	// demais usam o nível de detalhe escolhido por lod (o nível 0 quando a escolha está desligada); as instâncias de um
+	// mesmo nível saem juntas, com a profundidade da mais próxima da câmera. Com instanced = false cada instância tem
+	// os seus próprios itens (como antes do instanciamento), para comparação.
+	void enqueue(RenderQueue& queue, GlStateCache& state, bool instanced = true,
+				 const LodSelection& lod = LodSelection(), const Frustum& frustum = Frustum());
+
+	// Desenha um item adicionado por enqueue, vinculando pela cache o estado do lote.
+	void drawItem(const RenderItem& item, GlStateCache& state);
+	// Desvincula o estado do lote (textura, buffer e VAO), como os desenhos faziam antes da fila.
+	void unbind(GlStateCache& state);
+
+   protected:
+	void bindInstanceAttributes(size_t first);
+
+	MeshGeometry geometry;
+	std::vector<float> levelErrors;
+	GLuint texture = 0;
+	GLenum textureTarget = GL_TEXTURE_2D;
+	GLuint program = 0;
+
+	GLuint instanceBuffer = 0;
+	size_t instanceCapacity = 0;
+	std::vector<MeshInstance> instances;
+	std::vector<MeshInstance> sorted;  // instâncias visíveis agrupadas por nível, na ordem do envio
+	std::vector<int> instanceLevels;
+	std::vector<float> instanceDepths;
+	CullBounds bounds;				// volumes das instâncias no mundo
+	std::vector<uint32_t> visible;  // índices das instâncias visíveis
+	size_t fullTriangles = 0;		// triângulos de uma instância na malha completa
+	size_t drawnTriangles = 0;
+	size_t culledInstances = 0;
+
+	UniformInt rangeMaterialUniform;
+	UniformVec3 positionOffsetUniform;
+	UniformVec3 positionScaleUniform;
+	UniformInt octahedralNormalUniform;
+};
+
+// Desenha os itens da fila na ordem atual, com o estado de cada um vinculado pela cache, e deixa o VAO 0 e a unidade de
+// textura 0 ativos. Com unbind, o estado de cada lote é desvinculado quando os itens dele acabam, como nos desenhos
+// antes da fila (para comparação, com a fila fora de ordem). Retorna o número de chamadas de desenho.
+int draw_render_queue(const RenderQueue& queue, GlStateCache& state, bool unbind = false);
@@ -0,0 +1,208 @@
+#include "MeshCache.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+
+static_assert(sizeof(MeshCacheHeader) == 168, "MeshCacheHeader faz parte do formato em disco");
+
+static uint64_t align16(uint64_t value) { return (value + 15) & ~(uint64_t)15; }
+
+bool MeshCacheFile::open(const std::string& path) {
+	close();
+	if (!file.open(path) || file.size() < sizeof(MeshCacheHeader)) {
+		file.close();
+		return false;
+	}
+
+	const MeshCacheHeader* candidate = (const MeshCacheHeader*)file.data();
+	uint64_t size = file.size();
+	bool valid = candidate->magic == MESH_CACHE_MAGIC && candidate->version == MESH_CACHE_VERSION &&
+				 (candidate->indexSize == 2 || candidate->indexSize == 4) &&
+				 candidate->attributesOffset + candidate->attributeCount * sizeof(VertexAttribute) <= size &&
+				 candidate->submeshesOffset + candidate->submeshCount * sizeof(Submesh) <= size &&
+				 candidate->lodsOffset + candidate->lodCount * sizeof(MeshLod) <= size &&
+				 candidate->namesOffset + candidate->namesBytes <= size &&
+				 candidate->vertexOffset + candidate->vertexBytes <= size &&
+				 candidate->indexOffset + candidate->indexBytes <= size &&
+				 candidate->vertexBytes == (uint64_t)candidate->vertexCount * candidate->vertexStride &&
+				 candidate->indexBytes == (uint64_t)candidate->indexCount * candidate->indexSize;
+	if (!valid) {
+		file.close();
+		return false;
+	}
+
+	// Os níveis precisam apontar para faixas existentes, e as faixas para índices existentes (são desenhadas direto do
+	// buffer de índices).
+	const MeshLod* lods = (const MeshLod*)(file.data() + candidate->lodsOffset);
+	for (uint32_t i = 0; i < candidate->lodCount; i++) {
+		if ((uint64_t)lods[i].firstSubmesh + lods[i].submeshCount > candidate->submeshCount) {
+			file.close();
+			return false;
+		}
+	}
+	const Submesh* submeshes = (const Submesh*)(file.data() + candidate->submeshesOffset);
+	for (uint32_t i = 0; i < candidate->submeshCount; i++) {
+		if ((uint64_t)submeshes[i].indexOffset + submeshes[i].indexCount > candidate->indexCount) {
+			file.close();
+			return false;
+		}
+	}
+
+	header = candidate;
+	return true;
+}
+
+void MeshCacheFile::getMaterialNames(std::string& library, std::vector<std::string>& names) const {
+	names.clear();
+	const char* p = at(header->namesOffset);
+	const char* end = p + header->namesBytes;
+	auto next = [&p, end]() {
+		const char* terminator = (const char*)memchr(p, '\0', end - p);
+		std::string name(p, terminator ? terminator : end);
+		p = terminator ? terminator + 1 : end;
+		return name;
+	};
+	library = next();
+	for (uint32_t i = 0; i < header->materialCount; i++) {
+		names.push_back(next());
+	}
+}
+
+std::string mesh_cache_path(const std::string& objPath) { return objPath + ".gbmesh"; }
+
+bool write_mesh_cache(const std::string& path, const MeshData& mesh, const SourceStamp& source, uint32_t flags) {
+	bool shortIndices = mesh.vertexCount <= 65536;
+
+	MeshCacheHeader header{};
+	header.magic = MESH_CACHE_MAGIC;
+	header.version = MESH_CACHE_VERSION;
+	header.source = source;
+	header.vertexCount = mesh.vertexCount;
+	header.vertexStride = mesh.vertexStride;
+	header.indexCount = (uint32_t)mesh.indices.size();
+	header.indexSize = shortIndices ? 2 : 4;
+	header.attributeCount = (uint32_t)mesh.attributes.size();
+	header.submeshCount = (uint32_t)mesh.submeshes.size();
+	header.flags = flags;
+	header.materialCount = (uint32_t)mesh.materialNames.size();
+	header.lodCount = (uint32_t)mesh.lods.size();
+	memcpy(header.boundsMin, mesh.boundsMin, sizeof(header.boundsMin));
+	memcpy(header.boundsMax, mesh.boundsMax, sizeof(header.boundsMax));
+	header.attributesOffset = align16(sizeof(MeshCacheHeader));
+	header.submeshesOffset = align16(header.attributesOffset + header.attributeCount * sizeof(VertexAttribute));
+	std::string names = mesh.materialLibrary + '\0';
+	for (const std::string& name : mesh.materialNames) {
+		names += name + '\0';
+	}
+	header.lodsOffset = align16(header.submeshesOffset + header.submeshCount * sizeof(Submesh));
+	header.namesOffset = align16(header.lodsOffset + header.lodCount * sizeof(MeshLod));
+	header.namesBytes = names.size();
+	header.vertexOffset = align16(header.namesOffset + header.namesBytes);
+	header.vertexBytes = (uint64_t)mesh.vertexCount * mesh.vertexStride;
+	header.indexOffset = align16(header.vertexOffset + header.vertexBytes);
+	header.indexBytes = (uint64_t)header.indexCount * header.indexSize;
+
+	std::vector<uint16_t> shortIndexData;
+	const void* indexData = mesh.indices.data();
+	if (shortIndices) {
+		shortIndexData.assign(mesh.indices.begin(), mesh.indices.end());
+		indexData = shortIndexData.data();
+	}
+
+	std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			return false;
+		}
+		auto writeAt = [&out](uint64_t offset, const void* data, uint64_t size) {
+			static const char zeros[16] = {0};
+			uint64_t position = (uint64_t)out.tellp();
+			if (offset > position) {
+				out.write(zeros, (std::streamsize)(offset - position));
+			}
+			out.write((const char*)data, (std::streamsize)size);
+		};
+		writeAt(0, &header, sizeof(header));
+		writeAt(header.attributesOffset, mesh.attributes.data(), header.attributeCount * sizeof(VertexAttribute));
+		writeAt(header.submeshesOffset, mesh.submeshes.data(), header.submeshCount * sizeof(Submesh));
+		writeAt(header.lodsOffset, mesh.lods.data(), header.lodCount * sizeof(MeshLod));
+		writeAt(header.namesOffset, names.data(), header.namesBytes);
+		writeAt(header.vertexOffset, mesh.vertices.data(), header.vertexBytes);
+		writeAt(header.indexOffset, indexData, header.indexBytes);
+		if (!out.good()) {
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+// Atualiza somente a identificação da origem no cabeçalho (conteúdo igual, data diferente).
+static void refresh_source_stamp(const std::string& path, const SourceStamp& source) {
+	std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+	if (file.is_open()) {
+		file.seekp(offsetof(MeshCacheHeader, source));
+		file.write((const char*)&source, sizeof(source));
+	}
+}
+
+bool load_mesh_cached(const std::string& objPath, MeshCacheFile& cache, ThreadPool* pool) {
+	std::string cachePath = mesh_cache_path(objPath);
+
+	SourceStamp source;
+	if (!stat_source(objPath, source)) {
+		// Sem o OBJ, vale o cache que existir (ex.: somente os arquivos preparados foram distribuídos).
+		return cache.open(cachePath);
+	}
+
+	if (cache.open(cachePath)) {
+		const SourceStamp& cached = cache.getHeader().source;
+		if (cached.size == source.size && cached.time == source.time) {
+			return true;
+		}
+		if (cached.size == source.size) {
+			source.hash = hash_file(objPath);
+			if (cached.hash == source.hash) {
+				cache.close();
+				refresh_source_stamp(cachePath, source);
+				return cache.open(cachePath);
+			}
+		}
+		cache.close();
+	}
+
+	ObjData data;
+	if (!load_obj(objPath, data, pool)) {
+		return false;
+	}
+	// Níveis de detalhe simplificados, índices em ordem de cache de vértices e de menor overdraw, vértices na ordem de
+	// uso (sem quantizar: isso fica para o assetcook).
+	MeshData mesh;
+	build_mesh_data(data, mesh);
+	generate_mesh_lods(mesh);
+	optimize_mesh_vertex_cache(mesh);
+	optimize_mesh_overdraw(mesh);
+	optimize_vertex_fetch(mesh);
+	if (source.hash == 0) {
+		source.hash = hash_file(objPath);
+	}
+	if (!write_mesh_cache(cachePath, mesh, source)) {
+		std::cerr << "Falha ao gravar o cache " << cachePath << std::endl;
+		return false;
+	}
+	return cache.open(cachePath);
+}
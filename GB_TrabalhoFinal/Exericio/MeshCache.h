@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "MeshData.h"
+#include "SourceStamp.h"
+#include "ThreadPool.h"
+
+// Formato binário de malha (.gbmesh), gravado ao lado do OBJ na primeira leitura.
+// Layout: cabeçalho | atributos | faixas | níveis de detalhe | nomes | vértices | índices, cada bloco alinhado em 16
+// bytes, para que os blocos de vértices e índices possam ser entregues diretamente ao glBufferData a partir do arquivo
+// mapeado.
+const uint32_t MESH_CACHE_MAGIC = 0x434D4247;  // "GBMC"
+const uint32_t MESH_CACHE_VERSION = 6;
+
+// Flags do cabeçalho.
+const uint32_t MESH_CACHE_COOKED = 1;  // gerado pelo assetcook (atributos quantizados)
+
+struct MeshCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	SourceStamp source;
+	uint32_t vertexCount;
+	uint32_t vertexStride;
+	uint32_t indexCount;
+	uint32_t indexSize;	 // 2 ou 4 bytes
+	uint32_t attributeCount;
+	uint32_t submeshCount;
+	uint32_t flags;
+	uint32_t materialCount;
+	uint32_t lodCount;	// 0 = somente a malha completa
+	float boundsMin[3];
+	float boundsMax[3];
+	uint32_t reserved;
+	uint64_t attributesOffset;
+	uint64_t submeshesOffset;
+	uint64_t lodsOffset;
+	uint64_t namesOffset;  // biblioteca MTL seguida dos nomes dos materiais, cada um terminado em '\0'
+	uint64_t namesBytes;
+	uint64_t vertexOffset;
+	uint64_t vertexBytes;
+	uint64_t indexOffset;
+	uint64_t indexBytes;
+};
+
+// Arquivo de cache aberto (mapeado em memória, sem cópias).
+class MeshCacheFile {
+   public:
+	bool open(const std::string& path);
+	void close() {
+		file.close();
+		header = nullptr;
+	}
+
+	bool isOpen() const { return header != nullptr; }
+	const MeshCacheHeader& getHeader() const { return *header; }
+	const VertexAttribute* getAttributes() const { return (const VertexAttribute*)at(header->attributesOffset); }
+	const Submesh* getSubmeshes() const { return (const Submesh*)at(header->submeshesOffset); }
+	const MeshLod* getLods() const { return (const MeshLod*)at(header->lodsOffset); }
+	const void* getVertexData() const { return at(header->vertexOffset); }
+	// Arquivo MTL (relativo ao OBJ) e nomes dos materiais referenciados pelas faixas.
+	void getMaterialNames(std::string& library, std::vector<std::string>& names) const;
+	const void* getIndexData() const { return at(header->indexOffset); }
+
+   protected:
+	const char* at(uint64_t offset) const { return file.data() + offset; }
+
+	MappedFile file;
+	const MeshCacheHeader* header = nullptr;
+};
+
+// Caminho do cache de uma malha.
+std::string mesh_cache_path(const std::string& objPath);
+
+// Grava a malha no formato binário (em um arquivo temporário renomeado no fim).
+bool write_mesh_cache(const std::string& path, const MeshData& mesh, const SourceStamp& source, uint32_t flags = 0);
+
+// Abre o cache do OBJ se ele ainda corresponder ao arquivo de origem; caso contrário lê o OBJ, grava um cache novo e
+// o abre. Retorna false se nem o OBJ nem um cache válido puderem ser lidos.
+bool load_mesh_cached(const std::string& objPath, MeshCacheFile& cache, ThreadPool* pool = nullptr);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Tipos de componente de um atributo de vértice (independente da OpenGL, para ser usado também pelas ferramentas).
+enum VertexAttributeType : uint32_t {
+	ATTRIBUTE_FLOAT32 = 0,
+	ATTRIBUTE_FLOAT16 = 1,
+	ATTRIBUTE_INT_2_10_10_10 = 2,  // x, y, z com 10 bits e w com 2 bits, com sinal (GL_INT_2_10_10_10_REV)
+	ATTRIBUTE_UINT16 = 3,
+	ATTRIBUTE_INT16 = 4,
+};
+
+// Descrição de um atributo dentro do vértice intercalado.
+struct VertexAttribute {
+	uint32_t location;	  // layout (location = N) no vertex shader
+	uint32_t components;  // 1 a 4
+	uint32_t type;		  // VertexAttributeType
+	uint32_t normalized;  // 1 = inteiros normalizados para [0, 1] / [-1, 1]
+	uint32_t offset;	  // bytes a partir do início do vértice
+};
+
+// Material de faces que não passaram por nenhum usemtl.
+const uint32_t MATERIAL_NONE = 0xFFFFFFFFu;
+
+// Faixa de índices desenhada com um mesmo material.
+struct Submesh {
+	uint32_t indexOffset;
+	uint32_t indexCount;
+	uint32_t materialId;  // índice em MeshData::materialNames ou MATERIAL_NONE
+	uint32_t reserved;
+};
+
+// Nível de detalhe: as faixas submeshes[firstSubmesh, firstSubmesh + submeshCount) desenham a malha simplificada
+// com o erro informado (maior distância entre a superfície simplificada e a original, nas unidades do modelo).
+// O nível 0 é a malha completa, com erro 0.
+struct MeshLod {
+	uint32_t firstSubmesh;
+	uint32_t submeshCount;
+	float error;
+	uint32_t reserved;
+};
+
+// Localização dos atributos usados pelos shaders do trabalho.
+const uint32_t ATTRIBUTE_POSITION = 0;
+const uint32_t ATTRIBUTE_COLOR = 1;
+const uint32_t ATTRIBUTE_TEXCOORD = 2;
+const uint32_t ATTRIBUTE_NORMAL = 3;
+// Atributos por instância (divisor 1): a matriz modelo ocupa quatro localizações seguidas (uma por coluna).
+const uint32_t ATTRIBUTE_INSTANCE_MODEL = 4;
+const uint32_t ATTRIBUTE_INSTANCE_PARAMS = 8;
+
+// Malha pronta para ser enviada à GPU: vértices intercalados, índices, faixas de material (com os nomes dos
+// materiais), níveis de detalhe e caixa envolvente. Os níveis compartilham os vértices; sem níveis (lods vazio) todas
+// as faixas formam a malha completa.
+struct MeshData {
+	std::vector<VertexAttribute> attributes;
+	uint32_t vertexStride = 0;
+	uint32_t vertexCount = 0;
+	std::vector<uint8_t> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<Submesh> submeshes;
+	std::vector<MeshLod> lods;
+	std::string materialLibrary;  // arquivo MTL (relativo ao OBJ)
+	std::vector<std::string> materialNames;
+	float boundsMin[3] = {0.0f, 0.0f, 0.0f};
+	float boundsMax[3] = {0.0f, 0.0f, 0.0f};
+};
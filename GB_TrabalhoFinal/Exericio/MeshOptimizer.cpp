@@ -0,0 +1,1195 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// Parâmetros do algoritmo de Forsyth.
+const int VERTEX_CACHE_SIZE = 32;
+const float CACHE_DECAY_POWER = 1.5f;
+const float LAST_TRIANGLE_SCORE = 0.75f;
+const float VALENCE_BOOST_SCALE = 2.0f;
+const float VALENCE_BOOST_POWER = 0.5f;
+
+// Pontuação de um vértice a partir da posição no cache simulado (-1 = fora) e de quantos triângulos ainda o usam.
+static float vertex_score(int cachePosition, int remainingTriangles) {
+	if (remainingTriangles == 0) {
+		return -1.0f;
+	}
+
+	float score = 0.0f;
+	if (cachePosition >= 0) {
+		if (cachePosition < 3) {
+			// Os três vértices do último triângulo recebem pontuação fixa, para não favorecer tiras longas.
+			score = LAST_TRIANGLE_SCORE;
+		} else {
+			const float scaler = 1.0f / (VERTEX_CACHE_SIZE - 3);
+			score = 1.0f - (cachePosition - 3) * scaler;
+			score = powf(score, CACHE_DECAY_POWER);
+		}
+	}
+
+	// Vértices com poucos triângulos restantes são priorizados, para não deixarem triângulos isolados para trás.
+	score += VALENCE_BOOST_SCALE * powf((float)remainingTriangles, -VALENCE_BOOST_POWER);
+	return score;
+}
+
+void optimize_vertex_cache(uint32_t* indices, size_t indexCount, uint32_t vertexCount) {
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount < 2) {
+		return;
+	}
+
+	// Lista de adjacência vértice -> triângulos.
+	std::vector<uint32_t> triangleOffset(vertexCount + 1, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		triangleOffset[indices[i] + 1]++;
+	}
+	for (uint32_t v = 0; v < vertexCount; v++) {
+		triangleOffset[v + 1] += triangleOffset[v];
+	}
+	std::vector<uint32_t> remaining(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++) {
+		remaining[v] = triangleOffset[v + 1] - triangleOffset[v];
+	}
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	{
+		std::vector<uint32_t> fill(triangleOffset.begin(), triangleOffset.end() - 1);
+		for (size_t t = 0; t < triangleCount; t++) {
+			for (int k = 0; k < 3; k++) {
+				adjacency[fill[indices[t * 3 + k]]++] = (uint32_t)t;
+			}
+		}
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> score(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++) {
+		score[v] = vertex_score(-1, remaining[v]);
+	}
+	std::vector<float> triangleScore(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++) {
+		triangleScore[t] = score[indices[t * 3]] + score[indices[t * 3 + 1]] + score[indices[t * 3 + 2]];
+	}
+	std::vector<bool> emitted(triangleCount, false);
+
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+
+	// Cache LRU simulado (com espaço para os 3 vértices do triângulo recém emitido).
+	int cache[VERTEX_CACHE_SIZE + 3];
+	int cacheCount = 0;
+
+	size_t bestTriangle = 0;
+	for (size_t t = 1; t < triangleCount; t++) {
+		if (triangleScore[t] > triangleScore[bestTriangle]) {
+			bestTriangle = t;
+		}
+	}
+	size_t scanPosition = 0;
+
+	for (size_t emittedCount = 0; emittedCount < triangleCount; emittedCount++) {
+		if (bestTriangle == (size_t)-1) {
+			// Nenhum candidato no cache: procura o próximo triângulo ainda não emitido.
+			while (emitted[scanPosition]) {
+				scanPosition++;
+			}
+			bestTriangle = scanPosition;
+		}
+
+		const uint32_t* triangle = &indices[bestTriangle * 3];
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[bestTriangle] = true;
+
+		// Remove o triângulo das listas de adjacência dos seus vértices.
+		for (int k = 0; k < 3; k++) {
+			uint32_t v = triangle[k];
+			uint32_t* begin = &adjacency[triangleOffset[v]];
+			uint32_t* end = begin + remaining[v];
+			uint32_t* found = std::find(begin, end, (uint32_t)bestTriangle);
+			std::swap(*found, *(end - 1));
+			remaining[v]--;
+		}
+
+		// Coloca os vértices do triângulo no início do cache.
+		int newCache[VERTEX_CACHE_SIZE + 3];
+		int newCount = 0;
+		for (int k = 0; k < 3; k++) {
+			newCache[newCount++] = (int)triangle[k];
+		}
+		for (int i = 0; i < cacheCount; i++) {
+			int v = cache[i];
+			if (v != (int)triangle[0] && v != (int)triangle[1] && v != (int)triangle[2]) {
+				newCache[newCount++] = v;
+			}
+		}
+
+		// Atualiza as pontuações dos vértices do cache (e dos que acabaram de sair dele) e dos seus triângulos.
+		for (int i = 0; i < newCount; i++) {
+			int v = newCache[i];
+			cachePosition[v] = i < VERTEX_CACHE_SIZE ? i : -1;
+			float newScore = vertex_score(cachePosition[v], remaining[v]);
+			float delta = newScore - score[v];
+			score[v] = newScore;
+			for (uint32_t j = 0; j < remaining[v]; j++) {
+				triangleScore[adjacency[triangleOffset[v] + j]] += delta;
+			}
+		}
+		cacheCount = std::min(newCount, VERTEX_CACHE_SIZE);
+		memcpy(cache, newCache, cacheCount * sizeof(int));
+
+		// O próximo triângulo é o de maior pontuação entre os que usam vértices do cache.
+		bestTriangle = (size_t)-1;
+		float bestScore = -1.0f;
+		for (int i = 0; i < cacheCount; i++) {
+			int v = cache[i];
+			for (uint32_t j = 0; j < remaining[v]; j++) {
+				uint32_t t = adjacency[triangleOffset[v] + j];
+				if (triangleScore[t] > bestScore) {
+					bestScore = triangleScore[t];
+					bestTriangle = t;
+				}
+			}
+		}
+	}
+
+	memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+void optimize_mesh_vertex_cache(MeshData& mesh) {
+	for (const Submesh& submesh : mesh.submeshes) {
+		optimize_vertex_cache(&mesh.indices[submesh.indexOffset], submesh.indexCount, mesh.vertexCount);
+	}
+}
+
+// Cache FIFO de vértices simulado: um vértice está no cache se foi inserido há no máximo size inserções.
+struct FifoCacheSimulator {
+	std::vector<uint32_t> insertedAt;
+	uint32_t time;
+	uint32_t size;
+
+	FifoCacheSimulator(uint32_t vertexCount, uint32_t size) : insertedAt(vertexCount, 0), time(size + 1), size(size) {}
+
+	void clear() { time += size + 1; }
+
+	// Retorna quantos vértices do triângulo foram transformados (não estavam no cache).
+	int add(const uint32_t* triangle) {
+		int misses = 0;
+		for (int k = 0; k < 3; k++) {
+			if (time - insertedAt[triangle[k]] > size) {
+				insertedAt[triangle[k]] = time++;
+				misses++;
+			}
+		}
+		return misses;
+	}
+};
+
+// Tamanho do cache usado para dividir a sequência em grupos (o das GPUs atuais fica entre 16 e 32 vértices).
+const uint32_t OVERDRAW_CACHE_SIZE = 16;
+
+void optimize_overdraw(uint32_t* indices, size_t indexCount, const uint8_t* positions, size_t positionStride,
+					   float threshold) {
+	size_t triangleCount = indexCount / 3;
+	if (triangleCount < 2) {
+		return;
+	}
+	uint32_t vertexCount = *std::max_element(indices, indices + triangleCount * 3) + 1;
+	FifoCacheSimulator cache(vertexCount, OVERDRAW_CACHE_SIZE);
+
+	// Fronteiras rígidas: triângulos sem nenhum vértice no cache, onde o otimizador de cache começou outra região da
+	// malha. Separar ali não custa nada.
+	std::vector<size_t> regions;
+	for (size_t t = 0; t < triangleCount; t++) {
+		if (cache.add(&indices[t * 3]) == 3 || t == 0) {
+			regions.push_back(t);
+		}
+	}
+	regions.push_back(triangleCount);
+
+	// Fronteiras flexíveis: dentro de cada região, um grupo termina assim que o seu ACMR (começando com o cache vazio)
+	// chega a threshold vezes o da região inteira.
+	std::vector<size_t> clusters;
+	for (size_t r = 0; r + 1 < regions.size(); r++) {
+		size_t begin = regions[r], end = regions[r + 1];
+		cache.clear();
+		uint32_t regionMisses = 0;
+		for (size_t t = begin; t < end; t++) {
+			regionMisses += cache.add(&indices[t * 3]);
+		}
+		float target = threshold * regionMisses / (end - begin);
+
+		cache.clear();
+		clusters.push_back(begin);
+		size_t clusterBegin = begin;
+		uint32_t misses = 0;
+		for (size_t t = begin; t + 1 < end; t++) {
+			misses += cache.add(&indices[t * 3]);
+			if (misses <= target * (t + 1 - clusterBegin)) {
+				clusters.push_back(t + 1);
+				clusterBegin = t + 1;
+				misses = 0;
+				cache.clear();
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	// Centro (ponderado pela área) e normal média de cada grupo e da malha.
+	struct Cluster {
+		size_t begin, end;
+		float center[3];
+		float normal[3];
+		float sortKey;
+	};
+	std::vector<Cluster> groups(clusters.size() - 1);
+	float meshCenter[3] = {0.0f, 0.0f, 0.0f};
+	float meshArea = 0.0f;
+	for (size_t c = 0; c + 1 < clusters.size(); c++) {
+		Cluster& group = groups[c];
+		group = {clusters[c], clusters[c + 1], {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}, 0.0f};
+		float area = 0.0f;
+		for (size_t t = group.begin; t < group.end; t++) {
+			float p[3][3];
+			for (int k = 0; k < 3; k++) {
+				memcpy(p[k], positions + (size_t)indices[t * 3 + k] * positionStride, sizeof(p[k]));
+			}
+			float e1[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+			float e2[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+			float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+			float triangleArea = 0.5f * sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			for (int i = 0; i < 3; i++) {
+				group.center[i] += (p[0][i] + p[1][i] + p[2][i]) / 3.0f * triangleArea;
+				group.normal[i] += n[i];
+			}
+			area += triangleArea;
+		}
+		for (int i = 0; i < 3; i++) {
+			meshCenter[i] += group.center[i];
+			group.center[i] = area > 0.0f ? group.center[i] / area : 0.0f;
+		}
+		meshArea += area;
+	}
+	for (int i = 0; i < 3; i++) {
+		meshCenter[i] = meshArea > 0.0f ? meshCenter[i] / meshArea : 0.0f;
+	}
+
+	// Grupos mais voltados para fora (posição relativa ao centro na direção da normal) vão primeiro.
+	for (Cluster& group : groups) {
+		const float* n = group.normal;
+		float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		float dot = 0.0f;
+		for (int i = 0; i < 3; i++) {
+			dot += (group.center[i] - meshCenter[i]) * n[i];
+		}
+		group.sortKey = length > 0.0f ? dot / length : 0.0f;
+	}
+	std::stable_sort(groups.begin(), groups.end(),
+					 [](const Cluster& a, const Cluster& b) { return a.sortKey > b.sortKey; });
+
+	std::vector<uint32_t> output;
+	output.reserve(triangleCount * 3);
+	for (const Cluster& group : groups) {
+		output.insert(output.end(), indices + group.begin * 3, indices + group.end * 3);
+	}
+	memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+}
+
+// Atributo de posição em float da malha (nullptr se não houver).
+static const VertexAttribute* find_float_position(const MeshData& mesh) {
+	for (const VertexAttribute& attribute : mesh.attributes) {
+		if (attribute.location == ATTRIBUTE_POSITION && attribute.type == ATTRIBUTE_FLOAT32 &&
+			attribute.components >= 3) {
+			return &attribute;
+		}
+	}
+	return nullptr;
+}
+
+void optimize_mesh_overdraw(MeshData& mesh, float threshold) {
+	const VertexAttribute* position = find_float_position(mesh);
+	if (position == nullptr || mesh.vertices.empty()) {
+		return;
+	}
+	for (const Submesh& submesh : mesh.submeshes) {
+		optimize_overdraw(&mesh.indices[submesh.indexOffset], submesh.indexCount, &mesh.vertices[position->offset],
+						  mesh.vertexStride, threshold);
+	}
+}
+
+VertexCacheStatistics analyze_vertex_cache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount,
+										   int cacheSize) {
+	FifoCacheSimulator cache(vertexCount, (uint32_t)cacheSize);
+	std::vector<bool> used(vertexCount, false);
+	uint32_t uniqueVertices = 0;
+	VertexCacheStatistics statistics = {0, 0.0f, 0.0f};
+	for (size_t t = 0; t < indexCount / 3; t++) {
+		statistics.transformedVertices += cache.add(&indices[t * 3]);
+		for (int k = 0; k < 3; k++) {
+			if (!used[indices[t * 3 + k]]) {
+				used[indices[t * 3 + k]] = true;
+				uniqueVertices++;
+			}
+		}
+	}
+	if (indexCount >= 3) {
+		statistics.acmr = (float)statistics.transformedVertices / (indexCount / 3);
+		statistics.atvr = (float)statistics.transformedVertices / uniqueVertices;
+	}
+	return statistics;
+}
+
+// Resolução de cada projeção usada por analyze_overdraw.
+const int OVERDRAW_GRID_SIZE = 256;
+
+OverdrawStatistics analyze_overdraw(const MeshData& mesh) {
+	OverdrawStatistics statistics = {0, 0, 1.0f};
+	const VertexAttribute* position = find_float_position(mesh);
+	if (position == nullptr || mesh.vertexCount == 0) {
+		return statistics;
+	}
+
+	std::vector<float> points((size_t)mesh.vertexCount * 3);
+	float minimum[3] = {INFINITY, INFINITY, INFINITY};
+	float maximum[3] = {-INFINITY, -INFINITY, -INFINITY};
+	for (uint32_t v = 0; v < mesh.vertexCount; v++) {
+		float* p = &points[(size_t)v * 3];
+		memcpy(p, &mesh.vertices[(size_t)v * mesh.vertexStride + position->offset], 3 * sizeof(float));
+		for (int i = 0; i < 3; i++) {
+			minimum[i] = std::min(minimum[i], p[i]);
+			maximum[i] = std::max(maximum[i], p[i]);
+		}
+	}
+	float extent = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+	float scale = extent > 0.0f ? (OVERDRAW_GRID_SIZE - 1) / extent : 0.0f;
+
+	std::vector<float> depth((size_t)OVERDRAW_GRID_SIZE * OVERDRAW_GRID_SIZE);
+	for (int axis = 0; axis < 3; axis++) {
+		for (float side : {1.0f, -1.0f}) {
+			// Observador do lado side do eixo: (u, v) = os outros dois eixos, na ordem que mantém a base destra; menor
+			// profundidade = mais perto.
+			int uAxis = (axis + 1) % 3, vAxis = (axis + 2) % 3;
+			std::fill(depth.begin(), depth.end(), INFINITY);
+			for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+				float u[3], v[3], z[3];
+				for (int k = 0; k < 3; k++) {
+					const float* p = &points[(size_t)mesh.indices[t + k] * 3];
+					u[k] = (p[uAxis] - minimum[uAxis]) * scale;
+					v[k] = (p[vAxis] - minimum[vAxis]) * scale;
+					z[k] = -side * p[axis];
+				}
+				float area = (u[1] - u[0]) * (v[2] - v[0]) - (v[1] - v[0]) * (u[2] - u[0]);
+				if (area * side <= 0.0f) {
+					continue;  // face traseira ou degenerada
+				}
+
+				int x0 = std::max(0, (int)std::floor(std::min(u[0], std::min(u[1], u[2]))));
+				int x1 = std::min(OVERDRAW_GRID_SIZE - 1, (int)std::ceil(std::max(u[0], std::max(u[1], u[2]))));
+				int y0 = std::max(0, (int)std::floor(std::min(v[0], std::min(v[1], v[2]))));
+				int y1 = std::min(OVERDRAW_GRID_SIZE - 1, (int)std::ceil(std::max(v[0], std::max(v[1], v[2]))));
+				for (int y = y0; y <= y1; y++) {
+					for (int x = x0; x <= x1; x++) {
+						// Coordenadas baricêntricas do centro do pixel.
+						float px = x + 0.5f, py = y + 0.5f;
+						float w0 = ((u[1] - px) * (v[2] - py) - (v[1] - py) * (u[2] - px)) / area;
+						float w1 = ((u[2] - px) * (v[0] - py) - (v[2] - py) * (u[0] - px)) / area;
+						float w2 = 1.0f - w0 - w1;
+						if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) {
+							continue;
+						}
+						float fragmentDepth = w0 * z[0] + w1 * z[1] + w2 * z[2];
+						float& stored = depth[(size_t)y * OVERDRAW_GRID_SIZE + x];
+						if (fragmentDepth < stored) {
+							stored = fragmentDepth;
+							statistics.shadedPixels++;
+						}
+					}
+				}
+			}
+			for (float value : depth) {
+				statistics.coveredPixels += value != INFINITY;
+			}
+		}
+	}
+	if (statistics.coveredPixels > 0) {
+		statistics.overdraw = (float)statistics.shadedPixels / statistics.coveredPixels;
+	}
+	return statistics;
+}
+
+// Quádrica de erro (matriz 4x4 simétrica) com o peso acumulado, para converter o erro em distância.
+struct Quadric {
+	double a00, a01, a02, a03, a11, a12, a13, a22, a23, a33;
+	double weight;
+};
+
+// Peso das quádricas das bordas abertas em relação às das faces (ambas proporcionais a área).
+const double BORDER_WEIGHT = 10.0;
+// Menor cosseno aceito entre a normal de um triângulo antes e depois de um colapso.
+const float FLIP_COSINE = 0.2f;
+
+// Soma à quádrica o plano n . p + d = 0 (n unitária) com o peso informado.
+static void quadric_add_plane(Quadric& q, const double n[3], double d, double weight) {
+	q.a00 += weight * n[0] * n[0];
+	q.a01 += weight * n[0] * n[1];
+	q.a02 += weight * n[0] * n[2];
+	q.a03 += weight * n[0] * d;
+	q.a11 += weight * n[1] * n[1];
+	q.a12 += weight * n[1] * n[2];
+	q.a13 += weight * n[1] * d;
+	q.a22 += weight * n[2] * n[2];
+	q.a23 += weight * n[2] * d;
+	q.a33 += weight * d * d;
+	q.weight += weight;
+}
+
+static Quadric quadric_sum(const Quadric& a, const Quadric& b) {
+	return {a.a00 + b.a00, a.a01 + b.a01, a.a02 + b.a02, a.a03 + b.a03, a.a11 + b.a11, a.a12 + b.a12,
+			a.a13 + b.a13, a.a22 + b.a22, a.a23 + b.a23, a.a33 + b.a33, a.weight + b.weight};
+}
+
+// Soma ponderada dos quadrados das distâncias de p aos planos da quádrica.
+static double quadric_error(const Quadric& q, const float p[3]) {
+	double x = p[0], y = p[1], z = p[2];
+	double error = q.a00 * x * x + 2.0 * q.a01 * x * y + 2.0 * q.a02 * x * z + 2.0 * q.a03 * x + q.a11 * y * y +
+				   2.0 * q.a12 * y * z + 2.0 * q.a13 * y + q.a22 * z * z + 2.0 * q.a23 * z + q.a33;
+	return fabs(error);
+}
+
+static void triangle_normal(const float* p0, const float* p1, const float* p2, double n[3]) {
+	double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+	double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+	n[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	n[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	n[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+// Estado da simplificação. Os vértices na mesma posição formam um grupo (representado pelo menor índice); os colapsos
+// acontecem entre grupos e cada vértice do grupo removido (uma "cunha", com os seus atributos) passa a apontar para
+// uma cunha do grupo de destino com que compartilha um triângulo.
+class Simplifier {
+   public:
+	Simplifier(const uint32_t* indices, size_t indexCount, const uint8_t* positionData, size_t stride,
+			   uint32_t vertexCount);
+
+	// Colapsa arestas até restarem no máximo targetTriangles triângulos. Retorna o maior erro (distância).
+	float run(size_t targetTriangles);
+	// Triângulos restantes (com os índices já remapeados), na ordem original, e o triângulo de origem de cada um.
+	void collect(std::vector<uint32_t>& indices, std::vector<uint32_t>& sources);
+
+   protected:
+	struct Collapse {
+		uint32_t from, to;
+		double cost;
+	};
+
+	const float* position(uint32_t v) const { return &positions[(size_t)v * 3]; }
+	uint32_t resolve(uint32_t v);
+	uint32_t corner(size_t t, int k) { return resolve(triangles[t * 3 + k]); }
+	void computeQuadrics();
+	void buildAdjacency();
+	bool tryCollapse(uint32_t from, uint32_t to);
+
+	std::vector<float> positions;
+	std::vector<uint32_t> triangles;
+	std::vector<uint8_t> alive;
+	size_t liveTriangles = 0;
+	std::vector<uint32_t> group;	 // representante do grupo de cada vértice
+	std::vector<uint32_t> remap;	 // vértice que substitui cada um (ele mesmo enquanto não foi colapsado)
+	std::vector<Quadric> quadrics;	 // por grupo
+	std::vector<uint32_t> adjacencyOffset, adjacency;  // grupo -> triângulos vivos (refeita a cada passada)
+	std::vector<std::pair<uint32_t, uint32_t>> wedgeTargets;
+};
+
+Simplifier::Simplifier(const uint32_t* indices, size_t indexCount, const uint8_t* positionData, size_t stride,
+					   uint32_t vertexCount)
+	: positions((size_t)vertexCount * 3), triangles(indices, indices + indexCount / 3 * 3), group(vertexCount),
+	  remap(vertexCount), quadrics(vertexCount, Quadric{}) {
+	for (uint32_t v = 0; v < vertexCount; v++) {
+		memcpy(&positions[(size_t)v * 3], positionData + (size_t)v * stride, 3 * sizeof(float));
+		remap[v] = v;
+	}
+
+	// Agrupa os vértices com a mesma posição (ordenando pelas coordenadas).
+	std::vector<uint32_t> order(vertexCount);
+	for (uint32_t v = 0; v < vertexCount; v++) {
+		order[v] = v;
+	}
+	auto less = [this](uint32_t a, uint32_t b) {
+		const float* pa = position(a);
+		const float* pb = position(b);
+		if (pa[0] != pb[0]) return pa[0] < pb[0];
+		if (pa[1] != pb[1]) return pa[1] < pb[1];
+		if (pa[2] != pb[2]) return pa[2] < pb[2];
+		return a < b;
+	};
+	std::sort(order.begin(), order.end(), less);
+	for (uint32_t i = 0; i < vertexCount; i++) {
+		const float* p = position(order[i]);
+		bool same = i > 0 && memcmp(p, position(order[i - 1]), 3 * sizeof(float)) == 0;
+		group[order[i]] = same ? group[order[i - 1]] : order[i];
+	}
+
+	// Triângulos sem área no espaço das posições não entram.
+	alive.assign(triangles.size() / 3, 0);
+	for (size_t t = 0; t < alive.size(); t++) {
+		uint32_t g0 = group[triangles[t * 3]], g1 = group[triangles[t * 3 + 1]], g2 = group[triangles[t * 3 + 2]];
+		alive[t] = g0 != g1 && g1 != g2 && g0 != g2;
+		liveTriangles += alive[t];
+	}
+	computeQuadrics();
+}
+
+uint32_t Simplifier::resolve(uint32_t v) {
+	uint32_t root = v;
+	while (remap[root] != root) {
+		root = remap[root];
+	}
+	while (remap[v] != root) {
+		uint32_t next = remap[v];
+		remap[v] = root;
+		v = next;
+	}
+	return root;
+}
+
+void Simplifier::computeQuadrics() {
+	// Planos das faces, com peso igual à área.
+	std::vector<std::pair<uint64_t, uint32_t>> edges;  // (par de grupos, triângulo * 3 + aresta)
+	for (size_t t = 0; t < alive.size(); t++) {
+		if (!alive[t]) {
+			continue;
+		}
+		const float* p[3] = {position(triangles[t * 3]), position(triangles[t * 3 + 1]),
+							 position(triangles[t * 3 + 2])};
+		double n[3];
+		triangle_normal(p[0], p[1], p[2], n);
+		double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (length > 0.0) {
+			n[0] /= length;
+			n[1] /= length;
+			n[2] /= length;
+			double d = -(n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2]);
+			for (int k = 0; k < 3; k++) {
+				quadric_add_plane(quadrics[group[triangles[t * 3 + k]]], n, d, length * 0.5);
+			}
+		}
+		for (int k = 0; k < 3; k++) {
+			uint64_t a = group[triangles[t * 3 + k]], b = group[triangles[t * 3 + (k + 1) % 3]];
+			edges.push_back({std::min(a, b) << 32 | std::max(a, b), (uint32_t)(t * 3 + k)});
+		}
+	}
+
+	// Arestas usadas por um único triângulo são bordas abertas: um plano perpendicular à face, passando pela aresta,
+	// impede que a borda encolha.
+	std::sort(edges.begin(), edges.end());
+	for (size_t i = 0; i < edges.size();) {
+		size_t end = i + 1;
+		while (end < edges.size() && edges[end].first == edges[i].first) {
+			end++;
+		}
+		if (end - i == 1) {
+			size_t t = edges[i].second / 3;
+			int k = edges[i].second % 3;
+			uint32_t va = triangles[t * 3 + k], vb = triangles[t * 3 + (k + 1) % 3];
+			const float* pa = position(va);
+			const float* pb = position(vb);
+			double face[3];
+			triangle_normal(position(triangles[t * 3]), position(triangles[t * 3 + 1]), position(triangles[t * 3 + 2]),
+							face);
+			double e[3] = {pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2]};
+			double n[3] = {e[1] * face[2] - e[2] * face[1], e[2] * face[0] - e[0] * face[2],
+						   e[0] * face[1] - e[1] * face[0]};
+			double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length > 0.0) {
+				n[0] /= length;
+				n[1] /= length;
+				n[2] /= length;
+				double d = -(n[0] * pa[0] + n[1] * pa[1] + n[2] * pa[2]);
+				double weight = (e[0] * e[0] + e[1] * e[1] + e[2] * e[2]) * BORDER_WEIGHT;
+				quadric_add_plane(quadrics[group[va]], n, d, weight);
+				quadric_add_plane(quadrics[group[vb]], n, d, weight);
+			}
+		}
+		i = end;
+	}
+}
+
+void Simplifier::buildAdjacency() {
+	adjacencyOffset.assign(group.size() + 1, 0);
+	for (size_t t = 0; t < alive.size(); t++) {
+		if (alive[t]) {
+			for (int k = 0; k < 3; k++) {
+				adjacencyOffset[group[corner(t, k)] + 1]++;
+			}
+		}
+	}
+	for (size_t g = 0; g < group.size(); g++) {
+		adjacencyOffset[g + 1] += adjacencyOffset[g];
+	}
+	adjacency.resize(adjacencyOffset.back());
+	std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+	for (size_t t = 0; t < alive.size(); t++) {
+		if (alive[t]) {
+			for (int k = 0; k < 3; k++) {
+				adjacency[fill[group[corner(t, k)]]++] = (uint32_t)t;
+			}
+		}
+	}
+}
+
+// Contrai o grupo from para o grupo to, se o colapso não virar nenhum triângulo e todas as cunhas de from tiverem
+// para onde ir.
+bool Simplifier::tryCollapse(uint32_t from, uint32_t to) {
+	wedgeTargets.clear();
+	for (uint32_t i = adjacencyOffset[from]; i < adjacencyOffset[from + 1]; i++) {
+		uint32_t t = adjacency[i];
+		if (!alive[t]) {
+			continue;
+		}
+		uint32_t c[3] = {corner(t, 0), corner(t, 1), corner(t, 2)};
+		int toCorner = -1;
+		for (int k = 0; k < 3; k++) {
+			if (group[c[k]] == to) toCorner = k;
+		}
+		if (toCorner >= 0) {
+			// Triângulo que some: a cunha de from vai para a cunha de to do mesmo triângulo.
+			for (int k = 0; k < 3; k++) {
+				if (group[c[k]] == from) {
+					wedgeTargets.push_back({c[k], c[toCorner]});
+				}
+			}
+			continue;
+		}
+
+		// Triângulo que fica: a normal não pode virar.
+		const float* before[3];
+		const float* after[3];
+		for (int k = 0; k < 3; k++) {
+			before[k] = position(c[k]);
+			after[k] = group[c[k]] == from ? position(to) : before[k];
+		}
+		double n0[3], n1[3];
+		triangle_normal(before[0], before[1], before[2], n0);
+		triangle_normal(after[0], after[1], after[2], n1);
+		double dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+		double lengths =
+			sqrt((n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]) * (n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]));
+		if (lengths == 0.0 || dot < FLIP_COSINE * lengths) {
+			return false;
+		}
+	}
+
+	// Toda cunha de from usada por um triângulo que fica precisa de um destino (senão a costura abriria).
+	auto target = [this](uint32_t wedge) -> int64_t {
+		for (const auto& pair : wedgeTargets) {
+			if (pair.first == wedge) return pair.second;
+		}
+		return -1;
+	};
+	for (uint32_t i = adjacencyOffset[from]; i < adjacencyOffset[from + 1]; i++) {
+		uint32_t t = adjacency[i];
+		for (int k = 0; k < 3 && alive[t]; k++) {
+			uint32_t c = corner(t, k);
+			if (group[c] == from && target(c) < 0) {
+				return false;
+			}
+		}
+	}
+
+	for (uint32_t i = adjacencyOffset[from]; i < adjacencyOffset[from + 1]; i++) {
+		uint32_t t = adjacency[i];
+		if (!alive[t]) {
+			continue;
+		}
+		bool removed = false;
+		for (int k = 0; k < 3; k++) {
+			removed = removed || group[corner(t, k)] == to;
+		}
+		if (removed) {
+			alive[t] = 0;
+			liveTriangles--;
+		}
+	}
+	for (const auto& pair : wedgeTargets) {
+		remap[pair.first] = pair.second;
+	}
+	quadrics[to] = quadric_sum(quadrics[to], quadrics[from]);
+	return true;
+}
+
+float Simplifier::run(size_t targetTriangles) {
+	double maxError = 0.0;
+	std::vector<Collapse> candidates;
+	std::vector<uint8_t> locked(group.size());
+	while (liveTriangles > targetTriangles) {
+		buildAdjacency();
+
+		// Arestas entre grupos (sem repetição), cada uma na direção de menor custo.
+		std::vector<uint64_t> edges;
+		for (size_t t = 0; t < alive.size(); t++) {
+			if (!alive[t]) {
+				continue;
+			}
+			for (int k = 0; k < 3; k++) {
+				uint64_t a = group[corner(t, k)], b = group[corner(t, (k + 1) % 3)];
+				edges.push_back(std::min(a, b) << 32 | std::max(a, b));
+			}
+		}
+		std::sort(edges.begin(), edges.end());
+		edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+		candidates.clear();
+		for (uint64_t edge : edges) {
+			uint32_t a = (uint32_t)(edge >> 32), b = (uint32_t)edge;
+			Quadric q = quadric_sum(quadrics[a], quadrics[b]);
+			double toB = quadric_error(q, position(b));
+			double toA = quadric_error(q, position(a));
+			candidates.push_back(toB <= toA ? Collapse{a, b, toB} : Collapse{b, a, toA});
+		}
+		std::sort(candidates.begin(), candidates.end(),
+				  [](const Collapse& x, const Collapse& y) { return x.cost < y.cost; });
+
+		// Colapsos mais baratos primeiro; as pontas de cada colapso ficam travadas até a próxima passada (as quádricas
+		// e a adjacência delas mudaram). Cada colapso remove cerca de dois triângulos.
+		std::fill(locked.begin(), locked.end(), 0);
+		size_t goal = std::max<size_t>(1, (liveTriangles - targetTriangles) / 2);
+		size_t collapses = 0;
+		for (const Collapse& collapse : candidates) {
+			if (collapses >= goal || liveTriangles <= targetTriangles) {
+				break;
+			}
+			if (locked[collapse.from] || locked[collapse.to] || !tryCollapse(collapse.from, collapse.to)) {
+				continue;
+			}
+			locked[collapse.from] = locked[collapse.to] = 1;
+			const Quadric& q = quadrics[collapse.to];
+			if (q.weight > 0.0) {
+				maxError = std::max(maxError, sqrt(collapse.cost / q.weight));
+			}
+			collapses++;
+		}
+		if (collapses == 0) {
+			break;
+		}
+	}
+	return (float)maxError;
+}
+
+void Simplifier::collect(std::vector<uint32_t>& indices, std::vector<uint32_t>& sources) {
+	indices.clear();
+	sources.clear();
+	for (size_t t = 0; t < alive.size(); t++) {
+		if (alive[t]) {
+			for (int k = 0; k < 3; k++) {
+				indices.push_back(corner(t, k));
+			}
+			sources.push_back((uint32_t)t);
+		}
+	}
+}
+
+size_t simplify_mesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint8_t* positions,
+					 size_t positionStride, uint32_t vertexCount, size_t targetIndexCount, float* error) {
+	Simplifier simplifier(indices, indexCount, positions, positionStride, vertexCount);
+	float result = simplifier.run(targetIndexCount / 3);
+	if (error != nullptr) {
+		*error = result;
+	}
+	std::vector<uint32_t> simplified, sources;
+	simplifier.collect(simplified, sources);
+	std::copy(simplified.begin(), simplified.end(), destination);
+	return simplified.size();
+}
+
+void generate_mesh_lods(MeshData& mesh, int levelCount, float reduction) {
+	const VertexAttribute* position = find_float_position(mesh);
+	if (position == nullptr || mesh.indices.empty() || !mesh.lods.empty()) {
+		return;
+	}
+	uint32_t baseSubmeshes = (uint32_t)mesh.submeshes.size();
+	size_t baseIndices = mesh.indices.size();
+	mesh.lods.push_back({0, baseSubmeshes, 0.0f, 0});
+
+	// Cada nível é simplificado a partir da malha completa (todas as faixas juntas, para que as fronteiras entre
+	// materiais não se abram) e os triângulos restantes voltam para as faixas de origem.
+	std::vector<uint32_t> triangleSubmesh(baseIndices / 3);
+	for (uint32_t s = 0; s < baseSubmeshes; s++) {
+		const Submesh& submesh = mesh.submeshes[s];
+		for (uint32_t i = 0; i < submesh.indexCount / 3; i++) {
+			triangleSubmesh[submesh.indexOffset / 3 + i] = s;
+		}
+	}
+
+	size_t previousTriangles = baseIndices / 3;
+	float target = (float)previousTriangles;
+	for (int level = 1; level < levelCount; level++) {
+		target *= reduction;
+		Simplifier simplifier(mesh.indices.data(), baseIndices, &mesh.vertices[position->offset], mesh.vertexStride,
+							  mesh.vertexCount);
+		float error = simplifier.run((size_t)target);
+		std::vector<uint32_t> simplified, sources;
+		simplifier.collect(simplified, sources);
+		size_t triangles = sources.size();
+		if (triangles == 0 || triangles > previousTriangles * 0.8) {
+			break;
+		}
+		previousTriangles = triangles;
+
+		// Os triângulos restantes estão na ordem original, portanto agrupados por faixa.
+		MeshLod lod = {(uint32_t)mesh.submeshes.size(), 0, error, 0};
+		for (size_t i = 0; i < triangles;) {
+			uint32_t s = triangleSubmesh[sources[i]];
+			size_t end = i;
+			while (end < triangles && triangleSubmesh[sources[end]] == s) {
+				end++;
+			}
+			mesh.submeshes.push_back(
+				{(uint32_t)mesh.indices.size(), (uint32_t)(end - i) * 3, mesh.submeshes[s].materialId, 0});
+			mesh.indices.insert(mesh.indices.end(), simplified.begin() + i * 3, simplified.begin() + end * 3);
+			lod.submeshCount++;
+			i = end;
+		}
+		mesh.lods.push_back(lod);
+	}
+}
+
+void optimize_vertex_fetch(MeshData& mesh) {
+	const uint32_t UNUSED = 0xFFFFFFFFu;
+	std::vector<uint32_t> remap(mesh.vertexCount, UNUSED);
+	uint32_t next = 0;
+	for (uint32_t& index : mesh.indices) {
+		if (remap[index] == UNUSED) {
+			remap[index] = next++;
+		}
+		index = remap[index];
+	}
+
+	std::vector<uint8_t> vertices((size_t)next * mesh.vertexStride);
+	for (uint32_t v = 0; v < mesh.vertexCount; v++) {
+		if (remap[v] != UNUSED) {
+			memcpy(&vertices[(size_t)remap[v] * mesh.vertexStride], &mesh.vertices[(size_t)v * mesh.vertexStride],
+				   mesh.vertexStride);
+		}
+	}
+	mesh.vertices.swap(vertices);
+	mesh.vertexCount = next;
+}
+
+// Conversão de float para half float (IEEE 754 binary16) com arredondamento para o mais próximo.
+static uint16_t float_to_half(float value) {
+	uint32_t bits;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = (bits >> 16) & 0x8000u;
+	int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+	uint32_t mantissa = bits & 0x7FFFFFu;
+
+	if (((bits >> 23) & 0xFF) == 0xFF) {
+		return (uint16_t)(sign | 0x7C00u | (mantissa ? 0x200u : 0));
+	}
+	if (exponent >= 31) {
+		return (uint16_t)(sign | 0x7C00u);
+	}
+	if (exponent <= 0) {
+		if (exponent < -10) {
+			return (uint16_t)sign;
+		}
+		mantissa |= 0x800000u;
+		uint32_t shift = (uint32_t)(14 - exponent);
+		uint32_t half = mantissa >> shift;
+		uint32_t rest = mantissa & ((1u << shift) - 1);
+		uint32_t halfway = 1u << (shift - 1);
+		if (rest > halfway || (rest == halfway && (half & 1))) {
+			half++;
+		}
+		return (uint16_t)(sign | half);
+	}
+
+	uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+	uint32_t rest = mantissa & 0x1FFFu;
+	if (rest > 0x1000u || (rest == 0x1000u && (half & 1))) {
+		half++;
+	}
+	return (uint16_t)half;
+}
+
+// Empacota um vetor normalizado em 10:10:10:2 com sinal (w = 0).
+static uint32_t pack_snorm_10_10_10_2(float x, float y, float z) {
+	auto pack = [](float value) {
+		value = std::max(-1.0f, std::min(1.0f, value));
+		int quantized = (int)lroundf(value * 511.0f);
+		return (uint32_t)quantized & 0x3FFu;
+	};
+	return pack(x) | (pack(y) << 10) | (pack(z) << 20);
+}
+
+void quantize_mesh(MeshData& mesh) {
+	const VertexAttribute* position = nullptr;
+	const VertexAttribute* texCoord = nullptr;
+	const VertexAttribute* normal = nullptr;
+	for (const VertexAttribute& attribute : mesh.attributes) {
+		if (attribute.type != ATTRIBUTE_FLOAT32) {
+			return;	 // já quantizada
+		}
+		if (attribute.location == ATTRIBUTE_POSITION) position = &attribute;
+		if (attribute.location == ATTRIBUTE_TEXCOORD) texCoord = &attribute;
+		if (attribute.location == ATTRIBUTE_NORMAL) normal = &attribute;
+	}
+	if (position == nullptr) {
+		return;
+	}
+
+	const uint32_t stride = 20;
+	std::vector<uint8_t> vertices((size_t)mesh.vertexCount * stride, 0);
+	for (uint32_t v = 0; v < mesh.vertexCount; v++) {
+		const uint8_t* in = &mesh.vertices[(size_t)v * mesh.vertexStride];
+		uint8_t* out = &vertices[(size_t)v * stride];
+
+		memcpy(out, in + position->offset, 3 * sizeof(float));
+
+		if (texCoord != nullptr) {
+			float st[2];
+			memcpy(st, in + texCoord->offset, sizeof(st));
+			uint16_t halves[2] = {float_to_half(st[0]), float_to_half(st[1])};
+			memcpy(out + 12, halves, sizeof(halves));
+		}
+
+		if (normal != nullptr) {
+			float n[3];
+			memcpy(n, in + normal->offset, sizeof(n));
+			float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length > 0.0f) {
+				n[0] /= length;
+				n[1] /= length;
+				n[2] /= length;
+			}
+			uint32_t packed = pack_snorm_10_10_10_2(n[0], n[1], n[2]);
+			memcpy(out + 16, &packed, sizeof(packed));
+		}
+	}
+
+	mesh.attributes = {
+		{ATTRIBUTE_POSITION, 3, ATTRIBUTE_FLOAT32, 0, 0},
+		{ATTRIBUTE_TEXCOORD, 2, ATTRIBUTE_FLOAT16, 0, 12},
+		{ATTRIBUTE_NORMAL, 4, ATTRIBUTE_INT_2_10_10_10, 1, 16},
+	};
+	mesh.vertexStride = stride;
+	mesh.vertices.swap(vertices);
+}
+
+// Normal unitária -> coordenadas octaédricas em [-1, 1]^2 (o octaedro |x| + |y| + |z| = 1 desdobrado sobre o plano;
+// o hemisfério z < 0 é dobrado para os cantos do quadrado).
+static void encode_octahedral(const float n[3], float& u, float& v) {
+	float l1 = fabsf(n[0]) + fabsf(n[1]) + fabsf(n[2]);
+	if (l1 == 0.0f) {
+		u = v = 0.0f;
+		return;
+	}
+	u = n[0] / l1;
+	v = n[1] / l1;
+	if (n[2] < 0.0f) {
+		float x = u, y = v;
+		u = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		v = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+	}
+}
+
+// Inversa de encode_octahedral (a mesma conta de decode_octahedral no Shader.vs).
+static void decode_octahedral(float u, float v, float n[3]) {
+	n[0] = u;
+	n[1] = v;
+	n[2] = 1.0f - fabsf(u) - fabsf(v);
+	float t = std::max(-n[2], 0.0f);
+	n[0] += n[0] >= 0.0f ? -t : t;
+	n[1] += n[1] >= 0.0f ? -t : t;
+	float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+	for (int k = 0; k < 3; k++) {
+		n[k] /= length;
+	}
+}
+
+static int16_t pack_snorm16(float value) {
+	value = std::max(-1.0f, std::min(1.0f, value));
+	return (int16_t)lroundf(value * 32767.0f);
+}
+
+static uint16_t pack_unorm16(float value) {
+	value = std::max(0.0f, std::min(1.0f, value));
+	return (uint16_t)lroundf(value * 65535.0f);
+}
+
+void pack_mesh(MeshData& mesh) {
+	const VertexAttribute* position = nullptr;
+	const VertexAttribute* texCoord = nullptr;
+	const VertexAttribute* normal = nullptr;
+	for (const VertexAttribute& attribute : mesh.attributes) {
+		if (attribute.type != ATTRIBUTE_FLOAT32) {
+			return;	 // já quantizada
+		}
+		if (attribute.location == ATTRIBUTE_POSITION) position = &attribute;
+		if (attribute.location == ATTRIBUTE_TEXCOORD) texCoord = &attribute;
+		if (attribute.location == ATTRIBUTE_NORMAL) normal = &attribute;
+	}
+	if (position == nullptr) {
+		return;
+	}
+
+	// Eixos sem extensão (malha plana) ficam com 0 e são decodificados como boundsMin.
+	float scale[3];
+	for (int axis = 0; axis < 3; axis++) {
+		float extent = mesh.boundsMax[axis] - mesh.boundsMin[axis];
+		scale[axis] = extent > 0.0f ? 1.0f / extent : 0.0f;
+	}
+
+	const uint32_t stride = 16;
+	std::vector<uint8_t> vertices((size_t)mesh.vertexCount * stride, 0);
+	for (uint32_t v = 0; v < mesh.vertexCount; v++) {
+		const uint8_t* in = &mesh.vertices[(size_t)v * mesh.vertexStride];
+		uint8_t* out = &vertices[(size_t)v * stride];
+
+		float p[3];
+		memcpy(p, in + position->offset, sizeof(p));
+		uint16_t units[3];
+		for (int axis = 0; axis < 3; axis++) {
+			units[axis] = pack_unorm16((p[axis] - mesh.boundsMin[axis]) * scale[axis]);
+		}
+		memcpy(out, units, sizeof(units));
+
+		if (texCoord != nullptr) {
+			float st[2];
+			memcpy(st, in + texCoord->offset, sizeof(st));
+			uint16_t halves[2] = {float_to_half(st[0]), float_to_half(st[1])};
+			memcpy(out + 8, halves, sizeof(halves));
+		}
+
+		if (normal != nullptr) {
+			float n[3], u, w;
+			memcpy(n, in + normal->offset, sizeof(n));
+			encode_octahedral(n, u, w);
+			int16_t packed[2] = {pack_snorm16(u), pack_snorm16(w)};
+			memcpy(out + 12, packed, sizeof(packed));
+		}
+	}
+
+	mesh.attributes = {
+		{ATTRIBUTE_POSITION, 3, ATTRIBUTE_UINT16, 1, 0},
+		{ATTRIBUTE_TEXCOORD, 2, ATTRIBUTE_FLOAT16, 0, 8},
+		{ATTRIBUTE_NORMAL, 2, ATTRIBUTE_INT16, 1, 12},
+	};
+	mesh.vertexStride = stride;
+	mesh.vertices.swap(vertices);
+}
+
+static float half_to_float(uint16_t half) {
+	uint32_t sign = (uint32_t)(half & 0x8000u) << 16;
+	uint32_t exponent = (half >> 10) & 0x1Fu;
+	uint32_t mantissa = half & 0x3FFu;
+	uint32_t bits;
+	if (exponent == 0x1F) {
+		bits = sign | 0x7F800000u | (mantissa << 13);
+	} else if (exponent != 0) {
+		bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+	} else if (mantissa == 0) {
+		bits = sign;
+	} else {
+		float value = mantissa * (1.0f / 16777216.0f);	// subnormal: mantissa * 2^-24
+		return sign ? -value : value;
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// Componentes de um atributo convertidos como a OpenGL os entrega ao shader (regras de normalização da 4.1).
+static void read_attribute(const uint8_t* in, const VertexAttribute& attribute, float out[4]) {
+	const uint8_t* data = in + attribute.offset;
+	for (uint32_t k = 0; k < attribute.components; k++) {
+		switch (attribute.type) {
+			case ATTRIBUTE_FLOAT16: {
+				uint16_t half;
+				memcpy(&half, data + k * 2, sizeof(half));
+				out[k] = half_to_float(half);
+				break;
+			}
+			case ATTRIBUTE_UINT16: {
+				uint16_t value;
+				memcpy(&value, data + k * 2, sizeof(value));
+				out[k] = attribute.normalized ? value / 65535.0f : (float)value;
+				break;
+			}
+			case ATTRIBUTE_INT16: {
+				int16_t value;
+				memcpy(&value, data + k * 2, sizeof(value));
+				out[k] = attribute.normalized ? std::max(value / 32767.0f, -1.0f) : (float)value;
+				break;
+			}
+			case ATTRIBUTE_INT_2_10_10_10: {
+				uint32_t packed;
+				memcpy(&packed, data, sizeof(packed));
+				int bits = k < 3 ? 10 : 2;
+				int32_t value = (int32_t)(packed << (32 - bits - 10 * k)) >> (32 - bits);
+				float scale = (float)((1 << (bits - 1)) - 1);
+				out[k] = attribute.normalized ? std::max(value / scale, -1.0f) : (float)value;
+				break;
+			}
+			case ATTRIBUTE_FLOAT32:
+			default:
+				memcpy(&out[k], data + k * 4, sizeof(float));
+				break;
+		}
+	}
+}
+
+void decode_vertex(const MeshData& mesh, uint32_t v, float position[3], float texCoord[2], float normal[3]) {
+	const uint8_t* in = &mesh.vertices[(size_t)v * mesh.vertexStride];
+	for (int k = 0; k < 3; k++) {
+		position[k] = normal[k] = 0.0f;
+	}
+	texCoord[0] = texCoord[1] = 0.0f;
+
+	for (const VertexAttribute& attribute : mesh.attributes) {
+		float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		read_attribute(in, attribute, value);
+		if (attribute.location == ATTRIBUTE_POSITION) {
+			bool relative = attribute.type == ATTRIBUTE_UINT16 && attribute.normalized;
+			for (int axis = 0; axis < 3; axis++) {
+				float extent = mesh.boundsMax[axis] - mesh.boundsMin[axis];
+				position[axis] = relative ? mesh.boundsMin[axis] + value[axis] * extent : value[axis];
+			}
+		} else if (attribute.location == ATTRIBUTE_TEXCOORD) {
+			texCoord[0] = value[0];
+			texCoord[1] = value[1];
+		} else if (attribute.location == ATTRIBUTE_NORMAL) {
+			if (attribute.components == 2) {
+				decode_octahedral(value[0], value[1], normal);
+			} else {
+				memcpy(normal, value, 3 * sizeof(float));
+			}
+		}
+	}
+}
+
+void decode_positions(const uint8_t* vertices, uint32_t vertexCount, uint32_t vertexStride,
+					  const VertexAttribute* attributes, uint32_t attributeCount, const float boundsMin[3],
+					  const float boundsMax[3], float* positions) {
+	const VertexAttribute* position = nullptr;
+	for (uint32_t i = 0; i < attributeCount; i++) {
+		if (attributes[i].location == ATTRIBUTE_POSITION) {
+			position = &attributes[i];
+		}
+	}
+	if (!position) {
+		memset(positions, 0, (size_t)vertexCount * 3 * sizeof(float));
+		return;
+	}
+
+	bool relative = position->type == ATTRIBUTE_UINT16 && position->normalized;
+	for (uint32_t v = 0; v < vertexCount; v++) {
+		float value[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+		read_attribute(vertices + (size_t)v * vertexStride, *position, value);
+		for (int axis = 0; axis < 3; axis++) {
+			float extent = boundsMax[axis] - boundsMin[axis];
+			positions[3 * v + axis] = relative ? boundsMin[axis] + value[axis] * extent : value[axis];
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MeshData.h"
+
+// Reordena os triângulos de indices[0, indexCount) para reaproveitar o cache pós-transformação de vértices
+// (algoritmo de Tom Forsyth, "Linear-Speed Vertex Cache Optimisation").
+void optimize_vertex_cache(uint32_t* indices, size_t indexCount, uint32_t vertexCount);
+
+// Aplica optimize_vertex_cache em cada faixa (submesh) da malha.
+void optimize_mesh_vertex_cache(MeshData& mesh);
+
+// Reordena grupos de triângulos já em ordem de cache para reduzir o overdraw (Sander, Nehab e Barczak, "Fast Triangle
+// Reordering for Vertex Locality and Reduced Overdraw"): a sequência é dividida em grupos cujo ACMR não passa de
+// threshold vezes o da sequência original, e os grupos voltados para fora da malha são desenhados primeiro, escondendo
+// os de trás de quase todos os pontos de vista. positions: x, y, z em float, a cada positionStride bytes.
+void optimize_overdraw(uint32_t* indices, size_t indexCount, const uint8_t* positions, size_t positionStride,
+					   float threshold = 1.05f);
+
+// Aplica optimize_overdraw em cada faixa da malha (depois de optimize_mesh_vertex_cache, antes de quantize_mesh ou
+// pack_mesh).
+void optimize_mesh_overdraw(MeshData& mesh, float threshold = 1.05f);
+
+// Simplificação por colapso de arestas com métrica de erro quádrica (Garland e Heckbert, "Surface Simplification Using
+// Quadric Error Metrics"): cada aresta é contraída para uma das pontas, a de menor erro, até sobrarem no máximo
+// targetIndexCount índices (ou não haver mais colapsos válidos). Os vértices não mudam: destination recebe triângulos
+// com um subconjunto deles, na ordem original. Vértices na mesma posição com atributos diferentes (costuras de
+// coordenadas de textura ou normais) se movem juntos, sem abrir frestas, e as bordas abertas são preservadas por
+// quádricas extras. error recebe o maior erro geométrico dos colapsos (distância, nas unidades das posições).
+// positions: x, y, z em float, a cada positionStride bytes. Retorna o número de índices em destination.
+size_t simplify_mesh(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint8_t* positions,
+					 size_t positionStride, uint32_t vertexCount, size_t targetIndexCount, float* error = nullptr);
+
+// Gera até levelCount - 1 níveis de detalhe a partir da malha completa (antes das otimizações de índices e da
+// quantização), cada um com reduction vezes os triângulos do anterior. As faixas de material de cada nível são
+// acrescentadas em submeshes e o índice, em indices; a geração para quando a simplificação deixa de reduzir a malha.
+void generate_mesh_lods(MeshData& mesh, int levelCount = 4, float reduction = 0.25f);
+
+// Renumera os vértices na ordem do primeiro uso pelos índices, para que a leitura do VBO seja sequencial.
+// Vértices não referenciados são descartados.
+void optimize_vertex_fetch(MeshData& mesh);
+
+// Eficiência do cache pós-transformação simulado (FIFO com cacheSize vértices, como nas GPUs):
+// ACMR = vértices processados por triângulo (0.5 a 3), ATVR = vértices processados por vértice único (1 = ideal).
+struct VertexCacheStatistics {
+	uint32_t transformedVertices;
+	float acmr;
+	float atvr;
+};
+VertexCacheStatistics analyze_vertex_cache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount,
+										   int cacheSize = 16);
+
+// Overdraw da malha desenhada na ordem dos índices (faces traseiras descartadas, teste de profundidade ligado), medido
+// por rasterização na CPU em projeções ortográficas nos seis sentidos dos eixos: fragmentos sombreados por pixel
+// coberto (1 = sem overdraw).
+struct OverdrawStatistics {
+	uint32_t coveredPixels;
+	uint32_t shadedPixels;
+	float overdraw;
+};
+OverdrawStatistics analyze_overdraw(const MeshData& mesh);
+
+// Converte a malha com atributos float (posição, coordenada de textura, normal) para o formato compacto de 20 bytes:
+// posição em float, coordenada de textura em half float e normal em 10:10:10:2 normalizado.
+void quantize_mesh(MeshData& mesh);
+
+// Converte a malha com atributos float para o formato de 16 bytes, sem nenhum float:
+// - posição em 3 x 16 bits normalizados dentro da caixa envolvente (mais 2 bytes de alinhamento);
+// - coordenada de textura em half float (valores fora de [0, 1], de texturas repetidas, continuam valendo);
+// - normal em coordenadas octaédricas, 2 x 16 bits normalizados com sinal.
+// O vertex shader recebe a posição em [0, 1] e a normal em [-1, 1]^2 e as decodifica (MeshBatch.h: VertexDecode) com
+// a caixa envolvente da malha (boundsMin/boundsMax, que não mudam).
+void pack_mesh(MeshData& mesh);
+
+// Lê o vértice v de uma malha em qualquer um dos formatos acima, como o vertex shader o vê depois de decodificado
+// (atributos ausentes ficam com zero). Usado para medir o erro da quantização.
+void decode_vertex(const MeshData& mesh, uint32_t v, float position[3], float texCoord[2], float normal[3]);
+
+// Posições (x, y, z em float, 3 por vértice, em positions) dos vertexCount vértices intercalados de vertices,
+// decodificadas como em decode_vertex. Lê os vértices direto do cache mapeado, sem montar um MeshData.
+void decode_positions(const uint8_t* vertices, uint32_t vertexCount, uint32_t vertexStride,
+					  const VertexAttribute* attributes, uint32_t attributeCount, const float boundsMin[3],
+					  const float boundsMax[3], float* positions);
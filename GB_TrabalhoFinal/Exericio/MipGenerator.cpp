@@ -0,0 +1,671 @@
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "CpuFeatures.h"
+
+static uint64_t align16(uint64_t value) { return (value + 15) & ~(uint64_t)15; }
+
+MipSimd mip_simd_supported() {
+#ifdef CPU_X86
+	return cpu_has_avx2() ? MIP_SIMD_AVX2 : MIP_SIMD_SSE2;
+#else
+	return MIP_SIMD_SCALAR;
+#endif
+}
+
+const char* mip_simd_name(MipSimd simd) {
+	switch (simd) {
+		case MIP_SIMD_SCALAR:
+			return "escalar";
+		case MIP_SIMD_SSE2:
+			return "SSE2";
+		case MIP_SIMD_AVX2:
+			return "AVX2";
+		default:
+			return "auto";
+	}
+}
+
+// Executa body(primeira, última) em faixas de linhas, em paralelo se houver pool.
+template <typename Body>
+static void for_each_band(ThreadPool* pool, uint32_t rows, Body body) {
+	const uint32_t BAND_ROWS = 16;
+	uint32_t bands = (rows + BAND_ROWS - 1) / BAND_ROWS;
+	auto run = [&](int band) {
+		uint32_t first = (uint32_t)band * BAND_ROWS;
+		body(first, std::min(rows, first + BAND_ROWS));
+	};
+	if (pool && bands > 1) {
+		pool->parallelFor((int)bands, run);
+	} else {
+		for (uint32_t band = 0; band < bands; band++) {
+			run((int)band);
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Caixa 2x2 em inteiros (espaço linear). Cada função vetorizada processa os primeiros pixels de saída cujas duas
+// colunas de origem existem e retorna quantos processou; o restante (e a coluna repetida das larguras ímpares) fica
+// com a versão escalar.
+
+static void box_u8_row_scalar(const uint8_t* row0, const uint8_t* row1, uint32_t sourceWidth, uint8_t* out,
+							  uint32_t first, uint32_t width) {
+	for (uint32_t x = first; x < width; x++) {
+		uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+		uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+		for (int c = 0; c < 4; c++) {
+			uint32_t sum = row0[x0 * 4 + c] + row0[x1 * 4 + c] + row1[x0 * 4 + c] + row1[x1 * 4 + c];
+			out[x * 4 + c] = (uint8_t)((sum + 2) / 4);
+		}
+	}
+}
+
+#ifdef CPU_X86
+static uint32_t box_u8_row_sse2(const uint8_t* row0, const uint8_t* row1, uint32_t count, uint8_t* out) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+	uint32_t x = 0;
+	for (; x + 4 <= count; x += 4) {
+		// 8 pixels de origem por linha: soma vertical em 16 bits, dois pixels por registrador.
+		__m128i a0 = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+		__m128i a1 = _mm_loadu_si128((const __m128i*)(row0 + x * 8 + 16));
+		__m128i b0 = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+		__m128i b1 = _mm_loadu_si128((const __m128i*)(row1 + x * 8 + 16));
+		__m128i s0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+		__m128i s1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+		__m128i s2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+		__m128i s3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+		// Soma horizontal dos pares: a metade baixa de cada registrador fica com um pixel de saída.
+		s0 = _mm_add_epi16(s0, _mm_srli_si128(s0, 8));
+		s1 = _mm_add_epi16(s1, _mm_srli_si128(s1, 8));
+		s2 = _mm_add_epi16(s2, _mm_srli_si128(s2, 8));
+		s3 = _mm_add_epi16(s3, _mm_srli_si128(s3, 8));
+		__m128i out01 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s0, s1), two), 2);
+		__m128i out23 = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s2, s3), two), 2);
+		_mm_storeu_si128((__m128i*)(out + x * 4), _mm_packus_epi16(out01, out23));
+	}
+	return x;
+}
+
+CPU_TARGET_AVX2 static uint32_t box_u8_row_avx2(const uint8_t* row0, const uint8_t* row1, uint32_t count,
+												 uint8_t* out) {
+	const __m256i two = _mm256_set1_epi16(2);
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	uint32_t x = 0;
+	for (; x + 8 <= count; x += 8) {
+		// Cada bloco de 4 pixels de origem vira 16 valores de 16 bits: a metade baixa de cada faixa de 128 bits soma
+		// um par, ou seja, um pixel de saída (o par par na faixa 0 e o ímpar na faixa 1).
+		__m256i sums[4];
+		for (int i = 0; i < 4; i++) {
+			__m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row0 + x * 8 + i * 16)));
+			__m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(row1 + x * 8 + i * 16)));
+			__m256i s = _mm256_add_epi16(a, b);
+			sums[i] = _mm256_add_epi16(s, _mm256_srli_si256(s, 8));
+		}
+		__m256i low = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(sums[0], sums[1]), two), 2);
+		__m256i high = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(sums[2], sums[3]), two), 2);
+		// Depois do pack a ordem é 0 2 4 6 | 1 3 5 7.
+		__m256i packed = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(low, high), order);
+		_mm256_storeu_si256((__m256i*)(out + x * 4), packed);
+	}
+	return x;
+}
+#endif
+
+static void box_u8_level(const TextureLevel& source, const uint8_t* in, const TextureLevel& target, uint8_t* out,
+						 MipSimd simd, ThreadPool* pool) {
+	uint32_t paired = std::min(target.width, source.width / 2);
+	for_each_band(pool, target.height, [&](uint32_t first, uint32_t last) {
+		for (uint32_t y = first; y < last; y++) {
+			const uint8_t* row0 = in + (size_t)std::min(y * 2, source.height - 1) * source.width * 4;
+			const uint8_t* row1 = in + (size_t)std::min(y * 2 + 1, source.height - 1) * source.width * 4;
+			uint8_t* row = out + (size_t)y * target.width * 4;
+			uint32_t done = 0;
+#ifdef CPU_X86
+			if (simd == MIP_SIMD_AVX2) {
+				done = box_u8_row_avx2(row0, row1, paired, row);
+			}
+			if (simd >= MIP_SIMD_SSE2) {
+				done += box_u8_row_sse2(row0 + done * 8, row1 + done * 8, paired - done, row + done * 4);
+			}
+#endif
+			box_u8_row_scalar(row0, row1, source.width, row, done, target.width);
+		}
+	});
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Filtros em ponto flutuante (RGBA, um pixel = 4 floats). As versões vetorizadas fazem as mesmas operações, na mesma
+// ordem, que as escalares: os resultados são idênticos, a menos que o compilador funda multiplicações e somas em FMA
+// (ex.: -march=native) de um lado só, o que muda o arredondamento de alguns bytes em 1.
+
+// Caixa 2x2.
+static void box_f32_row_scalar(const float* row0, const float* row1, uint32_t sourceWidth, float* out, uint32_t first,
+							   uint32_t width) {
+	for (uint32_t x = first; x < width; x++) {
+		uint32_t x0 = std::min(x * 2, sourceWidth - 1);
+		uint32_t x1 = std::min(x * 2 + 1, sourceWidth - 1);
+		for (int c = 0; c < 4; c++) {
+			out[x * 4 + c] = (((row0[x0 * 4 + c] + row0[x1 * 4 + c]) + row1[x0 * 4 + c]) + row1[x1 * 4 + c]) * 0.25f;
+		}
+	}
+}
+
+#ifdef CPU_X86
+static uint32_t box_f32_row_sse2(const float* row0, const float* row1, uint32_t count, float* out) {
+	const __m128 quarter = _mm_set1_ps(0.25f);
+	for (uint32_t x = 0; x < count; x++) {
+		__m128 a = _mm_loadu_ps(row0 + x * 8);
+		__m128 b = _mm_loadu_ps(row0 + x * 8 + 4);
+		__m128 c = _mm_loadu_ps(row1 + x * 8);
+		__m128 d = _mm_loadu_ps(row1 + x * 8 + 4);
+		_mm_storeu_ps(out + x * 4, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(a, b), c), d), quarter));
+	}
+	return count;
+}
+
+CPU_TARGET_AVX2 static uint32_t box_f32_row_avx2(const float* row0, const float* row1, uint32_t count, float* out) {
+	const __m256 quarter = _mm256_set1_ps(0.25f);
+	uint32_t x = 0;
+	for (; x + 2 <= count; x += 2) {
+		// Pixels 0 1 | 2 3 de cada linha reorganizados em (0, 2) e (1, 3): dois pixels de saída por registrador.
+		__m256 r0a = _mm256_loadu_ps(row0 + x * 8), r0b = _mm256_loadu_ps(row0 + x * 8 + 8);
+		__m256 r1a = _mm256_loadu_ps(row1 + x * 8), r1b = _mm256_loadu_ps(row1 + x * 8 + 8);
+		__m256 a = _mm256_permute2f128_ps(r0a, r0b, 0x20), b = _mm256_permute2f128_ps(r0a, r0b, 0x31);
+		__m256 c = _mm256_permute2f128_ps(r1a, r1b, 0x20), d = _mm256_permute2f128_ps(r1a, r1b, 0x31);
+		_mm256_storeu_ps(out + x * 4,
+						 _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_add_ps(a, b), c), d), quarter));
+	}
+	return x;
+}
+#endif
+
+// Kaiser: 6 amostras por eixo, nas posições 2x-2 ... 2x+3 da origem (centro entre 2x e 2x+1).
+const int KAISER_TAPS = 6;
+
+static double bessel_i0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; k++) {
+		term *= (x / (2.0 * k)) * (x / (2.0 * k));
+		sum += term;
+	}
+	return sum;
+}
+
+static void kaiser_weights(float* weights) {
+	const double PI = 3.14159265358979323846;
+	const double BETA = 4.0;
+	const double RADIUS = 1.5;	// em pixels de saída
+	double total = 0.0, values[KAISER_TAPS];
+	for (int k = 0; k < KAISER_TAPS; k++) {
+		double t = (k - 2.5) / 2.0;	 // distância ao centro em pixels de saída
+		double sinc = std::sin(PI * t) / (PI * t);
+		double window = bessel_i0(BETA * std::sqrt(1.0 - (t / RADIUS) * (t / RADIUS))) / bessel_i0(BETA);
+		values[k] = sinc * window;
+		total += values[k];
+	}
+	for (int k = 0; k < KAISER_TAPS; k++) {
+		weights[k] = (float)(values[k] / total);
+	}
+}
+
+// Passo horizontal: uma linha de origem (sourceWidth pixels) para width pixels.
+static void kaiser_row_scalar(const float* in, uint32_t sourceWidth, float* out, uint32_t first, uint32_t last,
+							  const float* weights) {
+	for (uint32_t x = first; x < last; x++) {
+		for (int c = 0; c < 4; c++) {
+			float sum = 0.0f;
+			for (int k = 0; k < KAISER_TAPS; k++) {
+				int s = std::min(std::max((int)(x * 2) - 2 + k, 0), (int)sourceWidth - 1);
+				float term = weights[k] * in[s * 4 + c];
+				sum = k == 0 ? term : sum + term;
+			}
+			out[x * 4 + c] = sum;
+		}
+	}
+}
+
+// Passo vertical: combina KAISER_TAPS linhas, elemento a elemento.
+static void kaiser_column_scalar(const float* const* rows, float* out, uint32_t first, uint32_t count,
+								 const float* weights) {
+	for (uint32_t i = first; i < count; i++) {
+		float sum = 0.0f;
+		for (int k = 0; k < KAISER_TAPS; k++) {
+			float term = weights[k] * rows[k][i];
+			sum = k == 0 ? term : sum + term;
+		}
+		out[i] = sum;
+	}
+}
+
+#ifdef CPU_X86
+// Pixels de saída em [first, last) sem amostras fora da linha.
+static void kaiser_row_sse2(const float* in, float* out, uint32_t first, uint32_t last, const float* weights) {
+	for (uint32_t x = first; x < last; x++) {
+		const float* source = in + (x * 2 - 2) * 4;
+		__m128 sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(source));
+		for (int k = 1; k < KAISER_TAPS; k++) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(source + k * 4)));
+		}
+		_mm_storeu_ps(out + x * 4, sum);
+	}
+}
+
+// Dois pixels RGBA (low na metade baixa, high na alta).
+CPU_TARGET_AVX2 static inline __m256 load_pixel_pair(const float* low, const float* high) {
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)), _mm_loadu_ps(high), 1);
+}
+
+CPU_TARGET_AVX2 static uint32_t kaiser_row_avx2(const float* in, float* out, uint32_t first, uint32_t last,
+												 const float* weights) {
+	uint32_t x = first;
+	for (; x + 2 <= last; x += 2) {
+		// Pixel x na metade baixa e x + 1 na alta (amostras deslocadas em 2 pixels de origem).
+		const float* source = in + (x * 2 - 2) * 4;
+		__m256 sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), load_pixel_pair(source, source + 8));
+		for (int k = 1; k < KAISER_TAPS; k++) {
+			__m256 samples = load_pixel_pair(source + k * 4, source + 8 + k * 4);
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), samples));
+		}
+		_mm256_storeu_ps(out + x * 4, sum);
+	}
+	return x;
+}
+
+static uint32_t kaiser_column_sse2(const float* const* rows, float* out, uint32_t first, uint32_t count,
+								   const float* weights) {
+	uint32_t i = first;
+	for (; i + 4 <= count; i += 4) {
+		__m128 sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(rows[0] + i));
+		for (int k = 1; k < KAISER_TAPS; k++) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[k]), _mm_loadu_ps(rows[k] + i)));
+		}
+		_mm_storeu_ps(out + i, sum);
+	}
+	return i;
+}
+
+CPU_TARGET_AVX2 static uint32_t kaiser_column_avx2(const float* const* rows, float* out, uint32_t count,
+													const float* weights) {
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), _mm256_loadu_ps(rows[0] + i));
+		for (int k = 1; k < KAISER_TAPS; k++) {
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[k]), _mm256_loadu_ps(rows[k] + i)));
+		}
+		_mm256_storeu_ps(out + i, sum);
+	}
+	return i;
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Conversões sRGB
+
+static float srgb_to_linear(float value) {
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float linear_to_srgb(float value) {
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+// Tabelas de conversão (8 bits -> linear e linear em 16 bits -> 8 bits), montadas uma vez. fromLinear tem 3 bytes a
+// mais para que as leituras de 32 bits do gather (AVX2) no último índice não passem do fim.
+struct SrgbTables {
+	float toLinear[256];
+	uint8_t fromLinear[65536 + 3] = {};
+
+	SrgbTables() {
+		for (int i = 0; i < 256; i++) {
+			toLinear[i] = srgb_to_linear(i / 255.0f);
+		}
+		for (int i = 0; i < 65536; i++) {
+			fromLinear[i] = (uint8_t)std::lround(linear_to_srgb(i / 65535.0f) * 255.0f);
+		}
+	}
+};
+
+static const SrgbTables& srgb_tables() {
+	static const SrgbTables tables;
+	return tables;
+}
+
+// Bytes RGBA para floats (cores pela tabela com srgb, alfa sempre / 255). As versões vetorizadas processam os primeiros
+// pixels e retornam quantos processaram, com os mesmos resultados da escalar.
+static void decode_pixels_scalar(const uint8_t* pixels, size_t first, size_t last, bool srgb, float* out) {
+	const SrgbTables& tables = srgb_tables();
+	for (size_t i = first; i < last; i++) {
+		for (int c = 0; c < 3; c++) {
+			out[i * 4 + c] = srgb ? tables.toLinear[pixels[i * 4 + c]] : pixels[i * 4 + c] / 255.0f;
+		}
+		out[i * 4 + 3] = pixels[i * 4 + 3] / 255.0f;
+	}
+}
+
+// Floats RGBA para bytes (cores pela tabela de 16 bits com srgb, alfa sempre em unorm).
+static uint8_t encode_unorm(float value) {
+	return (uint8_t)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+static void encode_pixels_scalar(const float* in, size_t first, size_t last, bool srgb, uint8_t* out) {
+	const SrgbTables& tables = srgb_tables();
+	for (size_t i = first; i < last; i++) {
+		for (int c = 0; c < 3; c++) {
+			float value = in[i * 4 + c];
+			if (srgb) {
+				float clamped = std::min(std::max(value, 0.0f), 1.0f);
+				out[i * 4 + c] = tables.fromLinear[(int)(clamped * 65535.0f + 0.5f)];
+			} else {
+				out[i * 4 + c] = encode_unorm(value);
+			}
+		}
+		out[i * 4 + 3] = encode_unorm(in[i * 4 + 3]);
+	}
+}
+
+#ifdef CPU_X86
+// Sem gather no SSE2: a divisão e os índices das tabelas são vetoriais, as leituras das tabelas uma a uma.
+static size_t decode_pixels_sse2(const uint8_t* pixels, size_t count, bool srgb, float* out) {
+	const float* toLinear = srgb_tables().toLinear;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(255.0f);
+	for (size_t i = 0; i < count; i++) {
+		int packed;
+		memcpy(&packed, pixels + i * 4, 4);
+		__m128i bytes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+		__m128 unorm = _mm_div_ps(_mm_cvtepi32_ps(bytes), scale);
+		if (srgb) {
+			// Alfa da divisão na quarta posição, cores da tabela nas três primeiras.
+			const uint8_t* pixel = pixels + i * 4;
+			__m128 alpha = _mm_shuffle_ps(unorm, unorm, _MM_SHUFFLE(3, 3, 3, 3));
+			__m128 colors = _mm_setr_ps(toLinear[pixel[0]], toLinear[pixel[1]], toLinear[pixel[2]], 0.0f);
+			__m128 alphaMask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+			unorm = _mm_or_ps(_mm_andnot_ps(alphaMask, colors), _mm_and_ps(alphaMask, alpha));
+		}
+		_mm_storeu_ps(out + i * 4, unorm);
+	}
+	return count;
+}
+
+static size_t encode_pixels_sse2(const float* in, size_t count, bool srgb, uint8_t* out) {
+	const uint8_t* fromLinear = srgb_tables().fromLinear;
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f);
+	const __m128 unormScale = _mm_set1_ps(255.0f), tableScale = _mm_set1_ps(65535.0f);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128i unorm[4], index[4];
+		for (int p = 0; p < 4; p++) {
+			__m128 clamped = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + (i + p) * 4), zero), one);
+			unorm[p] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, unormScale), half));
+			index[p] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(clamped, tableScale), half));
+		}
+		// 16 valores de 0 a 255 empacotados em bytes, na ordem dos pixels.
+		__m128i bytes =
+			_mm_packus_epi16(_mm_packs_epi32(unorm[0], unorm[1]), _mm_packs_epi32(unorm[2], unorm[3]));
+		_mm_storeu_si128((__m128i*)(out + i * 4), bytes);
+		if (srgb) {
+			alignas(16) int32_t indices[16];
+			for (int p = 0; p < 4; p++) {
+				_mm_store_si128((__m128i*)(indices + p * 4), index[p]);
+			}
+			for (int p = 0; p < 4; p++) {
+				for (int c = 0; c < 3; c++) {
+					out[(i + p) * 4 + c] = fromLinear[indices[p * 4 + c]];
+				}
+			}
+		}
+	}
+	return i;
+}
+
+// O AVX2 lê as tabelas com gather: 2 pixels (8 canais) por registrador.
+CPU_TARGET_AVX2 static size_t decode_pixels_avx2(const uint8_t* pixels, size_t count, bool srgb, float* out) {
+	const float* toLinear = srgb_tables().toLinear;
+	const __m256 scale = _mm256_set1_ps(255.0f);
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		__m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(pixels + i * 4)));
+		__m256 unorm = _mm256_div_ps(_mm256_cvtepi32_ps(bytes), scale);
+		if (srgb) {
+			// Alfas (posições 3 e 7) da divisão, cores da tabela.
+			unorm = _mm256_blend_ps(_mm256_i32gather_ps(toLinear, bytes, 4), unorm, 0x88);
+		}
+		_mm256_storeu_ps(out + i * 4, unorm);
+	}
+	return i;
+}
+
+CPU_TARGET_AVX2 static size_t encode_pixels_avx2(const float* in, size_t count, bool srgb, uint8_t* out) {
+	const int* fromLinear = (const int*)srgb_tables().fromLinear;
+	const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), half = _mm256_set1_ps(0.5f);
+	const __m256 unormScale = _mm256_set1_ps(255.0f), tableScale = _mm256_set1_ps(65535.0f);
+	const __m256i lowByte = _mm256_set1_epi32(0xFF);
+	// Depois dos dois empacotamentos (feitos em cada metade), os pixels 0 1 ficam no dword 0, 2 3 no 1, 4 5 no 4 e 6 7
+	// no 5.
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m256i values[2];
+		for (int h = 0; h < 2; h++) {
+			__m256 clamped = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + (i + h * 2) * 4), zero), one);
+			values[h] = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, unormScale), half));
+			if (srgb) {
+				__m256i index = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, tableScale), half));
+				__m256i colors = _mm256_and_si256(_mm256_i32gather_epi32(fromLinear, index, 1), lowByte);
+				values[h] = _mm256_blend_epi32(colors, values[h], 0x88);
+			}
+		}
+		__m256i words = _mm256_packs_epi32(values[0], values[1]);
+		__m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(words, words), order);
+		_mm_storeu_si128((__m128i*)(out + i * 4), _mm256_castsi256_si128(bytes));
+	}
+	return i;
+}
+#endif
+
+static void decode_pixels(const uint8_t* pixels, size_t count, bool srgb, float* out, MipSimd simd) {
+	size_t done = 0;
+#ifdef CPU_X86
+	if (simd == MIP_SIMD_AVX2) {
+		done = decode_pixels_avx2(pixels, count, srgb, out);
+	}
+	if (simd >= MIP_SIMD_SSE2) {
+		done += decode_pixels_sse2(pixels + done * 4, count - done, srgb, out + done * 4);
+	}
+#endif
+	decode_pixels_scalar(pixels, done, count, srgb, out);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Níveis em ponto flutuante
+
+// Nível de origem dos filtros: o nível anterior em floats ou, no nível 0, os bytes, decodificados linha a linha quando
+// o filtro os lê (sem a cópia do nível 0 inteiro em floats, que custa mais que a filtragem).
+struct FloatSource {
+	const float* floats;  // nullptr no nível 0
+	const uint8_t* pixels;
+	uint32_t width, height;
+	bool srgb;
+	MipSimd simd;
+
+	// Linha y em floats; buffer guarda a linha decodificada.
+	const float* row(uint32_t y, std::vector<float>& buffer) const {
+		if (floats) {
+			return floats + (size_t)y * width * 4;
+		}
+		buffer.resize((size_t)width * 4);
+		decode_pixels(pixels + (size_t)y * width * 4, width, srgb, buffer.data(), simd);
+		return buffer.data();
+	}
+};
+
+static void box_f32_level(const FloatSource& source, float* out, uint32_t width, uint32_t height, ThreadPool* pool) {
+	uint32_t sourceWidth = source.width, sourceHeight = source.height;
+	MipSimd simd = source.simd;
+	uint32_t paired = std::min(width, sourceWidth / 2);
+	for_each_band(pool, height, [&](uint32_t first, uint32_t last) {
+		std::vector<float> buffers[2];
+		for (uint32_t y = first; y < last; y++) {
+			const float* row0 = source.row(std::min(y * 2, sourceHeight - 1), buffers[0]);
+			const float* row1 = source.row(std::min(y * 2 + 1, sourceHeight - 1), buffers[1]);
+			float* row = out + (size_t)y * width * 4;
+			uint32_t done = 0;
+#ifdef CPU_X86
+			if (simd == MIP_SIMD_AVX2) {
+				done = box_f32_row_avx2(row0, row1, paired, row);
+			}
+			if (simd >= MIP_SIMD_SSE2) {
+				done += box_f32_row_sse2(row0 + done * 8, row1 + done * 8, paired - done, row + done * 4);
+			}
+#endif
+			box_f32_row_scalar(row0, row1, sourceWidth, row, done, width);
+		}
+	});
+}
+
+static void kaiser_f32_level(const FloatSource& source, float* out, uint32_t width, uint32_t height, ThreadPool* pool,
+							 std::vector<float>& scratch) {
+	uint32_t sourceWidth = source.width, sourceHeight = source.height;
+	MipSimd simd = source.simd;
+	float weights[KAISER_TAPS];
+	kaiser_weights(weights);
+
+	// Passo horizontal para todas as linhas de origem.
+	scratch.resize((size_t)width * sourceHeight * 4);
+	float* horizontal = scratch.data();
+	// Pixels de saída cujas 6 amostras estão dentro da linha: 2x - 2 >= 0 e 2x + 3 < sourceWidth.
+	uint32_t inner0 = std::min<uint32_t>(1, width);
+	uint32_t inner1 = sourceWidth >= 4 ? std::max(inner0, std::min(width, (sourceWidth - 4) / 2 + 1)) : inner0;
+	for_each_band(pool, sourceHeight, [&](uint32_t first, uint32_t last) {
+		std::vector<float> buffer;
+		for (uint32_t y = first; y < last; y++) {
+			const float* row = source.row(y, buffer);
+			float* target = horizontal + (size_t)y * width * 4;
+			uint32_t done = inner0;
+#ifdef CPU_X86
+			if (simd == MIP_SIMD_AVX2) {
+				done = kaiser_row_avx2(row, target, done, inner1, weights);
+			}
+			if (simd >= MIP_SIMD_SSE2) {
+				kaiser_row_sse2(row, target, done, inner1, weights);
+				done = inner1;
+			}
+#endif
+			kaiser_row_scalar(row, sourceWidth, target, 0, inner0, weights);
+			kaiser_row_scalar(row, sourceWidth, target, done, width, weights);
+		}
+	});
+
+	// Passo vertical.
+	uint32_t count = width * 4;
+	for_each_band(pool, height, [&](uint32_t first, uint32_t last) {
+		for (uint32_t y = first; y < last; y++) {
+			const float* rows[KAISER_TAPS];
+			for (int k = 0; k < KAISER_TAPS; k++) {
+				int s = std::min(std::max((int)(y * 2) - 2 + k, 0), (int)sourceHeight - 1);
+				rows[k] = horizontal + (size_t)s * count;
+			}
+			float* target = out + (size_t)y * count;
+			uint32_t done = 0;
+#ifdef CPU_X86
+			if (simd == MIP_SIMD_AVX2) {
+				done = kaiser_column_avx2(rows, target, count, weights);
+			}
+			if (simd >= MIP_SIMD_SSE2) {
+				done = kaiser_column_sse2(rows, target, done, count, weights);
+			}
+#endif
+			kaiser_column_scalar(rows, target, done, count, weights);
+		}
+	});
+}
+
+static void encode_level(const float* in, uint32_t width, uint32_t height, bool srgb, uint8_t* out, MipSimd simd,
+						 ThreadPool* pool) {
+	for_each_band(pool, height, [&](uint32_t first, uint32_t last) {
+		size_t begin = (size_t)first * width, count = (size_t)(last - first) * width;
+		size_t done = 0;
+#ifdef CPU_X86
+		if (simd == MIP_SIMD_AVX2) {
+			done = encode_pixels_avx2(in + begin * 4, count, srgb, out + begin * 4);
+		}
+		if (simd >= MIP_SIMD_SSE2) {
+			done += encode_pixels_sse2(in + (begin + done) * 4, count - done, srgb, out + (begin + done) * 4);
+		}
+#endif
+		encode_pixels_scalar(in, begin + done, begin + count, srgb, out);
+	});
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+void build_mip_chain(const uint8_t* pixels, uint32_t width, uint32_t height, int channels, TextureData& texture,
+					 const MipOptions& options) {
+	MipSimd supported = mip_simd_supported();
+	MipSimd simd = options.simd == MIP_SIMD_AUTO ? supported : std::min(options.simd, supported);
+
+	texture.format = TEXTURE_RGBA8;
+	texture.width = width;
+	texture.height = height;
+	texture.levels.clear();
+	uint64_t total = 0;
+	for (uint32_t w = width, h = height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2)) {
+		TextureLevel level = {total, (uint64_t)w * h * 4, w, h};
+		texture.levels.push_back(level);
+		total = align16(total + level.size);
+		if (w == 1 && h == 1) {
+			break;
+		}
+	}
+	texture.data.assign(total, 0);
+
+	// Nível 0: cópia dos pixels, completando o alfa das imagens RGB.
+	uint8_t* level0 = texture.data.data();
+	size_t count = (size_t)width * height;
+	if (channels == 4) {
+		memcpy(level0, pixels, count * 4);
+	} else {
+		for (size_t i = 0; i < count; i++) {
+			level0[i * 4 + 0] = pixels[i * 3 + 0];
+			level0[i * 4 + 1] = pixels[i * 3 + 1];
+			level0[i * 4 + 2] = pixels[i * 3 + 2];
+			level0[i * 4 + 3] = 255;
+		}
+	}
+
+	if (options.filter == MIP_FILTER_BOX && !options.srgb) {
+		for (size_t i = 1; i < texture.levels.size(); i++) {
+			const TextureLevel& source = texture.levels[i - 1];
+			const TextureLevel& target = texture.levels[i];
+			box_u8_level(source, &texture.data[source.offset], target, &texture.data[target.offset], simd,
+						 options.pool);
+		}
+		return;
+	}
+
+	// Caminho em ponto flutuante: cada nível é filtrado a partir do anterior, mantido em float para não acumular
+	// arredondamentos, e gravado em 8 bits.
+	// O nível 0 é decodificado pelo próprio filtro, linha a linha.
+	std::vector<float> current, next, scratch;
+	for (size_t i = 1; i < texture.levels.size(); i++) {
+		const TextureLevel& level = texture.levels[i - 1];
+		const TextureLevel& target = texture.levels[i];
+		FloatSource source = {i == 1 ? nullptr : current.data(), level0, level.width, level.height, options.srgb, simd};
+		next.resize((size_t)target.width * target.height * 4);
+		if (options.filter == MIP_FILTER_KAISER) {
+			kaiser_f32_level(source, next.data(), target.width, target.height, options.pool, scratch);
+		} else {
+			box_f32_level(source, next.data(), target.width, target.height, options.pool);
+		}
+		encode_level(next.data(), target.width, target.height, options.srgb, &texture.data[target.offset], simd,
+					 options.pool);
+		current.swap(next);
+	}
+}
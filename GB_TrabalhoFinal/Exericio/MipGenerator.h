@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+
+#include "TextureFile.h"
+#include "ThreadPool.h"
+
+// Geração da cadeia de mipmaps RGBA8 na CPU, com caminhos vetorizados (SSE2 e AVX2, escolhidos em tempo de execução)
+// e um escalar equivalente (usado também em processadores que não são x86, como o M1).
+// - Caixa 2x2 em espaço linear: mesmo resultado, bit a bit, de build_rgba8_mip_chain, em inteiros de 16 bits.
+// - Caixa 2x2 ou Kaiser (sinc janelado, 6 amostras por eixo) em ponto flutuante: com srgb, as cores são filtradas em
+//   luz linear (o alfa não tem gama), sem escurecer as bordas entre regiões claras e escuras.
+// Com um pool, cada nível é dividido em faixas de linhas processadas em paralelo.
+
+enum MipFilter {
+	MIP_FILTER_BOX,
+	MIP_FILTER_KAISER,
+};
+
+enum MipSimd {
+	MIP_SIMD_AUTO,	// o melhor disponível no processador
+	MIP_SIMD_SCALAR,
+	MIP_SIMD_SSE2,
+	MIP_SIMD_AVX2,
+};
+
+struct MipOptions {
+	MipFilter filter = MIP_FILTER_BOX;
+	bool srgb = true;
+	MipSimd simd = MIP_SIMD_AUTO;
+	ThreadPool* pool = nullptr;
+};
+
+// Melhor conjunto de instruções disponível (nunca MIP_SIMD_AUTO) e o seu nome.
+MipSimd mip_simd_supported();
+const char* mip_simd_name(MipSimd simd);
+
+// Gera a cadeia completa a partir dos pixels do nível 0 (channels = 3 ou 4, como retornado pelo stb_image).
+// Um simd não suportado pelo processador é rebaixado para o melhor suportado.
+void build_mip_chain(const uint8_t* pixels, uint32_t width, uint32_t height, int channels, TextureData& texture,
+					 const MipOptions& options = MipOptions());
@@ -0,0 +1,556 @@
+#include "ObjLoader.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "MappedFile.h"
+
+// Potências de 10 representáveis exatamente em double.
+static const double POW10[] = {1e0,	 1e1,  1e2,	 1e3,  1e4,	 1e5,  1e6,	 1e7,  1e8,	 1e9,  1e10, 1e11,
+							   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+static inline bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+static inline void skip_blanks(const char*& p, const char* end) {
+	while (p < end && is_blank(*p)) {
+		p++;
+	}
+}
+
+static inline void skip_line(const char*& p, const char* end) {
+	const char* newline = (const char*)memchr(p, '\n', end - p);
+	p = newline ? newline + 1 : end;
+}
+
+// Lê um número em ponto flutuante a partir de p, avançando o ponteiro.
+// Números com até 15 dígitos significativos e expoente pequeno (caso de todos os OBJ exportados pelo Blender) são
+// convertidos com uma única operação em double; os demais caem no strtod sobre uma cópia na pilha.
+static bool parse_float(const char*& p, const char* end, float& out) {
+	const char* start = p;
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+
+	uint64_t mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool any = false;
+	while (p < end && is_digit(*p)) {
+		any = true;
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa != 0) digits++;
+		} else {
+			exponent++;
+		}
+		p++;
+	}
+	if (p < end && *p == '.') {
+		p++;
+		while (p < end && is_digit(*p)) {
+			any = true;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa != 0) digits++;
+				exponent--;
+			}
+			p++;
+		}
+	}
+	if (!any) {
+		p = start;
+		return false;
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		const char* q = p + 1;
+		bool negativeExponent = false;
+		if (q < end && (*q == '-' || *q == '+')) {
+			negativeExponent = *q == '-';
+			q++;
+		}
+		if (q < end && is_digit(*q)) {
+			int e = 0;
+			while (q < end && is_digit(*q)) {
+				if (e < 10000) e = e * 10 + (*q - '0');
+				q++;
+			}
+			exponent += negativeExponent ? -e : e;
+			p = q;
+		}
+	}
+
+	double value;
+	if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+		value = (double)mantissa;
+		value = exponent < 0 ? value / POW10[-exponent] : value * POW10[exponent];
+	} else {
+		char buffer[64];
+		size_t length = (size_t)(p - start);
+		if (length >= sizeof(buffer)) length = sizeof(buffer) - 1;
+		memcpy(buffer, start, length);
+		buffer[length] = '\0';
+		value = strtod(buffer, nullptr);
+		negative = false;
+	}
+	out = (float)(negative ? -value : value);
+	return true;
+}
+
+static inline bool parse_int(const char*& p, const char* end, int& out) {
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+')) {
+		negative = *p == '-';
+		p++;
+	}
+	if (p >= end || !is_digit(*p)) {
+		return false;
+	}
+	int value = 0;
+	while (p < end && is_digit(*p)) {
+		value = value * 10 + (*p - '0');
+		p++;
+	}
+	out = negative ? -value : value;
+	return true;
+}
+
+// Converte um índice OBJ (base 1, negativo = relativo ao fim da lista) para base 0.
+static inline int resolve_index(int index, size_t count) {
+	if (index > 0) return index - 1;
+	if (index < 0) return (int)count + index;
+	return -1;
+}
+
+// Lê até n floats da linha; os ausentes ficam com zero.
+static inline void parse_floats(const char*& p, const char* end, std::vector<float>& out, int n) {
+	for (int i = 0; i < n; i++) {
+		skip_blanks(p, end);
+		float value = 0.0f;
+		parse_float(p, end, value);
+		out.push_back(value);
+	}
+}
+
+// Canto de face lido de uma linha "f". relativeMask marca (bits 0, 1 e 2 para v, vt e vn) os índices negativos, que
+// foram resolvidos em relação às listas do trecho sendo lido e precisam ser corrigidos na junção do modo paralelo.
+struct ParsedCorner {
+	ObjIndex index;
+	unsigned relativeMask;
+};
+
+// Lê um canto de face no formato v, v/vt, v//vn ou v/vt/vn.
+static bool parse_corner(const char*& p, const char* end, const ObjData& data, ParsedCorner& corner) {
+	int index;
+	if (!parse_int(p, end, index)) {
+		return false;
+	}
+	corner.index.v = resolve_index(index, data.positions.size() / 3);
+	corner.index.vt = -1;
+	corner.index.vn = -1;
+	corner.relativeMask = index < 0 ? 1 : 0;
+	if (p < end && *p == '/') {
+		p++;
+		if (parse_int(p, end, index)) {
+			corner.index.vt = resolve_index(index, data.texCoords.size() / 2);
+			corner.relativeMask |= index < 0 ? 2 : 0;
+		}
+		if (p < end && *p == '/') {
+			p++;
+			if (parse_int(p, end, index)) {
+				corner.index.vn = resolve_index(index, data.normals.size() / 3);
+				corner.relativeMask |= index < 0 ? 4 : 0;
+			}
+		}
+	}
+	return true;
+}
+
+static inline void push_corner(const ParsedCorner& corner, ObjData& data, std::vector<uint32_t>* relative) {
+	if (corner.relativeMask != 0 && relative != nullptr) {
+		uint32_t slot = (uint32_t)data.corners.size() * 3;
+		for (uint32_t component = 0; component < 3; component++) {
+			if (corner.relativeMask & (1u << component)) {
+				relative->push_back(slot + component);
+			}
+		}
+	}
+	data.corners.push_back(corner.index);
+}
+
+static void parse_face(const char*& p, const char* end, ObjData& data, std::vector<uint32_t>* relative) {
+	ParsedCorner first, previous, current;
+	int count = 0;
+	while (true) {
+		skip_blanks(p, end);
+		if (!parse_corner(p, end, data, current)) {
+			break;
+		}
+		if (count == 0) {
+			first = current;
+		} else if (count >= 2) {
+			push_corner(first, data, relative);
+			push_corner(previous, data, relative);
+			push_corner(current, data, relative);
+		}
+		previous = current;
+		count++;
+	}
+}
+
+// Lê o restante da linha (sem os espaços nas pontas), como o nome de um arquivo ou material.
+static void parse_name(const char*& p, const char* end, std::string& out) {
+	skip_blanks(p, end);
+	const char* nameEnd = p;
+	while (nameEnd < end && *nameEnd != '\n' && *nameEnd != '\r') {
+		nameEnd++;
+	}
+	while (nameEnd > p && is_blank(nameEnd[-1])) {
+		nameEnd--;
+	}
+	out.assign(p, nameEnd);
+}
+
+// Índice do material na lista de nomes, que é incluído se ainda não existir.
+static uint32_t material_index(std::vector<std::string>& names, const std::string& name) {
+	for (size_t i = 0; i < names.size(); i++) {
+		if (names[i] == name) {
+			return (uint32_t)i;
+		}
+	}
+	names.push_back(name);
+	return (uint32_t)names.size() - 1;
+}
+
+// Interpreta [begin, end). Quando relative não é nulo, registra as posições (canto * 3 + componente) dos índices
+// negativos encontrados.
+static void parse_obj_range(const char* begin, const char* end, ObjData& data, std::vector<uint32_t>* relative) {
+	const char* p = begin;
+	while (p < end) {
+		skip_blanks(p, end);
+		if (p + 1 >= end) {
+			break;
+		}
+
+		if (p[0] == 'v') {
+			if (is_blank(p[1])) {
+				p += 2;
+				parse_floats(p, end, data.positions, 3);
+			} else if (p[1] == 't' && p + 2 < end && is_blank(p[2])) {
+				p += 3;
+				parse_floats(p, end, data.texCoords, 2);
+			} else if (p[1] == 'n' && p + 2 < end && is_blank(p[2])) {
+				p += 3;
+				parse_floats(p, end, data.normals, 3);
+			}
+		} else if (p[0] == 'f' && is_blank(p[1])) {
+			p += 2;
+			parse_face(p, end, data, relative);
+		} else if (end - p > 7 && memcmp(p, "usemtl", 6) == 0 && is_blank(p[6])) {
+			p += 7;
+			std::string name;
+			parse_name(p, end, name);
+			ObjMaterialRange range = {(uint32_t)data.corners.size(), material_index(data.materialNames, name)};
+			data.materialRanges.push_back(range);
+		} else if (data.mtllib.empty() && end - p > 7 && memcmp(p, "mtllib", 6) == 0 && is_blank(p[6])) {
+			p += 7;
+			parse_name(p, end, data.mtllib);
+		}
+
+		skip_line(p, end);
+	}
+}
+
+void parse_obj(const char* begin, const char* end, ObjData& data) { parse_obj_range(begin, end, data, nullptr); }
+
+// Trecho do arquivo lido por uma tarefa do modo paralelo.
+struct ObjChunk {
+	const char* begin;
+	const char* end;
+	ObjData data;
+	std::vector<uint32_t> relative;
+	size_t positionBase, texCoordBase, normalBase, cornerBase;
+};
+
+void parse_obj_parallel(const char* begin, const char* end, ObjData& data, ThreadPool& pool) {
+	size_t size = (size_t)(end - begin);
+	size_t nChunks = std::min<size_t>((size_t)pool.size() * 4, size / OBJ_PARALLEL_MIN_CHUNK);
+	if (nChunks <= 1) {
+		parse_obj(begin, end, data);
+		return;
+	}
+
+	// Divide o arquivo em trechos de tamanho parecido, sempre terminando em fim de linha.
+	std::vector<ObjChunk> chunks(nChunks);
+	const char* chunkBegin = begin;
+	for (size_t i = 0; i < nChunks; i++) {
+		const char* chunkEnd = i + 1 == nChunks ? end : begin + size * (i + 1) / nChunks;
+		if (chunkEnd < chunkBegin) {
+			chunkEnd = chunkBegin;
+		}
+		if (chunkEnd < end) {
+			const char* newline = (const char*)memchr(chunkEnd, '\n', end - chunkEnd);
+			chunkEnd = newline ? newline + 1 : end;
+		}
+		chunks[i].begin = chunkBegin;
+		chunks[i].end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	pool.parallelFor((int)nChunks, [&](int i) {
+		ObjChunk& chunk = chunks[i];
+		parse_obj_range(chunk.begin, chunk.end, chunk.data, &chunk.relative);
+	});
+
+	// Deslocamento de cada trecho nas listas globais.
+	size_t nPositions = 0, nTexCoords = 0, nNormals = 0, nCorners = 0;
+	for (ObjChunk& chunk : chunks) {
+		chunk.positionBase = nPositions;
+		chunk.texCoordBase = nTexCoords;
+		chunk.normalBase = nNormals;
+		chunk.cornerBase = nCorners;
+		nPositions += chunk.data.positions.size();
+		nTexCoords += chunk.data.texCoords.size();
+		nNormals += chunk.data.normals.size();
+		nCorners += chunk.data.corners.size();
+		if (data.mtllib.empty()) {
+			data.mtllib = chunk.data.mtllib;
+		}
+
+		// Faixas de material: os índices locais do trecho passam para a lista global de nomes.
+		for (const ObjMaterialRange& local : chunk.data.materialRanges) {
+			ObjMaterialRange range = {local.firstCorner + (uint32_t)chunk.cornerBase,
+									  material_index(data.materialNames, chunk.data.materialNames[local.materialId])};
+			data.materialRanges.push_back(range);
+		}
+	}
+	data.positions.resize(nPositions);
+	data.texCoords.resize(nTexCoords);
+	data.normals.resize(nNormals);
+	data.corners.resize(nCorners);
+
+	// Junta os trechos, corrigindo os índices negativos com o deslocamento global do trecho.
+	pool.parallelFor((int)nChunks, [&](int i) {
+		ObjChunk& chunk = chunks[i];
+		std::copy(chunk.data.positions.begin(), chunk.data.positions.end(),
+				  data.positions.begin() + chunk.positionBase);
+		std::copy(chunk.data.texCoords.begin(), chunk.data.texCoords.end(),
+				  data.texCoords.begin() + chunk.texCoordBase);
+		std::copy(chunk.data.normals.begin(), chunk.data.normals.end(), data.normals.begin() + chunk.normalBase);
+
+		ObjIndex* corners = data.corners.data() + chunk.cornerBase;
+		std::copy(chunk.data.corners.begin(), chunk.data.corners.end(), corners);
+		const int bases[3] = {(int)chunk.positionBase / 3, (int)chunk.texCoordBase / 2, (int)chunk.normalBase / 3};
+		for (uint32_t slot : chunk.relative) {
+			int& index = (&corners[slot / 3].v)[slot % 3];
+			index += bases[slot % 3];
+		}
+	});
+}
+
+void group_corners_by_material(ObjData& data) {
+	if (data.materialRanges.empty()) {
+		return;
+	}
+
+	// Material de cada triângulo; MATERIAL_NONE ocupa a chave materialNames.size().
+	size_t triangleCount = data.corners.size() / 3;
+	uint32_t noneKey = (uint32_t)data.materialNames.size();
+	std::vector<uint32_t> keys(triangleCount, noneKey);
+	for (size_t i = 0; i < data.materialRanges.size(); i++) {
+		const ObjMaterialRange& range = data.materialRanges[i];
+		size_t first = range.firstCorner / 3;
+		size_t last = i + 1 < data.materialRanges.size() ? data.materialRanges[i + 1].firstCorner / 3 : triangleCount;
+		uint32_t key = range.materialId == MATERIAL_NONE ? noneKey : range.materialId;
+		std::fill(keys.begin() + first, keys.begin() + std::max(first, last), key);
+	}
+
+	// Ordem das faixas: primeiro uso de cada material.
+	std::vector<uint32_t> count(noneKey + 1, 0);
+	std::vector<uint32_t> order;
+	for (uint32_t key : keys) {
+		if (count[key]++ == 0) {
+			order.push_back(key);
+		}
+	}
+
+	// Ordenação por contagem, estável dentro de cada material.
+	std::vector<uint32_t> start(noneKey + 1, 0);
+	std::vector<ObjMaterialRange> ranges;
+	uint32_t position = 0;
+	for (uint32_t key : order) {
+		start[key] = position;
+		ranges.push_back({position * 3, key == noneKey ? MATERIAL_NONE : key});
+		position += count[key];
+	}
+	if (order.size() > 1) {
+		std::vector<ObjIndex> corners(data.corners.size());
+		for (size_t t = 0; t < triangleCount; t++) {
+			memcpy(&corners[(size_t)start[keys[t]]++ * 3], &data.corners[t * 3], 3 * sizeof(ObjIndex));
+		}
+		data.corners.swap(corners);
+	}
+	data.materialRanges.swap(ranges);
+}
+
+void build_submeshes(const ObjData& data, std::vector<Submesh>& submeshes) {
+	submeshes.clear();
+	uint32_t cornerCount = (uint32_t)data.corners.size();
+	uint32_t first = 0;
+	uint32_t materialId = MATERIAL_NONE;
+	for (size_t i = 0; i <= data.materialRanges.size(); i++) {
+		uint32_t last = i < data.materialRanges.size() ? data.materialRanges[i].firstCorner : cornerCount;
+		if (last > first) {
+			submeshes.push_back({first, last - first, materialId, 0});
+		}
+		if (i < data.materialRanges.size()) {
+			first = std::max(first, last);
+			materialId = data.materialRanges[i].materialId;
+		}
+	}
+}
+
+bool load_obj(const std::string& filepath, ObjData& data, ThreadPool* pool) {
+	data.clear();
+
+	MappedFile file;
+	if (!file.open(filepath)) {
+		return false;
+	}
+
+	if (pool != nullptr && pool->size() > 1) {
+		parse_obj_parallel(file.data(), file.data() + file.size(), data, *pool);
+	} else {
+		parse_obj(file.data(), file.data() + file.size(), data);
+	}
+	group_corners_by_material(data);
+	return true;
+}
+
+// Escreve os 11 floats (posição, cor, coordenada de textura e normal) de um canto de face em out.
+static inline void write_vertex(const ObjData& data, const ObjIndex& corner, glm::vec3 color, float* out) {
+	if (corner.v >= 0 && (size_t)corner.v * 3 < data.positions.size()) {
+		memcpy(out, &data.positions[corner.v * 3], 3 * sizeof(float));
+	} else {
+		out[0] = out[1] = out[2] = 0.0f;
+	}
+	out[3] = color.r;
+	out[4] = color.g;
+	out[5] = color.b;
+	if (corner.vt >= 0 && (size_t)corner.vt * 2 < data.texCoords.size()) {
+		memcpy(out + 6, &data.texCoords[corner.vt * 2], 2 * sizeof(float));
+	} else {
+		out[6] = out[7] = 0.0f;
+	}
+	if (corner.vn >= 0 && (size_t)corner.vn * 3 < data.normals.size()) {
+		memcpy(out + 8, &data.normals[corner.vn * 3], 3 * sizeof(float));
+	} else {
+		out[8] = out[9] = out[10] = 0.0f;
+	}
+}
+
+void build_vertex_buffer(const ObjData& data, glm::vec3 color, std::vector<float>& vbuffer) {
+	vbuffer.resize(data.corners.size() * 11);
+	float* out = vbuffer.data();
+	for (const ObjIndex& corner : data.corners) {
+		write_vertex(data, corner, color, out);
+		out += 11;
+	}
+}
+
+static inline uint32_t hash_corner(const ObjIndex& corner) {
+	uint32_t h = (uint32_t)corner.v * 0x9E3779B1u;
+	h ^= (uint32_t)corner.vt * 0x85EBCA77u + (h << 6) + (h >> 2);
+	h ^= (uint32_t)corner.vn * 0xC2B2AE3Du + (h << 6) + (h >> 2);
+	return h ^ (h >> 15);
+}
+
+// Unifica as trincas (v, vt, vn) iguais: unique recebe uma trinca por vértice e indices o vértice de cada canto.
+static void index_corners(const ObjData& data, std::vector<ObjIndex>& unique, std::vector<uint32_t>& indices) {
+	// Tabela de espalhamento com endereçamento aberto: slot guarda (vértice único + 1), 0 = vazio.
+	size_t capacity = 16;
+	while (capacity < data.corners.size() * 2) {
+		capacity <<= 1;
+	}
+	std::vector<uint32_t> slots(capacity, 0);
+	unique.clear();
+	unique.reserve(data.corners.size() / 2);
+
+	indices.resize(data.corners.size());
+	for (size_t i = 0; i < data.corners.size(); i++) {
+		const ObjIndex& corner = data.corners[i];
+		size_t slot = hash_corner(corner) & (capacity - 1);
+		while (true) {
+			uint32_t entry = slots[slot];
+			if (entry == 0) {
+				unique.push_back(corner);
+				slots[slot] = (uint32_t)unique.size();
+				indices[i] = (uint32_t)unique.size() - 1;
+				break;
+			}
+			const ObjIndex& other = unique[entry - 1];
+			if (other.v == corner.v && other.vt == corner.vt && other.vn == corner.vn) {
+				indices[i] = entry - 1;
+				break;
+			}
+			slot = (slot + 1) & (capacity - 1);
+		}
+	}
+}
+
+void build_indexed_vertex_buffer(const ObjData& data, glm::vec3 color, std::vector<float>& vertices,
+								 std::vector<uint32_t>& indices) {
+	std::vector<ObjIndex> unique;
+	index_corners(data, unique, indices);
+
+	vertices.resize(unique.size() * 11);
+	for (size_t i = 0; i < unique.size(); i++) {
+		write_vertex(data, unique[i], color, &vertices[i * 11]);
+	}
+}
+
+void build_mesh_data(const ObjData& data, MeshData& mesh) {
+	std::vector<ObjIndex> unique;
+	index_corners(data, unique, mesh.indices);
+
+	// Posição, coordenada de textura e normal em float (a cor constante não é armazenada).
+	mesh.attributes = {
+		{ATTRIBUTE_POSITION, 3, ATTRIBUTE_FLOAT32, 0, 0},
+		{ATTRIBUTE_TEXCOORD, 2, ATTRIBUTE_FLOAT32, 0, 3 * sizeof(float)},
+		{ATTRIBUTE_NORMAL, 3, ATTRIBUTE_FLOAT32, 0, 5 * sizeof(float)},
+	};
+	mesh.vertexStride = 8 * sizeof(float);
+	mesh.vertexCount = (uint32_t)unique.size();
+	mesh.vertices.resize(unique.size() * mesh.vertexStride);
+
+	float vertex[11];
+	float* out = (float*)mesh.vertices.data();
+	for (const ObjIndex& corner : unique) {
+		write_vertex(data, corner, glm::vec3(0.0f), vertex);
+		memcpy(out, vertex, 3 * sizeof(float));
+		memcpy(out + 3, vertex + 6, 5 * sizeof(float));
+		out += 8;
+	}
+
+	build_submeshes(data, mesh.submeshes);
+	mesh.materialLibrary = data.mtllib;
+	mesh.materialNames = data.materialNames;
+
+	// Caixa envolvente alinhada aos eixos.
+	for (int axis = 0; axis < 3; axis++) {
+		mesh.boundsMin[axis] = unique.empty() ? 0.0f : 3.4e38f;
+		mesh.boundsMax[axis] = unique.empty() ? 0.0f : -3.4e38f;
+	}
+	const float* positions = (const float*)mesh.vertices.data();
+	for (uint32_t i = 0; i < mesh.vertexCount; i++) {
+		for (int axis = 0; axis < 3; axis++) {
+			float value = positions[i * 8 + axis];
+			mesh.boundsMin[axis] = std::min(mesh.boundsMin[axis], value);
+			mesh.boundsMax[axis] = std::max(mesh.boundsMax[axis], value);
+		}
+	}
+}
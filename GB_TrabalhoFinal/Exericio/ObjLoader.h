@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "MeshData.h"
+#include "ThreadPool.h"
+
+// Arquivos menores que isso (por trecho) são lidos em uma única thread.
+const size_t OBJ_PARALLEL_MIN_CHUNK = 256 * 1024;
+
+// Índices (base 0) de posição, coordenada de textura e normal de um canto de face. -1 quando ausente.
+struct ObjIndex {
+	int v;
+	int vt;
+	int vn;
+};
+
+// Início de um trecho de faces desenhado com o mesmo material (linha usemtl).
+struct ObjMaterialRange {
+	uint32_t firstCorner;
+	uint32_t materialId;  // índice em ObjData::materialNames ou MATERIAL_NONE
+};
+
+// Conteúdo de um arquivo OBJ, sem expansão dos vértices.
+// As faces anteriores ao primeiro usemtl não têm material (MATERIAL_NONE). Os grupos o/g não são separados: as faixas
+// seguem apenas os materiais, que é o que muda o estado de desenho.
+struct ObjData {
+	std::vector<float> positions;  // x, y, z
+	std::vector<float> texCoords;  // s, t
+	std::vector<float> normals;	   // x, y, z
+	std::vector<ObjIndex> corners;	// 3 cantos por triângulo (polígonos são triangulados em leque)
+	std::string mtllib;
+	std::vector<std::string> materialNames;	 // na ordem do primeiro usemtl
+	std::vector<ObjMaterialRange> materialRanges;
+
+	void clear() {
+		positions.clear();
+		texCoords.clear();
+		normals.clear();
+		corners.clear();
+		mtllib.clear();
+		materialNames.clear();
+		materialRanges.clear();
+	}
+};
+
+// Interpreta o texto OBJ em [begin, end) diretamente sobre o buffer, sem alocação por linha.
+void parse_obj(const char* begin, const char* end, ObjData& data);
+
+// Versão paralela: divide [begin, end) em trechos terminados em fim de linha, interpreta cada um em uma tarefa do pool
+// e junta os resultados corrigindo os índices. O resultado é idêntico ao de parse_obj.
+void parse_obj_parallel(const char* begin, const char* end, ObjData& data, ThreadPool& pool);
+
+// Reordena os triângulos (de forma estável) para que as faces de cada material fiquem contíguas, deixando uma única
+// faixa por material, na ordem do primeiro uso.
+void group_corners_by_material(ObjData& data);
+
+// Converte as faixas de material em faixas de índices (uma por faixa não vazia, em cantos de face).
+void build_submeshes(const ObjData& data, std::vector<Submesh>& submeshes);
+
+// Mapeia o arquivo em memória e interpreta o seu conteúdo (em paralelo quando um pool é informado), com as faces já
+// agrupadas por material.
+bool load_obj(const std::string& filepath, ObjData& data, ThreadPool* pool = nullptr);
+
+// Gera o buffer intercalado usado pelos shaders (posição, cor, coordenada de textura e normal: 11 floats por vértice).
+void build_vertex_buffer(const ObjData& data, glm::vec3 color, std::vector<float>& vbuffer);
+
+// Versão indexada: cada trinca (v, vt, vn) distinta vira um único vértice e indices recebe 3 índices por triângulo.
+void build_indexed_vertex_buffer(const ObjData& data, glm::vec3 color, std::vector<float>& vertices,
+								 std::vector<uint32_t>& indices);
+
+// Malha indexada com posição, coordenada de textura e normal (8 floats por vértice), faixas de material e caixa
+// envolvente.
+void build_mesh_data(const ObjData& data, MeshData& mesh);
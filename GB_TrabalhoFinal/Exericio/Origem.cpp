@@ -1,8 +1,16 @@
 // Default libs C++.
 #include <assert.h>
 
+#include <chrono>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -22,22 +30,35 @@
 // SHADER.
 #include "Shader.h"
 
+// Configuração.
+#include "AppConfig.h"
+
 // MESH.
+#include "DynamicBvh.h"
+#include "GlStateCache.h"
+#include "Material.h"
 #include "Mesh.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "RenderQueue.h"
+#include "TextureFile.h"
+#include "TextureManager.h"
+#include "TextureStreamer.h"
+#include "TriangleBvh.h"
+#include "UniformBlocks.h"
 
 // Camera.
 #include "Camera.h"
 
-// Libconfig.
-#include <libconfig.h++>
+// Observação de arquivos (recarga durante a execução).
+#include "FileWatcher.h"
 
-// STB_IMAGE.
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+// Medição de tempo de GPU.
+#include "GpuTimer.h"
 
 // USING.
 using namespace std;
-using namespace libconfig;
 
 // Variáveis para câmera.
 Camera camera;
@@ -62,27 +83,17 @@ enum RotationState {
 
 RotationState currentRotationState = ROTATE_NONE;
 
-// Função para ler um arquivo de configuração.
-void read_config(Config& cfg, const string& filename) {
-	try {
-		cfg.readFile(filename.c_str());
-	} catch (const FileIOException& fioex) {
-		cerr << "I/O error while reading file." << endl;
-		exit(EXIT_FAILURE);
-	} catch (const ParseException& pex) {
-		cerr << "Parse error at " << pex.getFile() << ":" << pex.getLine() << " - " << pex.getError() << endl;
-		exit(EXIT_FAILURE);
-	}
-}
+// Seleção com o mouse: o clique registra o ponto da tela (em NDC, [-1, 1]) e o laço principal, que tem a cena e o
+// índice espacial, escolhe o objeto. Com o cursor preso (olhar com o mouse) o clique vale para o centro da tela.
+bool pick_requested = false;
+glm::vec2 pick_point = glm::vec2(0.0f);
 
-// Função para alterar o objeto selecionado.
-void change_selectable_object() {
-	// Lê o valor de selectable_objects_number a partir do arquivo de configuração.
-	Config cfg;
-	read_config(cfg, "config.txt");
-	int selectable_objects_number = cfg.lookup("selectable_objects_number");
-	selected_object_id = (selected_object_id + 1) % selectable_objects_number;
-}
+// Configuração da aplicação (config.txt), relida em segundo plano quando o arquivo muda.
+ConfigStore config_store;
+
+// Texturas lidas no pool de carregamento e enviadas aos poucos, a cada quadro, compartilhadas pelo texture_manager.
+TextureStreamer texture_streamer;
+TextureManager texture_manager;
 
 // Função para movimentação da câmera.
 void handle_camera_movement(int key) {
@@ -145,8 +156,13 @@ void handle_object_movement(int key) {
 // Função para configurar callback de entrada via teclado.
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mode) {
 	if (action == GLFW_PRESS || action == GLFW_REPEAT) {
-		if (key == GLFW_KEY_TAB) {
-			change_selectable_object();
+		// Alt esquerdo solta o cursor (para selecionar objetos fora do centro da tela) ou o prende de novo.
+		if (key == GLFW_KEY_LEFT_ALT) {
+			if (action == GLFW_PRESS) {
+				bool captured = glfwGetInputMode(window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED;
+				glfwSetInputMode(window, GLFW_CURSOR, captured ? GLFW_CURSOR_NORMAL : GLFW_CURSOR_DISABLED);
+				camera.resetMousePosition();
+			}
 			return;
 		}
 
@@ -164,7 +180,32 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 }
 
 // Função para configurar o callback de entrada via mouse.
-void mouse_callback(GLFWwindow* window, double xpos, double ypos) { camera.updateMatrixByMousePosition(xpos, ypos); }
+// Com o cursor solto a câmera não gira.
+void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+	if (glfwGetInputMode(window, GLFW_CURSOR) == GLFW_CURSOR_DISABLED) {
+		camera.updateMatrixByMousePosition(xpos, ypos);
+	}
+}
+
+// Função para configurar o callback dos botões do mouse: o botão esquerdo seleciona o objeto sob o cursor (ou no centro
+// da tela, com o cursor preso); clicar fora dos objetos seleciona a câmera.
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
+	if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS) {
+		return;
+	}
+	int width, height;
+	glfwGetWindowSize(window, &width, &height);
+	if (width <= 0 || height <= 0) {
+		return;
+	}
+	pick_point = glm::vec2(0.0f);
+	if (glfwGetInputMode(window, GLFW_CURSOR) != GLFW_CURSOR_DISABLED) {
+		double x, y;
+		glfwGetCursorPos(window, &x, &y);
+		pick_point = glm::vec2(2.0f * (float)x / width - 1.0f, 1.0f - 2.0f * (float)y / height);
+	}
+	pick_requested = true;
+}
 
 // Função para configurar o callback de entrada via scroll.
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
@@ -177,89 +218,276 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
 	}
 }
 
-// Função para carregar um arquivo obj.
-int load_simple_obj(string filepath, int& nVerts, glm::vec3 color = glm::vec3(1.0, 0.0, 1.0)) {
-	vector<glm::vec3> vertices;
-	vector<GLuint> indices;
-	vector<glm::vec2> texCoords;
-	vector<glm::vec3> normals;
-	vector<GLfloat> vbuffer;
+// Opções de leitura dos arquivos OBJ.
+struct ObjLoadOptions {
+	ThreadPool* pool = nullptr;	 // leitura paralela
+	bool indexed = true;		 // vértices únicos + EBO (caso contrário, vértices expandidos)
+	bool cache = true;			 // usa/grava o cache binário .gbmesh (somente no modo indexado)
+	bool printStats = false;	 // imprime triângulos, vértices e memória de cada malha lida (print_stats)
+};
+
+// Tipo OpenGL correspondente a um tipo de atributo do formato binário.
+GLenum attribute_gl_type(uint32_t type) {
+	switch (type) {
+		case ATTRIBUTE_FLOAT16:
+			return GL_HALF_FLOAT;
+		case ATTRIBUTE_INT_2_10_10_10:
+			return GL_INT_2_10_10_10_REV;
+		case ATTRIBUTE_UINT16:
+			return GL_UNSIGNED_SHORT;
+		case ATTRIBUTE_INT16:
+			return GL_SHORT;
+		case ATTRIBUTE_FLOAT32:
+		default:
+			return GL_FLOAT;
+	}
+}
 
-	ifstream inputFile;
-	inputFile.open(filepath.c_str());
-	if (inputFile.is_open()) {
-		char line[100];
-		string sline;
+// Função para criar o VAO a partir de uma malha em cache: os blocos do arquivo mapeado vão direto para a OpenGL.
+GLuint create_cached_mesh_vao(const MeshCacheFile& cache) {
+	const MeshCacheHeader& header = cache.getHeader();
+	GLuint VBO, EBO, VAO;
 
-		while (!inputFile.eof()) {
-			inputFile.getline(line, 100);
-			sline = line;
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
 
-			string word;
-			istringstream ssline(line);
-			ssline >> word;
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, header.vertexBytes, cache.getVertexData(), GL_STATIC_DRAW);
+
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, header.indexBytes, cache.getIndexData(), GL_STATIC_DRAW);
+
+	// Atributos conforme o descritor gravado no arquivo.
+	const VertexAttribute* attributes = cache.getAttributes();
+	for (uint32_t i = 0; i < header.attributeCount; i++) {
+		const VertexAttribute& attribute = attributes[i];
+		glVertexAttribPointer(attribute.location, attribute.components, attribute_gl_type(attribute.type),
+							  attribute.normalized ? GL_TRUE : GL_FALSE, header.vertexStride,
+							  (GLvoid*)(uintptr_t)attribute.offset);
+		glEnableVertexAttribArray(attribute.location);
+	}
 
-			if (word == "v") {
-				glm::vec3 v;
-				ssline >> v.x >> v.y >> v.z;
-				vertices.push_back(v);
-			}
-			if (word == "vt") {
-				glm::vec2 vt;
-				ssline >> vt.s >> vt.t;
-				texCoords.push_back(vt);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	return VAO;
+}
+
+// Função para obter a decodificação dos vértices de uma malha em cache: posições em 16 bits normalizados são relativas
+// à caixa envolvente e normais com dois componentes são octaédricas (MeshOptimizer.h: pack_mesh).
+VertexDecode cached_mesh_decode(const MeshCacheFile& cache) {
+	const MeshCacheHeader& header = cache.getHeader();
+	VertexDecode decode;
+	const VertexAttribute* attributes = cache.getAttributes();
+	for (uint32_t i = 0; i < header.attributeCount; i++) {
+		const VertexAttribute& attribute = attributes[i];
+		if (attribute.location == ATTRIBUTE_POSITION && attribute.type == ATTRIBUTE_UINT16 && attribute.normalized) {
+			glm::vec3 boundsMin = glm::make_vec3(header.boundsMin);
+			decode.positionOffset = boundsMin;
+			decode.positionScale = glm::make_vec3(header.boundsMax) - boundsMin;
+		}
+		if (attribute.location == ATTRIBUTE_NORMAL && attribute.components == 2) {
+			decode.octahedralNormal = true;
+		}
+	}
+	return decode;
+}
+
+// Função para associar cada faixa da malha a um material da biblioteca MTL do objeto. Retorna o caminho da
+// biblioteca (vazio se o OBJ não tiver mtllib).
+string resolve_mesh_materials(const string& objPath, const string& mtllib, const vector<string>& materialNames,
+							  const vector<Submesh>& submeshes, vector<Material>& materials,
+							  vector<MeshRange>& ranges) {
+	MaterialLibrary library;
+	string mtlPath;
+	if (!mtllib.empty()) {
+		mtlPath = (filesystem::path(objPath).parent_path() / mtllib).string();
+		library.load(mtlPath);
+	}
+	materials = library.getMaterials();
+
+	ranges.clear();
+	for (const Submesh& submesh : submeshes) {
+		string name = submesh.materialId < materialNames.size() ? materialNames[submesh.materialId] : string();
+		ranges.push_back({(int)submesh.indexOffset, (int)submesh.indexCount, library.find(name)});
+	}
+	return mtlPath;
+}
+
+// Função para incluir os materiais de um objeto no MaterialBlock. Retorna o índice do primeiro material do objeto
+// (0 quando não há mais espaço no bloco).
+int add_scene_materials(vector<MaterialBlockData>& sceneMaterials, const vector<Material>& materials) {
+	if (sceneMaterials.size() + materials.size() > (size_t)MAX_MATERIALS) {
+		cout << "Limite de " << MAX_MATERIALS << " materiais atingido" << endl;
+		return 0;
+	}
+	int base = (int)sceneMaterials.size();
+	for (const Material& material : materials) {
+		sceneMaterials.push_back(MaterialBlockData(material));
+	}
+	return base;
+}
+
+// Geometria de um arquivo OBJ lida do disco e pronta para ser enviada à OpenGL. A leitura (read_mesh) não usa a
+// OpenGL e pode rodar no pool de carregamento; o envio (upload_mesh) acontece na thread de renderização.
+struct LoadedMesh {
+	MeshCacheFile cache;		 // cache binário mapeado, quando o caminho rápido foi usado
+	vector<GLfloat> vbuffer;	 // vértices intercalados (11 floats), sem o cache
+	vector<GLuint> indices;		 // vazio no modo expandido
+	vector<Material> materials;	 // materiais da biblioteca MTL
+	vector<MeshLevel> levels;	 // níveis de detalhe, cada um com uma faixa por material usado
+	string mtlPath;				 // biblioteca MTL do OBJ (vazio se não houver)
+	glm::vec3 boundsMin = glm::vec3(0.0f), boundsMax = glm::vec3(0.0f);
+	shared_ptr<TriangleBvh> triangles;	// BVH dos triângulos da malha completa (seleção com o mouse)
+};
+
+// Função para montar a BVH dos triângulos da malha completa (nível 0), usada na seleção com o mouse, no pool de
+// carregamento. A árvore é colapsada para os nós de 8 (AVX2) ou 4 filhos percorridos pelo processador. positions: x, y,
+// z em float a cada positionStride bytes; indexData: índices de indexSize bytes (nulo no modo expandido, em que as
+// faixas são de vértices).
+void build_mesh_triangles(LoadedMesh& mesh, const uint8_t* positions, size_t positionStride, const void* indexData,
+						  uint32_t indexSize, ThreadPool* pool) {
+	vector<uint32_t> corners;
+	for (const MeshRange& range : mesh.levels[0].ranges) {
+		for (int i = range.first; i < range.first + range.count; i++) {
+			if (!indexData) {
+				corners.push_back((uint32_t)i);
+			} else if (indexSize == 2) {
+				corners.push_back(((const uint16_t*)indexData)[i]);
+			} else {
+				corners.push_back(((const uint32_t*)indexData)[i]);
 			}
-			if (word == "vn") {
-				glm::vec3 vn;
-				ssline >> vn.x >> vn.y >> vn.z;
-				normals.push_back(vn);
+		}
+	}
+	mesh.triangles = make_shared<TriangleBvh>();
+	mesh.triangles->build(positions, positionStride, corners.data(), corners.size() / 3, pool);
+	mesh.triangles->collapse(triangle_simd_supported() == TRIANGLE_SIMD_AVX2 ? 8 : 4);
+}
+
+// Função para ler um arquivo obj.
+// No modo indexado os vértices repetidos são unificados e a malha terá um EBO; caso contrário o objeto é desenhado
+// com os vértices expandidos.
+// As faces ficam agrupadas por material: cada nível de detalhe recebe uma faixa (índices ou vértices) por material
+// usado. Os níveis simplificados vêm do cache; sem ele, só a malha completa é desenhada.
+// color: cor gravada nos vértices lidos sem o cache (o cache não guarda cor, e o Shader.fs não a usa).
+void read_mesh(const string& filepath, LoadedMesh& mesh, glm::vec3 color = glm::vec3(1.0, 0.0, 1.0),
+			   const ObjLoadOptions& options = ObjLoadOptions()) {
+	// Caminho rápido: cache binário mapeado em memória, sem interpretar o texto.
+	if (options.indexed && options.cache) {
+		if (load_mesh_cached(filepath, mesh.cache, options.pool)) {
+			const MeshCacheHeader& header = mesh.cache.getHeader();
+
+			string mtllib;
+			vector<string> materialNames;
+			mesh.cache.getMaterialNames(mtllib, materialNames);
+			vector<Submesh> submeshes(mesh.cache.getSubmeshes(), mesh.cache.getSubmeshes() + header.submeshCount);
+			vector<MeshRange> ranges;
+			mesh.mtlPath = resolve_mesh_materials(filepath, mtllib, materialNames, submeshes, mesh.materials, ranges);
+			mesh.boundsMin = glm::make_vec3(header.boundsMin);
+			mesh.boundsMax = glm::make_vec3(header.boundsMax);
+
+			// Faixas de cada nível de detalhe (sem níveis no arquivo, todas formam a malha completa).
+			vector<MeshLod> lods(mesh.cache.getLods(), mesh.cache.getLods() + header.lodCount);
+			if (lods.empty()) {
+				lods.push_back({0, header.submeshCount, 0.0f, 0});
 			}
-			if (word == "f") {
-				string tokens[3];
-				ssline >> tokens[0] >> tokens[1] >> tokens[2];
-
-				for (int i = 0; i < 3; i++) {
-					// Recuperando os indices de v
-					int pos = tokens[i].find("/");
-					string token = tokens[i].substr(0, pos);
-					int index = atoi(token.c_str()) - 1;
-					indices.push_back(index);
-
-					vbuffer.push_back(vertices[index].x);
-					vbuffer.push_back(vertices[index].y);
-					vbuffer.push_back(vertices[index].z);
-					vbuffer.push_back(color.r);
-					vbuffer.push_back(color.g);
-					vbuffer.push_back(color.b);
-
-					// Recuperando os indices de vts
-					tokens[i] = tokens[i].substr(pos + 1);
-					pos = tokens[i].find("/");
-					token = tokens[i].substr(0, pos);
-					index = atoi(token.c_str()) - 1;
-
-					vbuffer.push_back(texCoords[index].s);
-					vbuffer.push_back(texCoords[index].t);
-
-					// Recuperando os indices de vns
-					tokens[i] = tokens[i].substr(pos + 1);
-					index = atoi(tokens[i].c_str()) - 1;
-
-					vbuffer.push_back(normals[index].x);
-					vbuffer.push_back(normals[index].y);
-					vbuffer.push_back(normals[index].z);
+			string triangles;
+			for (const MeshLod& lod : lods) {
+				MeshLevel level;
+				level.ranges.assign(ranges.begin() + lod.firstSubmesh,
+									ranges.begin() + lod.firstSubmesh + lod.submeshCount);
+				level.error = lod.error;
+				int count = 0;
+				for (const MeshRange& range : level.ranges) {
+					count += range.count / 3;
 				}
+				triangles += (triangles.empty() ? "" : "/") + to_string(count);
+				mesh.levels.push_back(level);
+			}
+
+			vector<float> positions((size_t)header.vertexCount * 3);
+			decode_positions((const uint8_t*)mesh.cache.getVertexData(), header.vertexCount, header.vertexStride,
+							 mesh.cache.getAttributes(), header.attributeCount, header.boundsMin, header.boundsMax,
+							 positions.data());
+			build_mesh_triangles(mesh, (const uint8_t*)positions.data(), 3 * sizeof(float), mesh.cache.getIndexData(),
+								 header.indexSize, options.pool);
+
+			if (options.printStats) {
+				cout << filepath << ": " << triangles << " triangulos (" << mesh.levels.size() << " niveis), "
+					 << header.vertexCount << " vertices, " << mesh.levels[0].ranges.size() << " faixas, VBO "
+					 << header.vertexBytes / 1024 << " KB (" << header.vertexStride << " bytes por vertice) + EBO "
+					 << header.indexBytes / 1024 << " KB (cache)" << endl;
 			}
+			return;
+		}
+	}
+
+	ObjData data;
+	if (load_obj(filepath, data, options.pool)) {
+		if (options.indexed) {
+			build_indexed_vertex_buffer(data, color, mesh.vbuffer, mesh.indices);
+		} else {
+			build_vertex_buffer(data, color, mesh.vbuffer);
 		}
 	} else {
 		cout << "Problema ao encontrar o arquivo " << filepath << endl;
 	}
 
-	inputFile.close();
+	vector<Submesh> submeshes;
+	build_submeshes(data, submeshes);
+	mesh.levels.resize(1);
+	mesh.mtlPath = resolve_mesh_materials(filepath, data.mtllib, data.materialNames, submeshes, mesh.materials,
+										  mesh.levels[0].ranges);
+
+	// Caixa envolvente a partir das posições dos vértices (11 floats por vértice).
+	for (size_t i = 0; i + 11 <= mesh.vbuffer.size(); i += 11) {
+		glm::vec3 position = glm::make_vec3(&mesh.vbuffer[i]);
+		mesh.boundsMin = i == 0 ? position : glm::min(mesh.boundsMin, position);
+		mesh.boundsMax = i == 0 ? position : glm::max(mesh.boundsMax, position);
+	}
+	build_mesh_triangles(mesh, (const uint8_t*)mesh.vbuffer.data(), 11 * sizeof(GLfloat),
+						 mesh.indices.empty() ? nullptr : mesh.indices.data(), sizeof(GLuint), options.pool);
+
+	// Memória de vídeo usada pela geometria, comparada com a versão expandida (11 floats por canto de face).
+	size_t expandedBytes = data.corners.size() * 11 * sizeof(GLfloat);
+	size_t vboBytes = mesh.vbuffer.size() * sizeof(GLfloat);
+	size_t eboBytes = mesh.indices.size() * sizeof(GLuint);
+	if (options.printStats) {
+		cout << filepath << ": " << data.corners.size() / 3 << " triangulos, " << mesh.vbuffer.size() / 11
+			 << " vertices, " << mesh.levels[0].ranges.size() << " faixas, VBO expandido " << expandedBytes / 1024
+			 << " KB -> VBO " << vboBytes / 1024 << " KB + EBO " << eboBytes / 1024 << " KB" << endl;
+	}
+}
+
+// Função para enviar uma malha lida para a OpenGL. Preenche a geometria com o VAO, os nIndices índices do tipo
+// indexType no EBO (nIndices fica 0 sem EBO), os níveis de detalhe, a decodificação dos vértices a usar no shader e a
+// caixa e a esfera envolventes (a posição dos materiais no MaterialBlock fica como estava).
+void upload_mesh(const LoadedMesh& mesh, MeshGeometry& geometry) {
+	geometry.levels = mesh.levels;
+	geometry.center = (mesh.boundsMin + mesh.boundsMax) * 0.5f;
+	geometry.extent = (mesh.boundsMax - mesh.boundsMin) * 0.5f;
+	geometry.radius = glm::length(mesh.boundsMax - mesh.boundsMin) * 0.5f;
+	geometry.triangles = mesh.triangles;
+	if (mesh.cache.isOpen()) {
+		const MeshCacheHeader& header = mesh.cache.getHeader();
+		geometry.nVertices = header.vertexCount;
+		geometry.nIndices = header.indexCount;
+		geometry.indexType = header.indexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+		geometry.decode = cached_mesh_decode(mesh.cache);
+		geometry.VAO = create_cached_mesh_vao(mesh.cache);
+		return;
+	}
 
+	const vector<GLfloat>& vbuffer = mesh.vbuffer;
+	const vector<GLuint>& indices = mesh.indices;
 	GLuint VBO, VAO;
 
-	nVerts = vbuffer.size() / 11;
+	geometry.nVertices = vbuffer.size() / 11;
+	geometry.nIndices = indices.size();
+	geometry.indexType = GL_UNSIGNED_INT;
+	geometry.decode = VertexDecode();
 
 	// Geração do identificador do VBO
 	glGenBuffers(1, &VBO);
@@ -277,6 +505,14 @@ int load_simple_obj(string filepath, int& nVerts, glm::vec3 color = glm::vec3(1.
 	// e os ponteiros para os atributos
 	glBindVertexArray(VAO);
 
+	// Buffer de índices (fica associado ao VAO enquanto ele estiver vinculado).
+	if (!indices.empty()) {
+		GLuint EBO;
+		glGenBuffers(1, &EBO);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	}
+
 	// Atributo posição (x, y, z)
 	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 11 * sizeof(GLfloat), (GLvoid*)0);
 	glEnableVertexAttribArray(0);
@@ -300,147 +536,464 @@ int load_simple_obj(string filepath, int& nVerts, glm::vec3 color = glm::vec3(1.
 	// Desvincula o VAO (é uma boa prática desvincular qualquer buffer ou array para evitar bugs medonhos)
 	glBindVertexArray(0);
 
-	return VAO;
+	geometry.VAO = VAO;
 }
 
-// Função para carregar uma textura.
-GLuint load_texture(string filePath) {
-	GLuint texId;
+// Função para liberar um VAO criado por upload_mesh junto com os buffers de vértices e índices vinculados a ele.
+void delete_mesh_vao(GLuint VAO) {
+	GLint VBO = 0, EBO = 0;
+	glBindVertexArray(VAO);
+	glGetVertexAttribiv(ATTRIBUTE_POSITION, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &VBO);
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &EBO);
+	glBindVertexArray(0);
+	GLuint buffers[2] = {(GLuint)VBO, (GLuint)EBO};
+	glDeleteBuffers(2, buffers);
+	glDeleteVertexArrays(1, &VAO);
+}
+
+// Geometria de um arquivo OBJ, compartilhada por todos os objetos que usam o mesmo caminho.
+struct SceneGeometry : MeshGeometry {
+	int materialCount = 0;
+	string mtlPath;	 // biblioteca MTL (vazia se não houver)
+};
+
+// Recursos da cena carregados sem repetição: cada OBJ é lido uma única vez, as texturas vêm do texture_manager e cada
+// par (OBJ, textura ou array de texturas) tem um lote de instâncias. Com os arrays, os objetos de um mesmo OBJ com
+// texturas de mesmo formato e dimensões ficam no mesmo lote. Os lotes ficam em um map para que os ponteiros guardados
+// nas Mesh não mudem.
+struct SceneResources {
+	map<string, SceneGeometry> geometries;
+	map<pair<string, GLuint>, MeshBatch> batches;
+	vector<MaterialBlockData> materials;  // conteúdo do MaterialBlock
+	bool entitiesChanged = true;		  // objetos, teste de carga ou geometrias mudaram: refazer o SceneIndex
+};
 
-	// Gera a textura em memória.
-	glGenTextures(1, &texId);
-	glBindTexture(GL_TEXTURE_2D, texId);
+// Objeto da cena, declarado na lista objects da configuração. Os objetos ficam em um vector contíguo, na ordem da
+// lista.
+struct SceneObject {
+	Mesh mesh;
+	TextureHandle texture;	// textura 2D ou camada de um array, mantida enquanto o objeto existir
+	// Rotações aplicadas pela movimentação, mantidas quando o objeto deixa de estar selecionado.
+	glm::mat4 model = glm::mat4(1);
+	float zoom = 0.0f;
+	// Com orbit_radius maior que 0 o objeto orbita em torno do eixo y na altura orbit_height (como o planeta).
+	float orbitRadius = 0.0f;
+	float orbitHeight = 0.0f;
+	// Matriz modelo (e a caixa) mudou desde a última atualização do SceneIndex.
+	bool boundsChanged = true;
+};
+
+// Função para obter o lote de um par (OBJ, textura ou array), carregando a geometria na primeira vez em que aparece.
+MeshBatch* get_scene_batch(SceneResources& scene, const string& objPath, const ManagedTexture& texture,
+						   const Shader& shader, const ObjLoadOptions& options) {
+	pair<string, GLuint> key(objPath, texture.id);
+	auto batch = scene.batches.find(key);
+	if (batch != scene.batches.end()) {
+		return &batch->second;
+	}
+
+	auto geometry = scene.geometries.find(objPath);
+	if (geometry == scene.geometries.end()) {
+		LoadedMesh mesh;
+		read_mesh(objPath, mesh, glm::vec3(1.0, 1.0, 0.0), options);
+		SceneGeometry loaded;
+		upload_mesh(mesh, loaded);
+		loaded.materialBase = add_scene_materials(scene.materials, mesh.materials);
+		loaded.materialCount = (int)mesh.materials.size();
+		loaded.mtlPath = mesh.mtlPath;
+		geometry = scene.geometries.emplace(objPath, loaded).first;
+		scene.entitiesChanged = true;
+	}
+
+	const SceneGeometry& shared = geometry->second;
+	MeshBatch& created = scene.batches[key];
+	created.initialize(shared, texture.id, texture.target, shader);
+	return &created;
+}
 
-	// Configura os parâmetros.
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+// Contadores de desenho de um quadro.
+struct DrawStats {
+	int drawCalls = 0;
+	size_t triangles = 0;
+	size_t culledObjects = 0;	 // instâncias fora do frustum
+	size_t culledTriangles = 0;	 // triângulos que elas teriam na malha completa
+	size_t binds = 0;			 // vínculos de estado enviados à OpenGL (GlStateCache)
+	size_t skippedBinds = 0;	 // vínculos repetidos, evitados pela cache
+};
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+// Função para desenhar as instâncias enfileiradas em todos os lotes: as que estão dentro de frustum, cada uma no nível
+// de detalhe escolhido por lod. Com sorted, os itens de todos os lotes saem na ordem das chaves (programa, textura,
+// malha, profundidade e material); sem ele, lote por lote, cada um vinculando e desvinculando o seu estado (como antes
+// da fila). Soma os contadores do quadro em stats.
+void draw_scene_batches(SceneResources& scene, RenderQueue& queue, GlStateCache& state, bool sorted, bool instanced,
+						const LodSelection& lod, const Frustum& frustum, DrawStats& stats) {
+	state.reset();
+	queue.clear();
+	for (auto& batch : scene.batches) {
+		batch.second.enqueue(queue, state, instanced, lod, frustum);
+	}
+	if (sorted) {
+		queue.sort();
+	}
+	stats.drawCalls += draw_render_queue(queue, state, !sorted);
+	stats.binds += state.getBinds();
+	stats.skippedBinds += state.getSkipped();
+	for (auto& batch : scene.batches) {
+		stats.triangles += batch.second.getDrawnTriangles();
+		stats.culledObjects += batch.second.getCulledInstances();
+		stats.culledTriangles += batch.second.getCulledTriangles();
+	}
+}
 
-	// Carrega a imagem da textura.
-	int width, height, nrChannels;
-	unsigned char* data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-	if (data) {
-		if (nrChannels == 3)  // jpg
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		} else	// png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+// Função para liberar os lotes que nenhum objeto usa mais (depois de uma troca da lista de objetos). As texturas
+// dos objetos removidos já foram liberadas com eles.
+void release_unused_batches(SceneResources& scene, vector<SceneObject>& objects) {
+	set<const MeshBatch*> used;
+	for (SceneObject& object : objects) {
+		used.insert(object.mesh.getBatch());
+	}
+	for (auto batch = scene.batches.begin(); batch != scene.batches.end();) {
+		if (used.count(&batch->second)) {
+			++batch;
+			continue;
 		}
+		batch->second.destroy();
+		batch = scene.batches.erase(batch);
+	}
+}
 
-		glGenerateMipmap(GL_TEXTURE_2D);
-	} else {
-		cout << "Failed to load texture" << endl;
+// Função para liberar os lotes e VAOs da cena (as texturas saem com os objetos).
+void destroy_scene(SceneResources& scene) {
+	for (auto& batch : scene.batches) {
+		batch.second.destroy();
+	}
+	for (auto& geometry : scene.geometries) {
+		delete_mesh_vao(geometry.second.VAO);
+	}
+	scene.batches.clear();
+	scene.geometries.clear();
+}
+
+// Função para imprimir a memória de vídeo ocupada pelas texturas.
+void print_texture_usage() {
+	for (const TextureUsage& texture : texture_manager.getUsage()) {
+		cout << "  " << texture.path << ": " << texture.gpuBytes / 1024 << " KB, " << texture.users << " objeto(s)"
+			 << endl;
+	}
+	cout << "Memoria de video das texturas: " << texture_manager.getTotalGpuBytes() / 1024 << " KB ("
+		 << texture_manager.getArrayCount() << " arrays de texturas)" << endl;
+}
+
+// Função para configurar um objeto da cena a partir da sua entrada na lista objects.
+void setup_scene_object(SceneObject& object, const ObjectConfig& config, int id, MeshBatch* batch) {
+	object.mesh.initialize(id, batch, config.position, config.scale, config.rotation);
+	object.mesh.setTextureLayer(object.texture ? object.texture->layer : 0);
+	object.zoom = config.zoom;
+	object.orbitRadius = config.orbitRadius;
+	object.orbitHeight = config.orbitHeight;
+	object.boundsChanged = true;
+}
+
+// Função para criar os objetos da lista objects da configuração. Cada objeto recebe como id a sua posição na lista a
+// partir de 1 (o id 0 é a câmera). Os objetos anteriores só são liberados no fim, para que as texturas que continuam
+// na cena não sejam apagadas e lidas de novo.
+void load_scene_objects(const vector<ObjectConfig>& list, SceneResources& scene, const Shader& shader,
+						const ObjLoadOptions& options, vector<SceneObject>& objects) {
+	vector<SceneObject> loaded(list.size());
+	for (size_t i = 0; i < list.size(); i++) {
+		loaded[i].texture = texture_manager.acquire(list[i].texturePath);
+		MeshBatch* batch = get_scene_batch(scene, list[i].objPath, *loaded[i].texture, shader, options);
+		setup_scene_object(loaded[i], list[i], (int)i + 1, batch);
+	}
+	objects.swap(loaded);
+}
+
+// Função para montar a cena de teste de carga: count matrizes modelo em uma grade cúbica atrás dos objetos.
+void build_stress_scene(int count, vector<glm::mat4>& models) {
+	models.clear();
+	int side = max(1, (int)ceil(cbrt((double)count)));
+	float spacing = 1.5f;
+	float center = (side - 1) * spacing * 0.5f;
+	for (int i = 0; i < count; i++) {
+		int x = i % side;
+		int y = (i / side) % side;
+		int z = i / (side * side);
+		glm::vec3 position(x * spacing - center, y * spacing - center, -10.0f - z * spacing);
+		models.push_back(glm::scale(glm::translate(glm::mat4(1.0f), position), glm::vec3(0.4f)));
 	}
+}
 
-	// Limpa o espaço armazenado.
-	stbi_image_free(data);
+// Função para definir a fonte de luz pontual no bloco do quadro.
+void set_frame_light(FrameBlockData& frameBlock, const AppConfig& config) {
+	frameBlock.lightPos = glm::vec4(config.lightPos, 1.0f);
+	frameBlock.lightColor = glm::vec4(config.lightColor, 0.0f);
+}
 
-	// Desvincula a textura.
-	glBindTexture(GL_TEXTURE_2D, 0);
+// Função para associar o programa aos blocos uniformes e às unidades de textura (após criar ou recompilar o shader).
+void setup_shader(const Shader& shader) {
+	glUseProgram(shader.ID);
+	shader.bindUniformBlock("FrameBlock", FRAME_BLOCK_BINDING);
+	shader.bindUniformBlock("MaterialBlock", MATERIAL_BLOCK_BINDING);
+	shader.setInt("tex_buffer", TEXTURE_UNIT_2D);
+	shader.setInt("tex_array", TEXTURE_UNIT_ARRAY);
+}
 
-	return texId;
+// Função para enviar os materiais da cena ao MaterialBlock.
+void update_material_buffer(UniformBuffer& buffer, const SceneResources& scene) {
+	vector<MaterialBlockData> materials = scene.materials;
+	materials.resize(MAX_MATERIALS);
+	buffer.update(materials.data(), materials.size() * sizeof(MaterialBlockData));
 }
 
-// Função utilitária para analisar o arquivo OBJ e obter o caminho completo do arquivo MTL
-std::string getMTLFilePath(const std::string& objFilePath) {
-	std::ifstream objFile(objFilePath);
-	std::string line;
-	std::string mtlFilePath;
+// Recarga dos arquivos alterados durante a execução. O observador só classifica os arquivos: malhas são lidas no pool
+// de carregamento e ficam prontas em uma fila, e a thread de renderização, entre um quadro e outro, envia o resultado
+// para a OpenGL e recompila os shaders (ela é a única com o contexto OpenGL). Texturas alteradas são relidas pelo
+// texture_streamer, que as envia na própria textura.
+struct HotReload {
+	FileWatcher watcher;
+	ObjLoadOptions options;
+
+	mutex lock;
+	map<string, string> meshFiles;	// arquivo observado (OBJ ou MTL) -> OBJ a recarregar
+	map<string, pair<GLuint, int>> textureFiles;  // imagem -> textura 2D ou (array, camada)
+	set<string> shaderFiles;
+	set<string> loading;	// leituras em andamento (um arquivo nunca é lido por duas tarefas ao mesmo tempo)
+	set<string> loadAgain;	// alterados de novo durante a leitura
+	bool shadersChanged = false;
+	vector<pair<string, shared_ptr<LoadedMesh>>> readyMeshes;
+};
+
+// Função para observar os shaders e todos os arquivos (OBJ, MTL e texturas) usados pela cena. objects deve ter sido
+// criada a partir de config.objects.
+void watch_scene_files(HotReload& reload, const SceneResources& scene, const vector<SceneObject>& objects,
+					   const AppConfig& config) {
+	vector<string> paths;
+	{
+		lock_guard<mutex> guard(reload.lock);
+		reload.shaderFiles = {config.vertexShaderPath, config.fragmentShaderPath};
+		paths.assign(reload.shaderFiles.begin(), reload.shaderFiles.end());
+		for (const auto& geometry : scene.geometries) {
+			reload.meshFiles[geometry.first] = geometry.first;
+			paths.push_back(geometry.first);
+			if (!geometry.second.mtlPath.empty()) {
+				reload.meshFiles[geometry.second.mtlPath] = geometry.first;
+				paths.push_back(geometry.second.mtlPath);
+			}
+		}
+		reload.textureFiles.clear();
+		for (size_t i = 0; i < objects.size() && i < config.objects.size(); i++) {
+			const string& path = config.objects[i].texturePath;
+			reload.textureFiles[path] = make_pair(objects[i].texture->id, objects[i].texture->layer);
+			paths.push_back(path);
+		}
+	}
+	for (const string& path : paths) {
+		reload.watcher.watch(path);
+	}
+}
 
-	if (!objFile.is_open()) {
-		std::cerr << "Falha ao abrir o arquivo OBJ: " << objFilePath << std::endl;
-		return "";
+// Função para agendar a leitura de uma malha no pool de carregamento (com reload.lock travado).
+void schedule_mesh_read(HotReload& reload, const string& path) {
+	if (reload.loading.count(path)) {
+		reload.loadAgain.insert(path);
+		return;
 	}
+	reload.loading.insert(path);
+	reload.options.pool->submit([&reload, path, options = reload.options] {
+		auto mesh = make_shared<LoadedMesh>();
+		read_mesh(path, *mesh, glm::vec3(1.0, 1.0, 0.0), options);
+
+		lock_guard<mutex> guard(reload.lock);
+		reload.readyMeshes.emplace_back(path, mesh);
+		reload.loading.erase(path);
+		if (reload.loadAgain.erase(path)) {
+			schedule_mesh_read(reload, path);
+		}
+	});
+}
 
-	while (std::getline(objFile, line)) {
-		std::istringstream iss(line);
-		std::string word;
-		iss >> word;
-		if (word == "mtllib") {
-			iss >> mtlFilePath;
-			break;
+// Função para iniciar a observação dos arquivos da cena (options.pool faz as leituras).
+void start_hot_reload(HotReload& reload, const ObjLoadOptions& options) {
+	reload.options = options;
+	reload.watcher.start([&reload](const vector<string>& changed) {
+		lock_guard<mutex> guard(reload.lock);
+		for (const string& path : changed) {
+			if (reload.shaderFiles.count(path)) {
+				reload.shadersChanged = true;
+			}
+			auto mesh = reload.meshFiles.find(path);
+			if (mesh != reload.meshFiles.end()) {
+				schedule_mesh_read(reload, mesh->second);
+			}
+			auto texture = reload.textureFiles.find(path);
+			if (texture != reload.textureFiles.end()) {
+				texture_streamer.reload(texture->second.first, path, texture->second.second);
+			}
 		}
+	});
+}
+
+// Função para aplicar, entre quadros, as recargas prontas: recompila os shaders alterados e troca a geometria nos
+// VAOs/lotes existentes. Só os arquivos alterados são tocados. Retorna true se os materiais
+// da cena mudaram (o MaterialBlock deve ser reenviado).
+bool apply_hot_reload(HotReload& reload, SceneResources& scene, Shader& shader, const AppConfig& config) {
+	bool shadersChanged;
+	vector<pair<string, shared_ptr<LoadedMesh>>> meshes;
+	{
+		lock_guard<mutex> guard(reload.lock);
+		shadersChanged = reload.shadersChanged;
+		reload.shadersChanged = false;
+		meshes.swap(reload.readyMeshes);
 	}
 
-	objFile.close();
+	if (shadersChanged) {
+		if (shader.reload(config.vertexShaderPath.c_str(), config.fragmentShaderPath.c_str())) {
+			setup_shader(shader);
+			for (auto& batch : scene.batches) {
+				batch.second.resolveUniforms(shader);
+			}
+			cout << "Shaders recompilados" << endl;
+		} else {
+			cout << "Erro ao recompilar os shaders: o programa anterior continua em uso" << endl;
+		}
+	}
 
-	// Extrai o diretório do caminho relativo do arquivo OBJ
-	std::filesystem::path objPath(objFilePath);
-	std::filesystem::path objDirectory = objPath.parent_path();
+	bool materialsChanged = false;
+	for (const auto& loaded : meshes) {
+		auto found = scene.geometries.find(loaded.first);
+		if (found == scene.geometries.end()) {
+			continue;
+		}
+		const LoadedMesh& mesh = *loaded.second;
+		SceneGeometry& geometry = found->second;
+		GLuint previousVAO = geometry.VAO;
+		upload_mesh(mesh, geometry);
+
+		// Os materiais novos ocupam o lugar dos anteriores no MaterialBlock quando cabem.
+		if (mesh.materials.size() <= (size_t)geometry.materialCount) {
+			for (size_t i = 0; i < mesh.materials.size(); i++) {
+				scene.materials[geometry.materialBase + i] = MaterialBlockData(mesh.materials[i]);
+			}
+		} else {
+			geometry.materialBase = add_scene_materials(scene.materials, mesh.materials);
+		}
+		geometry.materialCount = (int)mesh.materials.size();
+		materialsChanged = true;
 
-	// Constrói o caminho completo para o arquivo MTL
-	std::filesystem::path fullMtlPath = objDirectory / mtlFilePath;
+		for (auto& batch : scene.batches) {
+			if (batch.first.first == loaded.first) {
+				batch.second.setGeometry(geometry);
+			}
+		}
+		delete_mesh_vao(previousVAO);
+		scene.entitiesChanged = true;
+
+		// Uma biblioteca MTL nova também passa a ser observada.
+		if (mesh.mtlPath != geometry.mtlPath && !mesh.mtlPath.empty()) {
+			{
+				lock_guard<mutex> guard(reload.lock);
+				reload.meshFiles[mesh.mtlPath] = loaded.first;
+			}
+			reload.watcher.watch(mesh.mtlPath);
+		}
+		geometry.mtlPath = mesh.mtlPath;
+		cout << "Malha recarregada: " << loaded.first << endl;
+	}
 
-	return fullMtlPath.string();
+	return materialsChanged;
 }
 
-struct Material {
-	glm::vec3 Ka;  // Ambient color
-	glm::vec3 Kd;  // Diffuse color
-	glm::vec3 Ks;  // Specular color
-	glm::vec3 Ke;  // Emissive color
-	float Ns;	   // Specular exponent
-	float Ni;	   // Optical density
-	float d;	   // Dissolve
-	int illum;	   // Illumination model
-};
+// Função para aplicar uma nova versão da configuração, comparando com a que estava em uso: só o que mudou é refeito.
+// Opções lidas do snapshot a cada quadro (instancing, print_stats, lod_pixel_error, frustum_culling, scene_bvh) não
+// precisam de tratamento, a não ser print_stats nas opções das próximas leituras de malhas. Objetos novos carregam
+// apenas as malhas e texturas que ainda não estavam na cena; janela e opções de carregamento só valem ao reiniciar.
+// Retorna true se os materiais da cena mudaram.
+bool apply_config_changes(const AppConfig& previous, const AppConfig& config, FrameBlockData& frameBlock,
+						  vector<SceneObject>& objects, vector<glm::mat4>& stressModels, SceneResources& scene,
+						  const Shader& shader, HotReload& reload) {
+	bool materialsChanged = false;
+
+	if (config.printStats != previous.printStats) {
+		// As leituras agendadas levam uma cópia das opções (schedule_mesh_read).
+		lock_guard<mutex> guard(reload.lock);
+		reload.options.printStats = config.printStats;
+	}
+
+	if (config.lightPos != previous.lightPos || config.lightColor != previous.lightColor) {
+		set_frame_light(frameBlock, config);
+	}
 
-Material parseMTL(const std::string& mtlFilePath) {
-	std::ifstream mtlFile(mtlFilePath);
-	std::string line;
-	Material material;
-
-	if (!mtlFile.is_open()) {
-		std::cerr << "Failed to open MTL file: " << mtlFilePath << std::endl;
-		return material;
-	}
-
-	while (std::getline(mtlFile, line)) {
-		std::istringstream iss(line);
-		std::string word;
-		iss >> word;
-		if (word == "Ka") {
-			iss >> material.Ka.r >> material.Ka.g >> material.Ka.b;
-		} else if (word == "Kd") {
-			iss >> material.Kd.r >> material.Kd.g >> material.Kd.b;
-		} else if (word == "Ks") {
-			iss >> material.Ks.r >> material.Ks.g >> material.Ks.b;
-		} else if (word == "Ke") {
-			iss >> material.Ke.r >> material.Ke.g >> material.Ke.b;
-		} else if (word == "Ni") {
-			iss >> material.Ni;
-		} else if (word == "d") {
-			iss >> material.d;
-		} else if (word == "illum") {
-			iss >> material.illum;
-		}
-	}
-
-	mtlFile.close();
-	return material;
-}
-
-void setMaterialProperties(Shader& shader, const Material& material, bool selected) {
-	shader.setVec3("ka", material.Ka.r, material.Ka.g, material.Ka.b);
-	shader.setVec3("kd", material.Kd.r, material.Kd.g, material.Kd.b);
-	shader.setVec3("ks", material.Ks.r, material.Ks.g, material.Ks.b);
-	if (selected) {
-		shader.setVec3("ke", 0.2, 0.1, 0.0);
+	if (config.stressInstances != previous.stressInstances && !objects.empty()) {
+		build_stress_scene(config.stressInstances, stressModels);
+		scene.entitiesChanged = true;
+	}
+
+	bool sameAssets = config.objects.size() == objects.size() && previous.objects.size() == objects.size();
+	for (size_t i = 0; sameAssets && i < config.objects.size(); i++) {
+		sameAssets = config.objects[i].objPath == previous.objects[i].objPath &&
+					 config.objects[i].texturePath == previous.objects[i].texturePath;
+	}
+	if (sameAssets) {
+		// Posição, escala, rotação, zoom e órbita são aplicados na hora, só nos objetos alterados.
+		for (size_t i = 0; i < config.objects.size(); i++) {
+			const ObjectConfig& before = previous.objects[i];
+			const ObjectConfig& after = config.objects[i];
+			if (after.position != before.position || after.scale != before.scale || after.rotation != before.rotation ||
+				after.zoom != before.zoom || after.orbitRadius != before.orbitRadius ||
+				after.orbitHeight != before.orbitHeight) {
+				setup_scene_object(objects[i], after, (int)i + 1, objects[i].mesh.getBatch());
+			}
+		}
 	} else {
-		shader.setVec3("ke", material.Ke.r, material.Ke.g, material.Ke.b);
+		// Lista de objetos nova: os objetos que continuam na mesma posição da lista com a mesma malha e textura mantêm
+		// a movimentação acumulada.
+		vector<glm::mat4> models(config.objects.size(), glm::mat4(1));
+		for (size_t i = 0; i < config.objects.size() && i < objects.size() && i < previous.objects.size(); i++) {
+			if (config.objects[i].objPath == previous.objects[i].objPath &&
+				config.objects[i].texturePath == previous.objects[i].texturePath) {
+				models[i] = objects[i].model;
+			}
+		}
+		size_t materialCount = scene.materials.size();
+		load_scene_objects(config.objects, scene, shader, reload.options, objects);
+		release_unused_batches(scene, objects);
+		for (size_t i = 0; i < objects.size(); i++) {
+			objects[i].model = models[i];
+		}
+		if (!objects.empty()) {
+			build_stress_scene(config.stressInstances, stressModels);
+		} else {
+			stressModels.clear();
+		}
+		materialsChanged = scene.materials.size() != materialCount;
+		scene.entitiesChanged = true;
+		cout << "Lista de objetos recarregada: " << objects.size() << " objetos" << endl;
+		print_texture_usage();
+	}
+
+	if (config.vertexShaderPath != previous.vertexShaderPath ||
+		config.fragmentShaderPath != previous.fragmentShaderPath) {
+		lock_guard<mutex> guard(reload.lock);
+		reload.shadersChanged = true;
+	}
+	watch_scene_files(reload, scene, objects, config);
+
+	if (config.windowWidth != previous.windowWidth || config.windowHeight != previous.windowHeight ||
+		config.loaderThreads != previous.loaderThreads || config.indexedGeometry != previous.indexedGeometry ||
+		config.meshCache != previous.meshCache || config.textureArrays != previous.textureArrays) {
+		cout << "Janela e opcoes de carregamento alteradas valem apenas ao reiniciar" << endl;
 	}
-	shader.setFloat("ns", material.Ns);
-	shader.setFloat("ni", material.Ni);
-	shader.setFloat("d", material.d);
-	shader.setInt("illum", material.illum);
+	return materialsChanged;
 }
 
-// Função para atualizar os valores das matrizes modelo e projeção do objeto para movimentação.
-void update_object_matrix_to_move(int object_id, glm::mat4& model, glm::mat4& projection, float& zoom,
-								  float window_width, float window_height) {
+// Função para calcular a escala em clip space equivalente a trocar o campo de visão da câmera (45 graus) por
+// 45 + zoom: as duas projeções só diferem nos termos de x e y, na razão entre as tangentes dos meios ângulos.
+float zoom_clip_scale(float zoom) {
+	return tan(glm::radians(45.0f) / 2.0f) / tan(glm::radians(45.0f + zoom) / 2.0f);
+}
+
+// Função para atualizar a matriz modelo e o zoom do objeto para movimentação.
+void update_object_matrix_to_move(int object_id, glm::mat4& model, float& zoom) {
 	if (object_id != selected_object_id) {
 		return;
 	}
@@ -474,101 +1027,190 @@ void update_object_matrix_to_move(int object_id, glm::mat4& model, glm::mat4& pr
 			break;
 	}
 
-	// Apply zoom to the projection matrix
-	if (currentRotationState == ZOOM_IN || currentRotationState == ZOOM_OUT) {
-		projection = glm::perspective(glm::radians(45.0f + zoom), window_width / window_height, 0.1f, 100.0f);
-	}
-
 	// Reset the rotation state after applying the transformation
 	currentRotationState = ROTATE_NONE;
 }
 
-// Função para renderizar o objeto.
-void handle_object_render(Shader& shader, Mesh object, glm::mat4& model, glm::mat4& projection, float& zoom,
-						  GLuint texture_id, Material material, int window_width, int window_height) {
-	// Atualização das matrizes de modelo e projeção.
-	update_object_matrix_to_move(object.getId(), model, projection, zoom, (float)window_width, (float)window_height);
-	shader.setMat4("model", glm::value_ptr(model));
-	shader.setMat4("projection", glm::value_ptr(projection));
+// Função para atualizar a matriz modelo do objeto (movimentação e órbita). O objeto é enfileirado depois, se estiver
+// visível, por enqueue_visible_entities.
+// orbitAngle: ângulo atual da órbita dos objetos com orbit_radius.
+void update_object_transform(SceneObject& object, float orbitAngle) {
+	glm::mat4 previous = object.mesh.getModel();
+	// Atualização da matriz de modelo e do zoom.
+	update_object_matrix_to_move(object.mesh.getId(), object.model, object.zoom);
+
+	if (object.orbitRadius > 0.0f) {
+		// Órbita circular em torno do eixo y, girando o objeto em torno do próprio eixo.
+		glm::vec3 translation(object.orbitRadius * cos(orbitAngle), object.orbitHeight,
+							  object.orbitRadius * sin(orbitAngle));
+		glm::mat4 orbit = glm::translate(glm::mat4(1.0f), translation) *
+						  glm::rotate(glm::mat4(1.0f), glm::radians(orbitAngle), glm::vec3(0.0f, 1.0f, 0.0f));
+		object.mesh.update(orbit * object.model);
+	} else {
+		object.mesh.update(object.model);
+	}
+	if (object.mesh.getModel() != previous) {
+		object.boundsChanged = true;
+	}
+}
+
+// Índice espacial das entidades da cena: os objetos (entidade i = objects[i]) seguidos das instâncias do teste de carga
+// (entidade objects.size() + i = stressModels[i]). O proxy de cada entidade na BVH é o seu índice.
+struct SceneIndex {
+	DynamicBvh bvh;
+	vector<uint8_t> objectVisible;
+};
+
+// Função para obter a Mesh da instância i do teste de carga: alterna entre os dois primeiros objetos (cubo e suzanne).
+Mesh& stress_mesh(vector<SceneObject>& objects, size_t i) {
+	return objects[min(i % 2, objects.size() - 1)].mesh;
+}
+
+// Função para refazer o índice com as caixas atuais de todas as entidades (SAH).
+void build_scene_index(SceneIndex& index, vector<SceneObject>& objects, const vector<glm::mat4>& stressModels) {
+	vector<Aabb> boxes;
+	boxes.reserve(objects.size() + stressModels.size());
+	for (SceneObject& object : objects) {
+		boxes.push_back(object.mesh.getBounds());
+		object.boundsChanged = false;
+	}
+	for (size_t i = 0; i < stressModels.size(); i++) {
+		const MeshGeometry& geometry = stress_mesh(objects, i).getBatch()->getGeometry();
+		boxes.push_back(transform_aabb(stressModels[i], geometry.center, geometry.extent));
+	}
+	index.bvh.build(boxes);
+}
 
-	// Definição do material da superficie (textura).
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture_id);
-	glUniform1i(glGetUniformLocation(shader.ID, "diffuseMap"), texture_id);
+// Função para levar ao índice as caixas dos objetos que se moveram desde a última atualização. Poucos objetos reajustam
+// só os próprios ancestrais (update); quando esses caminhos somam mais que a árvore inteira, as caixas são trocadas e
+// a árvore é reajustada uma vez (setBounds e refit).
+void update_scene_index(SceneIndex& index, vector<SceneObject>& objects) {
+	vector<int> changed;
+	for (size_t i = 0; i < objects.size(); i++) {
+		if (objects[i].boundsChanged) {
+			changed.push_back((int)i);
+			objects[i].boundsChanged = false;
+		}
+	}
+	if ((size_t)index.bvh.getHeight() * changed.size() <= 2 * (size_t)index.bvh.size()) {
+		for (int i : changed) {
+			index.bvh.update(i, objects[i].mesh.getBounds());
+		}
+	} else {
+		for (int i : changed) {
+			index.bvh.setBounds(i, objects[i].mesh.getBounds());
+		}
+		index.bvh.refit();
+	}
+}
 
-	// Setando valores de iluminação para o shader.
-	setMaterialProperties(shader, material, object.getId() == selected_object_id);
+// Função para enfileirar nos lotes as entidades que tocam o frustum, consultadas na BVH (todas, sem frustum.enabled).
+// Objetos com um zoom que afasta são sempre enfileirados: podem aparecer na tela vindos de fora do frustum da câmera.
+// Soma em stats as entidades descartadas e os triângulos que elas teriam na malha completa.
+void enqueue_visible_entities(SceneIndex& index, vector<SceneObject>& objects, const vector<glm::mat4>& stressModels,
+							  const Frustum& frustum, DrawStats& stats) {
+	size_t visibleCount = 0, visibleTriangles = 0;
+	index.objectVisible.assign(objects.size(), 0);
+	index.bvh.queryFrustum(frustum, [&](uint32_t entity) {
+		if (entity < objects.size()) {
+			index.objectVisible[entity] = 1;
+			return;
+		}
+		size_t i = entity - objects.size();
+		Mesh& mesh = stress_mesh(objects, i);
+		mesh.getBatch()->add(stressModels[i], false, 1.0f, mesh.getTextureLayer());
+		visibleCount++;
+		visibleTriangles += mesh.getBatch()->getFullTriangles();
+	});
+
+	size_t totalTriangles = 0;
+	for (size_t i = 0; i < objects.size(); i++) {
+		Mesh& mesh = objects[i].mesh;
+		float zoomScale = zoom_clip_scale(objects[i].zoom);
+		totalTriangles += mesh.getBatch()->getFullTriangles();
+		if (index.objectVisible[i] || zoomScale < 1.0f) {
+			mesh.draw(mesh.getId() == selected_object_id, zoomScale);
+			visibleCount++;
+			visibleTriangles += mesh.getBatch()->getFullTriangles();
+		}
+	}
+	// As instâncias do teste de carga se alternam entre os dois primeiros objetos.
+	if (!stressModels.empty()) {
+		size_t evenCount = (stressModels.size() + 1) / 2;
+		totalTriangles += evenCount * stress_mesh(objects, 0).getBatch()->getFullTriangles() +
+						  (stressModels.size() - evenCount) * stress_mesh(objects, 1).getBatch()->getFullTriangles();
+	}
 
-	// Associando o buffer de textura ao shader (será usado no fragment shader).
-	shader.setInt("tex_buffer", 0);
+	stats.culledObjects += objects.size() + stressModels.size() - visibleCount;
+	stats.culledTriangles += totalTriangles - visibleTriangles;
+}
 
-	// Chamada de desenho - drawcall.
-	object.update(model);
-	object.draw();
+// Função para testar a semirreta (no mundo) contra os triângulos de um objeto (TriangleBvh.h: intersect_instance).
+// Retorna true se acertar antes de distance, que recebe a distância do acerto.
+bool pick_object(Mesh& mesh, const Ray& ray, float& distance) {
+	const MeshGeometry& geometry = mesh.getBatch()->getGeometry();
+	if (!geometry.triangles) {
+		return false;
+	}
+	uint32_t triangle;
+	return intersect_instance(*geometry.triangles, mesh.getModel(), ray, distance, triangle);
+}
 
-	// Desvincular a textura.
-	glBindTexture(GL_TEXTURE_2D, 0);
+// Função para escolher o objeto visível no ponto da tela point (em NDC). A semirreta da câmera percorre a BVH das
+// entidades das mais próximas para as mais distantes e cada objeto atravessado é testado nos seus triângulos; o acerto
+// mais próximo descarta os nós além dele. Objetos com zoom são desenhados com outro campo de visão e recebem a própria
+// semirreta (o ponto dividido pela escala do zoom). As instâncias do teste de carga não são selecionáveis. Retorna o id
+// do objeto atingido ou CAMERA_ID.
+int pick_scene_object(const SceneIndex& index, vector<SceneObject>& objects, glm::vec2 point,
+					  const glm::mat4& viewProjection) {
+	Ray ray = unproject_ray(point, viewProjection);
+	float closest = FLT_MAX;
+	int picked = CAMERA_ID;
+	index.bvh.queryRay(ray, closest, [&](uint32_t entity, float, float maxDistance) {
+		if (entity < objects.size() && objects[entity].zoom == 0.0f &&
+			pick_object(objects[entity].mesh, ray, maxDistance)) {
+			closest = maxDistance;
+			picked = objects[entity].mesh.getId();
+		}
+		return maxDistance;
+	});
+
+	for (SceneObject& object : objects) {
+		if (object.zoom != 0.0f) {
+			Ray zoomed = unproject_ray(point / zoom_clip_scale(object.zoom), viewProjection);
+			if (pick_object(object.mesh, zoomed, closest)) {
+				picked = object.mesh.getId();
+			}
+		}
+	}
+	return picked;
 }
 
 // Função principal do programa.
 int main() {
-	Config cfg;
-	read_config(cfg, "config.txt");
+	// Configuração interpretada uma única vez; alterações no arquivo chegam como novos snapshots.
+	string config_error;
+	if (!config_store.load("config.txt", config_error)) {
+		cerr << config_error << endl;
+		exit(EXIT_FAILURE);
+	}
+	shared_ptr<const AppConfig> config = config_store.get();
 
 	// Window
-	GLint window_width = cfg.lookup("window_width");
-	GLint window_height = cfg.lookup("window_height");
-	const char* window_title = cfg.lookup("window_title");
+	GLint window_width = config->windowWidth;
+	GLint window_height = config->windowHeight;
+	const char* window_title = config->windowTitle.c_str();
 
 	// Camera
-	fov = cfg.lookup("fov");
-	glm::vec3 camera_position((float)cfg.lookup("position")[0], (float)cfg.lookup("position")[1],
-							  (float)cfg.lookup("position")[2]);
-	glm::vec3 camera_orientation((float)cfg.lookup("orientation")[0], (float)cfg.lookup("orientation")[1],
-								 (float)cfg.lookup("orientation")[2]);
-
-	glm::vec3 camera_view_x((float)cfg.lookup("view_x")[0], (float)cfg.lookup("view_x")[1],
-							(float)cfg.lookup("view_x")[2]);
-	glm::vec3 camera_view_y((float)cfg.lookup("view_y")[0], (float)cfg.lookup("view_y")[1],
-							(float)cfg.lookup("view_y")[2]);
-	glm::vec3 camera_view_z((float)cfg.lookup("view_z")[0], (float)cfg.lookup("view_z")[1],
-							(float)cfg.lookup("view_z")[2]);
+	fov = config->fov;
+	glm::vec3 camera_position = config->cameraPosition;
+	glm::vec3 camera_view_x = config->viewX;
+	glm::vec3 camera_view_y = config->viewY;
+	glm::vec3 camera_view_z = config->viewZ;
 
 	// Shaders
-	const char* vertex_shader_path = cfg.lookup("vertex_shader_path");
-	const char* fragment_shader_path = cfg.lookup("fragment_shader_path");
-
-	// Object 1
-	const Setting& obj1_config = cfg.lookup("object1");
-	glm::vec3 obj1_position((float)obj1_config.lookup("position")[0], (float)obj1_config.lookup("position")[1],
-							(float)obj1_config.lookup("position")[2]);
-	glm::vec3 obj1_scale((float)obj1_config.lookup("scale")[0], (float)obj1_config.lookup("scale")[1],
-						 (float)obj1_config.lookup("scale")[2]);
-	float obj1_zoom = obj1_config.lookup("zoom");
-
-	// Object 2
-	const Setting& obj2_config = cfg.lookup("object2");
-	glm::vec3 obj2_position((float)obj2_config.lookup("position")[0], (float)obj2_config.lookup("position")[1],
-							(float)obj2_config.lookup("position")[2]);
-	glm::vec3 obj2_scale((float)obj2_config.lookup("scale")[0], (float)obj2_config.lookup("scale")[1],
-						 (float)obj2_config.lookup("scale")[2]);
-	float obj2_zoom = obj2_config.lookup("zoom");
-
-	// Object 3
-	const Setting& obj3_config = cfg.lookup("object3");
-	glm::vec3 obj3_position((float)obj3_config.lookup("position")[0], (float)obj3_config.lookup("position")[1],
-							(float)obj3_config.lookup("position")[2]);
-	glm::vec3 obj3_scale((float)obj3_config.lookup("scale")[0], (float)obj3_config.lookup("scale")[1],
-						 (float)obj3_config.lookup("scale")[2]);
-	float obj3_zoom = obj3_config.lookup("zoom");
-
-	// Object 4
-	const Setting& obj4_config = cfg.lookup("object4");
-	glm::vec3 obj4_position((float)obj4_config.lookup("position")[0], (float)obj4_config.lookup("position")[1],
-							(float)obj4_config.lookup("position")[2]);
-	glm::vec3 obj4_scale((float)obj4_config.lookup("scale")[0], (float)obj4_config.lookup("scale")[1],
-						 (float)obj4_config.lookup("scale")[2]);
-	float obj4_zoom = obj4_config.lookup("zoom");
+	const char* vertex_shader_path = config->vertexShaderPath.c_str();
+	const char* fragment_shader_path = config->fragmentShaderPath.c_str();
 
 	// Inicializar GLFW.
 	glfwInit();
@@ -594,6 +1236,9 @@ int main() {
 	// Registrar função de callback via mouse para a janela GLFW.
 	glfwSetCursorPosCallback(window, mouse_callback);
 
+	// Registrar função de callback via botões do mouse (seleção dos objetos).
+	glfwSetMouseButtonCallback(window, mouse_button_callback);
+
 	// Registrar função de callback via scroll para a janela GLFW.
 	glfwSetScrollCallback(window, scroll_callback);
 
@@ -622,76 +1267,116 @@ int main() {
 	// Obter a configuração do Program Shader.
 	Shader shader(vertex_shader_path, fragment_shader_path);
 
-	// Vincular o program shader.
-	glUseProgram(shader.ID);
-
-	// Carregar a texturas.
-	GLuint obj1_texID = load_texture(obj1_config.lookup("texture_path"));
-	GLuint obj2_texID = load_texture(obj2_config.lookup("texture_path"));
-	GLuint obj3_texID = load_texture(obj3_config.lookup("texture_path"));
-	GLuint obj4_texID = load_texture(obj4_config.lookup("texture_path"));
+	// Vincular o program shader aos blocos uniformes (dados por quadro e materiais) e à unidade de textura 0.
+	setup_shader(shader);
+	FrameBlockData frame_block;
+	UniformBuffer frame_buffer;
+	frame_buffer.initialize(FRAME_BLOCK_BINDING, sizeof(FrameBlockData));
 
 	// Câmera.
 	camera.initialize((float)window_width, (float)window_height);
 	camera.setCameraPosition(camera_position);
 	camera.setCameraProjection(camera_view_x, camera_view_y, camera_view_z);
 
-	// Matriz de visualização (posição e orientação da câmera).
-	glm::mat4 cameraView = camera.getCameraView();
-	shader.setMat4("view", glm::value_ptr(cameraView));
-
 	// Matriz de perspectiva (definindo o volume de visualização - frustum).
-	glm::mat4 cameraProjection = camera.getCameraProjection();
-	shader.setMat4("projection", glm::value_ptr(cameraProjection));
+	// A matriz de visualização é atualizada a cada quadro.
+	frame_block.projection = camera.getCameraProjection();
 
 	// Habilita teste de profundidade.
 	glEnable(GL_DEPTH_TEST);
 
-	// Carregar a geometria armazenada.
-	int nVertsObj1, nVertsObj2, nVertsObj3, nVertsObj4;
-	GLuint VAO1 = load_simple_obj(obj1_config.lookup("obj_path"), nVertsObj1, glm::vec3(1.0, 0.0, 0.0));
-	GLuint VAO2 = load_simple_obj(obj2_config.lookup("obj_path"), nVertsObj2, glm::vec3(0.0, 1.0, 0.0));
-	GLuint VAO3 = load_simple_obj(obj3_config.lookup("obj_path"), nVertsObj3, glm::vec3(1.0, 1.0, 0.0));
-	GLuint VAO4 = load_simple_obj(obj4_config.lookup("obj_path"), nVertsObj4, glm::vec3(1.0, 1.0, 0.0));
-
-	// Definir a malha dos objetos.
-	Mesh obj1_mesh, obj2_mesh, obj3_mesh, obj4_mesh;
-	obj1_mesh.initialize(1, VAO1, nVertsObj1, &shader, obj1_position, obj1_scale, obj1_config.lookup("rotation"));
-	obj2_mesh.initialize(2, VAO2, nVertsObj2, &shader, obj2_position, obj2_scale, obj2_config.lookup("rotation"));
-	obj3_mesh.initialize(3, VAO3, nVertsObj3, &shader, obj3_position, obj3_scale, obj3_config.lookup("rotation"));
-	obj4_mesh.initialize(4, VAO4, nVertsObj4, &shader, obj4_position, obj4_scale, obj4_config.lookup("rotation"));
-
-	// Definiar material dos objetos
-	Material obj1_material = parseMTL(getMTLFilePath(obj1_config.lookup("obj_path")));
-	Material obj2_material = parseMTL(getMTLFilePath(obj2_config.lookup("obj_path")));
-	Material obj3_material = parseMTL(getMTLFilePath(obj3_config.lookup("obj_path")));
-	Material obj4_material = parseMTL(getMTLFilePath(obj4_config.lookup("obj_path")));
+	// Recarga dos arquivos alterados. Declarada antes do pool: as tarefas de leitura usam a estrutura até o fim.
+	HotReload hot_reload;
+
+	// Pool de threads para a leitura dos arquivos OBJ (0 = número de núcleos).
+	ThreadPool loader_pool(config->loaderThreads);
+
+	// Geometria indexada (EBO) ou expandida (um vértice por canto de face), com ou sem o cache binário.
+	ObjLoadOptions load_options;
+	load_options.pool = &loader_pool;
+	load_options.indexed = config->indexedGeometry;
+	load_options.cache = config->meshCache;
+	load_options.printStats = config->printStats;
+
+	// As texturas são decodificadas no mesmo pool e enviadas a cada quadro (texture_upload_kb por quadro); com
+	// texture_arrays, as de mesmo formato e dimensões são camadas de um mesmo array.
+	texture_streamer.initialize(&loader_pool);
+	texture_manager.initialize(&texture_streamer, config->textureArrays);
+
+	// Carregar a geometria e as texturas: objetos com o mesmo OBJ e a mesma textura compartilham um lote de instâncias.
+	auto load_start = chrono::steady_clock::now();
+	SceneResources scene;
+	vector<SceneObject> objects;
+	load_scene_objects(config->objects, scene, shader, load_options, objects);
+	SceneIndex scene_index;
+	cout << "Cena carregada em " << chrono::duration<double, milli>(chrono::steady_clock::now() - load_start).count()
+		 << " ms: " << objects.size() << " objetos, " << scene.geometries.size() << " malhas, "
+		 << texture_manager.getUsage().size() << " texturas, " << scene.batches.size() << " lotes" << endl;
+	bool textures_ready = false;
+
+	// Materiais de todas as malhas enviados uma única vez; cada lote guarda a posição dos seus no bloco.
+	vector<MaterialBlockData> scene_materials = scene.materials;
+	scene_materials.resize(MAX_MATERIALS);
+	UniformBuffer material_buffer;
+	material_buffer.initialize(MATERIAL_BLOCK_BINDING, scene_materials.size() * sizeof(MaterialBlockData),
+							   scene_materials.data());
+
+	// Cena de teste de carga: instâncias extras dos lotes dos dois primeiros objetos (cubo e suzanne), alternadas.
+	vector<glm::mat4> stress_models;
+	if (!objects.empty()) {
+		build_stress_scene(config->stressInstances, stress_models);
+	}
+	DrawStats draw_stats;
+
+	// Fila de desenhos do quadro e cópia do estado da OpenGL usada para não repetir vínculos.
+	RenderQueue render_queue;
+	GlStateCache gl_state;
 
 	// Definindo a fonte de luz pontual
-	shader.setVec3("lightPos", cfg.lookup("light_pos")[0], cfg.lookup("light_pos")[1], cfg.lookup("light_pos")[2]);
-	shader.setVec3("lightColor", cfg.lookup("light_color")[0], cfg.lookup("light_color")[1],
-				   cfg.lookup("light_color")[2]);
+	set_frame_light(frame_block, *config);
 
-	float planetRotationAngle = 0.0f;
-	glm::vec3 planetTranslation(0.0f, 0.0f, 0.0f);
+	// Ângulo da órbita dos objetos com orbit_radius.
+	float orbitAngle = 0.0f;
 
-	// Declaração das matrizes de cada objeto.
-	// Para que não percam a posição do último movimento quando não estiverem selecionados para movimentação.
-	glm::mat4 obj1_model = glm::mat4(1);
-	glm::mat4 obj2_model = glm::mat4(1);
-	glm::mat4 obj3_model = glm::mat4(1);
-	glm::mat4 obj4_model = glm::mat4(1);
+	// Estatísticas de desenho (tempo de GPU por quadro, medido quando print_stats está ligado).
+	GpuTimer draw_timer;
+	draw_timer.initialize();
 
-	glm::mat4 obj1_projection = camera.getCameraProjection();
-	glm::mat4 obj2_projection = camera.getCameraProjection();
-	glm::mat4 obj3_projection = camera.getCameraProjection();
-	glm::mat4 obj4_projection = camera.getCameraProjection();
+	// A partir daqui o config.txt, os shaders e os arquivos da cena são observados e relidos em segundo plano.
+	config_store.startWatching();
+	watch_scene_files(hot_reload, scene, objects, *config);
+	start_hot_reload(hot_reload, load_options);
 
 	// Laço principal da execução.
 	while (!glfwWindowShouldClose(window)) {
 		// Checar e tratar eventos de input.
 		glfwPollEvents();
 
+		// Nova versão da configuração publicada pelo observador: aplica apenas as diferenças.
+		shared_ptr<const AppConfig> latest_config = config_store.get();
+		bool materials_changed = false;
+		if (latest_config != config) {
+			materials_changed = apply_config_changes(*config, *latest_config, frame_block, objects, stress_models,
+													 scene, shader, hot_reload);
+			config = latest_config;
+		}
+
+		// Alocação dos arrays de texturas e envio de mais uma parte das texturas lidas.
+		texture_manager.update();
+		texture_streamer.update((size_t)config->textureUploadKb * 1024);
+		if (!textures_ready && texture_streamer.getPendingCount() == 0) {
+			textures_ready = true;
+			cout << "Texturas enviadas em "
+				 << chrono::duration<double, milli>(chrono::steady_clock::now() - load_start).count() << " ms" << endl;
+			print_texture_usage();
+		}
+
+		// Shaders, malhas e texturas alterados no disco: trocados aqui, entre um quadro e outro.
+		materials_changed |= apply_hot_reload(hot_reload, scene, shader, *config);
+		if (materials_changed) {
+			update_material_buffer(material_buffer, scene);
+		}
+
 		// Limpar o buffer de cor.
 		glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -702,81 +1387,96 @@ int main() {
 
 		// Atualizar a posição e orientação da câmera.
 		camera.recalculateCameraView();
-		glm::mat4 cameraView = camera.getCameraView();
-		shader.setMat4("view", glm::value_ptr(cameraView));
-
-		// Atualizar o shader com a posição da câmera.
-		glm::vec3 cameraPosition = camera.getCameraPosition();
-		shader.setVec3("cameraPos", cameraPosition.x, cameraPosition.y, cameraPosition.z);
-
-		// Renderização do Objeto 1.
-		handle_object_render(shader, obj1_mesh, obj1_model, obj1_projection, obj1_zoom, obj1_texID, obj1_material,
-							 window_width, window_height);
-
-		// Renderização do Objeto 2.
-		handle_object_render(shader, obj2_mesh, obj2_model, obj2_projection, obj2_zoom, obj2_texID, obj2_material,
-							 window_width, window_height);
-
-		// Renderização do Objeto 3.
-		handle_object_render(shader, obj3_mesh, obj3_model, obj3_projection, obj3_zoom, obj3_texID, obj3_material,
-							 window_width, window_height);
+		frame_block.view = camera.getCameraView();
 
-		// Renderização do Objeto 4.
-		// Definição do material da superfície (textura).
-		update_object_matrix_to_move(4, obj4_model, obj4_projection, obj4_zoom, window_width, window_height);
-		shader.setMat4("model", glm::value_ptr(obj4_model));
-		shader.setMat4("projection", glm::value_ptr(obj4_projection));
+		// Atualizar o bloco do quadro com a posição da câmera (um único envio por quadro).
+		frame_block.cameraPos = glm::vec4(camera.getCameraPosition(), 1.0f);
+		frame_buffer.update(&frame_block, sizeof(frame_block));
 
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, obj4_texID);
-		glUniform1i(glGetUniformLocation(shader.ID, "diffuseMap"), obj4_texID);
-
-		// Setando os valores de iluminação para o shader.
-		setMaterialProperties(shader, obj4_material, false);
-
-		// Associando o buffer de textura ao shader (será usado no fragment shader).
-		shader.setInt("tex_buffer", 0);
-
-		// Calculando ângulo de rotação do objeto
-		planetRotationAngle += 0.01f;
-		if (planetRotationAngle > 360.0f) {
-			planetRotationAngle -= 360.0f;
+		// Início da medição do tempo de GPU dos objetos.
+		if (config->printStats) {
+			draw_timer.begin();
 		}
 
-		// Criação de uma órbita circular.
-		float orbitRadius = 10.0f;
-		planetTranslation.x = orbitRadius * cos(planetRotationAngle);
-		planetTranslation.z = orbitRadius * sin(planetRotationAngle);
-		planetTranslation.y = 3.0f;
-
-		// Criando matrizes de Rotação e Transalação.
-		glm::mat4 rotation =
-			glm::rotate(glm::mat4(1.0f), glm::radians(planetRotationAngle), glm::vec3(0.0f, 1.0f, 0.0f));
-		glm::mat4 translation = glm::translate(glm::mat4(1.0f), planetTranslation);
+		// Calculando ângulo de rotação dos objetos em órbita.
+		orbitAngle += 0.01f;
+		if (orbitAngle > 360.0f) {
+			orbitAngle -= 360.0f;
+		}
 
-		// Aplicando a transformação a partir da translação e rotação.
-		glm::mat4 planetTransform = translation * rotation;
-		float modelArray[16];
-		memcpy(modelArray, glm::value_ptr(planetTransform * glm::scale(glm::mat4(1.0f), obj4_scale)),
-			   sizeof(float) * 16);
-		shader.setMat4("model", modelArray);
-		shader.setMat4("projection", glm::value_ptr(obj4_projection));
+		// Movimentação dos objetos. Só as caixas dos objetos que se moveram são reajustadas na BVH; objetos, instâncias
+		// do teste de carga ou geometrias novos refazem o índice inteiro.
+		for (SceneObject& object : objects) {
+			update_object_transform(object, orbitAngle);
+		}
+		if (scene.entitiesChanged) {
+			build_scene_index(scene_index, objects, stress_models);
+			scene.entitiesChanged = false;
+		} else {
+			update_scene_index(scene_index, objects);
+		}
 
-		// Chamada de desenho - drawcall.
-		obj4_mesh.draw();
+		// Seleção com o mouse pedida desde o último quadro, com as caixas e a câmera deste quadro. O tempo da seleção
+		// sai com as outras estatísticas (print_stats).
+		if (pick_requested) {
+			pick_requested = false;
+			auto pick_start = chrono::steady_clock::now();
+			selected_object_id =
+				pick_scene_object(scene_index, objects, pick_point, frame_block.projection * frame_block.view);
+			double pick_ms = chrono::duration<double, milli>(chrono::steady_clock::now() - pick_start).count();
+			if (config->printStats) {
+				if (selected_object_id == CAMERA_ID) {
+					cout << "Selecionada a camera (" << pick_ms << " ms)" << endl;
+				} else {
+					cout << "Selecionado o objeto " << selected_object_id << " (" << pick_ms << " ms)" << endl;
+				}
+			}
+		}
 
-		// Desvincunlar a textura.
-		glBindTexture(GL_TEXTURE_2D, 0);
+		// Entidades visíveis enfileiradas nos lotes das suas geometrias. Com scene_bvh, as que estão fora do frustum da
+		// câmera saem na consulta à BVH; sem ela, todas chegam aos lotes e cada lote testa as suas instâncias.
+		draw_stats = DrawStats();
+		Frustum frustum;
+		if (config->frustumCulling) {
+			frustum = frustum_from_matrix(frame_block.projection * frame_block.view);
+		}
+		enqueue_visible_entities(scene_index, objects, stress_models, config->sceneBvh ? frustum : Frustum(),
+								 draw_stats);
+
+		// Chamadas de desenho - drawcalls: todas as instâncias visíveis de cada lote e nível de detalhe de uma vez,
+		// ordenadas por estado. O nível de cada objeto vem do tamanho projetado com a projeção da câmera.
+		LodSelection lod = lod_selection(frame_block.projection, (float)window_height, camera.getCameraPosition(),
+										 config->lodPixelError);
+		draw_scene_batches(scene, render_queue, gl_state, config->renderQueue, config->instancing, lod,
+						   config->sceneBvh ? Frustum() : frustum, draw_stats);
+
+		// Fim da medição e impressão periódica do tempo médio de desenho.
+		if (config->printStats) {
+			draw_timer.end();
+			if (draw_timer.getSamples() >= 300) {
+				cout << "Tempo de GPU dos objetos: " << draw_timer.takeAverageMs() << " ms/quadro, "
+					 << draw_stats.drawCalls << " chamadas de desenho, " << draw_stats.binds << " vinculos de estado ("
+					 << draw_stats.skippedBinds << " evitados), " << draw_stats.triangles << " triangulos, "
+					 << draw_stats.culledObjects << " objetos (" << draw_stats.culledTriangles
+					 << " triangulos) fora do frustum" << endl;
+			}
+		}
 
 		// Troca os buffers da tela
 		glfwSwapBuffers(window);
 	}
 
-	// Deleta VAO para desalocar buffer.
-	glDeleteVertexArrays(1, &VAO1);
-	glDeleteVertexArrays(1, &VAO2);
-	glDeleteVertexArrays(1, &VAO3);
-	glDeleteVertexArrays(1, &VAO4);
+	config_store.stopWatching();
+	hot_reload.watcher.stop();
+
+	// Deleta lotes, VAOs e texturas para desalocar os buffers (as texturas saem com a última referência, nos objetos).
+	destroy_scene(scene);
+	objects.clear();
+	texture_manager.destroy();
+	texture_streamer.destroy();
+	draw_timer.destroy();
+	frame_buffer.destroy();
+	material_buffer.destroy();
 
 	// Finalizar execução da GLFW.
 	glfwTerminate();
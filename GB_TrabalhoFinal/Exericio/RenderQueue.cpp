@@ -0,0 +1,66 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cstring>
+
+uint64_t render_sort_key(uint32_t program, uint32_t texture, uint32_t mesh, float depth, uint32_t material) {
+	uint32_t depthBits;
+	depth = std::max(depth, 0.0f);
+	memcpy(&depthBits, &depth, sizeof(depthBits));
+	// Floats positivos têm a mesma ordem dos seus bits como inteiros.
+	return (uint64_t)(program & 0xFF) << 56 | (uint64_t)(texture & 0xFFFF) << 40 | (uint64_t)(mesh & 0xFFFF) << 24 |
+		   (uint64_t)(depthBits >> 16) << 8 | (material & 0xFF);
+}
+
+// Abaixo disso as passadas do radix custam mais que uma ordenação por comparação, que ainda aproveita os itens de cada
+// lote já chegarem juntos (bench/render_queue_bench: empate por volta de 2 mil chaves).
+const size_t RADIX_MIN_KEYS = 2048;
+
+void radix_sort_keys(std::vector<RenderKey>& keys, std::vector<RenderKey>& scratch) {
+	const int DIGITS = 8;
+	size_t count = keys.size();
+	if (count < RADIX_MIN_KEYS) {
+		std::stable_sort(keys.begin(), keys.end(),
+						 [](const RenderKey& a, const RenderKey& b) { return a.key < b.key; });
+		return;
+	}
+
+	// Dígitos que variam entre as chaves (os demais não mudam a ordem) e os histogramas deles em uma única leitura.
+	uint64_t first = keys[0].key, differing = 0;
+	for (const RenderKey& key : keys) {
+		differing |= key.key ^ first;
+	}
+	int digits[DIGITS], digitCount = 0;
+	for (int digit = 0; digit < DIGITS; digit++) {
+		if ((differing >> (8 * digit)) & 0xFF) {
+			digits[digitCount++] = digit;
+		}
+	}
+	uint32_t histograms[DIGITS][256] = {};
+	for (const RenderKey& key : keys) {
+		for (int d = 0; d < digitCount; d++) {
+			histograms[d][(key.key >> (8 * digits[d])) & 0xFF]++;
+		}
+	}
+
+	scratch.resize(count);
+	RenderKey* source = keys.data();
+	RenderKey* target = scratch.data();
+	for (int d = 0; d < digitCount; d++) {
+		uint32_t* histogram = histograms[d];
+		uint32_t offset = 0;
+		for (int bucket = 0; bucket < 256; bucket++) {
+			uint32_t bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+		int shift = 8 * digits[d];
+		for (size_t i = 0; i < count; i++) {
+			target[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+		}
+		std::swap(source, target);
+	}
+	if (source != keys.data()) {
+		keys.swap(scratch);
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class MeshBatch;
+
+// Chave de ordenação de um desenho, comparada como inteiro: programa (8 bits), textura (16), geometria (16),
+// profundidade (16) e material (8), do estado mais caro de trocar para o mais barato. A profundidade vem antes do
+// material porque os materiais são só um uniform (o índice no MaterialBlock): os itens de um mesmo grupo de instâncias
+// ficam juntos (os atributos de instância são apontados uma vez) e os grupos saem da frente para trás. Os nomes da
+// OpenGL entram truncados; nomes que coincidem nos bits guardados só deixam de ficar juntos.
+// depth: distância até a câmera (>= 0), guardada com os 16 bits mais altos do float (precisão relativa de 1/128).
+uint64_t render_sort_key(uint32_t program, uint32_t texture, uint32_t mesh, float depth, uint32_t material);
+
+// Desenho enfileirado por um lote: instâncias [first, first + count) do buffer de instâncias do lote, no nível de
+// detalhe level, faixa de material range do nível (-1 = malha inteira).
+struct RenderItem {
+	MeshBatch* batch;
+	uint32_t first;
+	uint32_t count;
+	int level;
+	int range;
+};
+
+struct RenderKey {
+	uint64_t key;
+	uint32_t item;
+};
+
+// Ordena keys por key, de forma estável: radix sort LSD com dígitos de 8 bits (std::stable_sort nas filas pequenas). As
+// passadas em que todas as chaves têm o mesmo dígito (ex.: o programa, quase sempre único) são puladas. scratch é o
+// buffer auxiliar, reaproveitado.
+void radix_sort_keys(std::vector<RenderKey>& keys, std::vector<RenderKey>& scratch);
+
+// Fila de desenhos de um quadro: os lotes adicionam os seus itens com as chaves, a fila os ordena e os desenhos saem
+// na ordem das chaves (MeshBatch.h: draw_render_queue), trocando o mínimo de estado.
+class RenderQueue {
+   public:
+	void clear() {
+		items.clear();
+		keys.clear();
+	}
+
+	void add(uint64_t key, const RenderItem& item) {
+		keys.push_back({key, (uint32_t)items.size()});
+		items.push_back(item);
+	}
+
+	// Sem sort, os itens ficam na ordem em que foram adicionados.
+	void sort() { radix_sort_keys(keys, scratch); }
+
+	size_t size() const { return keys.size(); }
+	const RenderItem& operator[](size_t i) const { return items[keys[i].item]; }
+
+   protected:
+	std::vector<RenderItem> items;
+	std::vector<RenderKey> keys;
+	std::vector<RenderKey> scratch;
+};
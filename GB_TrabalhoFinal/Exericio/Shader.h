@@ -7,6 +7,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 //GLAD
 #include <glad/glad.h>
@@ -16,6 +19,40 @@
 
 using namespace std;
 
+// Handles tipados de uniform: a localizao  resolvida uma nica vez (Shader::getUniform) e o envio por quadro no
+// faz consulta ao driver nem comparao de strings. Uniforms inexistentes (ou eliminados pelo compilador) ficam com
+// localizao -1 e so ignorados.
+struct UniformInt
+{
+	GLint location = -1;
+	void set(int value) const { if (location >= 0) glUniform1i(location, value); }
+};
+
+struct UniformFloat
+{
+	GLint location = -1;
+	void set(float value) const { if (location >= 0) glUniform1f(location, value); }
+};
+
+struct UniformVec3
+{
+	GLint location = -1;
+	void set(float v1, float v2, float v3) const { if (location >= 0) glUniform3f(location, v1, v2, v3); }
+	void set(const float* v) const { if (location >= 0) glUniform3fv(location, 1, v); }
+};
+
+struct UniformVec4
+{
+	GLint location = -1;
+	void set(float v1, float v2, float v3, float v4) const { if (location >= 0) glUniform4f(location, v1, v2, v3, v4); }
+};
+
+struct UniformMat4
+{
+	GLint location = -1;
+	void set(const float* v) const { if (location >= 0) glUniformMatrix4fv(location, 1, GL_FALSE, v); }
+};
+
 class Shader
 {
 public:
@@ -23,6 +60,96 @@ public:
 	// Constructor generates the shader on the fly
 	Shader(const GLchar* vertexPath, const GLchar* fragmentPath)
 	{
+		compile(vertexPath, fragmentPath, this->ID);
+		reflectUniforms();
+	}
+
+	// Recompila os shaders a partir dos arquivos. O programa s  trocado se a compilao e a ligao derem certo; em
+	// caso de erro o programa atual continua em uso. Handles obtidos antes (getUniform) devem ser resolvidos de novo.
+	bool reload(const GLchar* vertexPath, const GLchar* fragmentPath)
+	{
+		GLuint program;
+		if (!compile(vertexPath, fragmentPath, program))
+		{
+			glDeleteProgram(program);
+			return false;
+		}
+		glDeleteProgram(this->ID);
+		this->ID = program;
+		reflectUniforms();
+		return true;
+	}
+
+	// Uses the current shader
+	void Use()
+	{
+		glUseProgram(this->ID);
+	}
+
+	// Localizao de um uniform ativo (-1 se no existir), consultada na tabela montada aps a ligao.
+	GLint getUniformLocation(const std::string& name) const
+	{
+		auto it = std::lower_bound(uniforms.begin(), uniforms.end(), name,
+			[](const std::pair<std::string, GLint>& entry, const std::string& key) { return entry.first < key; });
+		return it != uniforms.end() && it->first == name ? it->second : -1;
+	}
+
+	// Handle tipado para o uniform (ex.: shader.getUniform<UniformMat4>("model")), para ser guardado e usado a cada
+	// quadro.
+	template <typename Handle>
+	Handle getUniform(const std::string& name) const
+	{
+		Handle handle;
+		handle.location = getUniformLocation(name);
+		return handle;
+	}
+
+	// Associa o bloco uniforme ao ponto de ligao do buffer (GLSL 4.10 no tem layout(binding = N) em blocos).
+	void bindUniformBlock(const std::string& name, GLuint binding) const
+	{
+		GLuint index = glGetUniformBlockIndex(this->ID, name.c_str());
+		if (index != GL_INVALID_INDEX)
+		{
+			glUniformBlockBinding(this->ID, index, binding);
+		}
+	}
+
+	void setBool(const std::string& name, bool value) const
+	{
+		glUniform1i(getUniformLocation(name), (int)value);
+	}
+
+	void setInt(const std::string& name, int value) const
+	{
+		glUniform1i(getUniformLocation(name), value);
+	}
+
+	void setFloat(const std::string& name, float value) const
+	{
+		glUniform1f(getUniformLocation(name), value);
+	}
+
+	void setVec3(const std::string& name, float v1, float v2, float v3) const
+	{
+		glUniform3f(getUniformLocation(name), v1, v2, v3);
+	}
+
+	void setVec4(const std::string& name, float v1, float v2, float v3, float v4) const
+	{
+		glUniform4f(getUniformLocation(name), v1, v2, v3,v4);
+	}
+
+	void setMat4(const std::string& name, float *v) const
+	{
+		glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, v);
+	}
+
+protected:
+	// L, compila e liga os shaders em um novo programa. Retorna false se algum passo falhar.
+	bool compile(const GLchar* vertexPath, const GLchar* fragmentPath, GLuint& program)
+	{
+		bool compiled = true;
+
 		// 1. Retrieve the vertex/fragment source code from filePath
 		std::string vertexCode;
 		std::string fragmentCode;
@@ -54,6 +181,7 @@ public:
 		catch (std::ifstream::failure e)
 		{
 			std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
+			compiled = false;
 		}
 
 		// 2. Compile shaders
@@ -75,6 +203,7 @@ public:
 		{
 			glGetShaderInfoLog(vertex, 512, NULL, infoLog);
 			std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+			compiled = false;
 		}
 
 		// Fragment Shader
@@ -88,61 +217,61 @@ public:
 		{
 			glGetShaderInfoLog(fragment, 512, NULL, infoLog);
 			std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+			compiled = false;
 		}
 
 		// Shader Program
-		this->ID = glCreateProgram();
-		glAttachShader(this->ID, vertex);
-		glAttachShader(this->ID, fragment);
-		glLinkProgram(this->ID);
+		program = glCreateProgram();
+		glAttachShader(program, vertex);
+		glAttachShader(program, fragment);
+		glLinkProgram(program);
 
 		// Print linking errors if any
-		glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
 		if (!success)
 		{
-			glGetProgramInfoLog(this->ID, 512, NULL, infoLog);
+			glGetProgramInfoLog(program, 512, NULL, infoLog);
 			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+			compiled = false;
 		}
 
 		// Delete the shaders as they're linked into our program now and no longer necessery
 		glDeleteShader(vertex);
 		glDeleteShader(fragment);
-	}
-
-	// Uses the current shader
-	void Use()
-	{
-		glUseProgram(this->ID);
-	}
 
-	void setBool(const std::string& name, bool value) const
-	{
-		glUniform1i(glGetUniformLocation(this->ID, name.c_str()), (int)value);
+		return compiled;
 	}
 
-	void setInt(const std::string& name, int value) const
-	{
-		glUniform1i(glGetUniformLocation(this->ID, name.c_str()), value);
-	}
+	// Uniforms ativos do programa (nome, localizao), ordenados por nome.
+	std::vector<std::pair<std::string, GLint>> uniforms;
 
-	void setFloat(const std::string& name, float value) const
+	// L todos os uniforms ativos uma nica vez aps a ligao (arrays entram pelo nome sem o sufixo "[0]").
+	void reflectUniforms()
 	{
-		glUniform1f(glGetUniformLocation(this->ID, name.c_str()), value);
-	}
-
-	void setVec3(const std::string& name, float v1, float v2, float v3) const
-	{
-		glUniform3f(glGetUniformLocation(this->ID, name.c_str()), v1, v2, v3);
-	}
-
-	void setVec4(const std::string& name, float v1, float v2, float v3, float v4) const
-	{
-		glUniform4f(glGetUniformLocation(this->ID, name.c_str()), v1, v2, v3,v4);
-	}
-
-	void setMat4(const std::string& name, float *v) const
-	{
-		glUniformMatrix4fv(glGetUniformLocation(this->ID, name.c_str()), 1, GL_FALSE, v);
+		uniforms.clear();
+		GLint count = 0, maxLength = 0;
+		glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+		std::vector<GLchar> buffer(std::max(maxLength, 1));
+		for (GLint i = 0; i < count; i++)
+		{
+			GLsizei length = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(this->ID, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+			std::string name(buffer.data(), length);
+			GLint location = glGetUniformLocation(this->ID, name.c_str());
+			if (location < 0)
+			{
+				continue; // uniforms de blocos no tm localizao
+			}
+			if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+			{
+				name.erase(name.size() - 3);
+			}
+			uniforms.emplace_back(name, location);
+		}
+		std::sort(uniforms.begin(), uniforms.end());
 	}
 };
 
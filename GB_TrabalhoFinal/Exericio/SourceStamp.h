@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "Hash.h"
+#include "MappedFile.h"
+
+// Identificação de um arquivo de origem gravada nos arquivos derivados (.gbmesh, .gbtex): tamanho e data são
+// conferidos primeiro; o hash do conteúdo só é recalculado quando eles mudam.
+struct SourceStamp {
+	uint64_t size = 0;
+	int64_t time = 0;
+	uint64_t hash = 0;
+};
+
+// Lê tamanho e data de modificação do arquivo (hash fica zerado).
+inline bool stat_source(const std::string& path, SourceStamp& stamp) {
+	std::error_code error;
+	uint64_t size = std::filesystem::file_size(path, error);
+	if (error) {
+		return false;
+	}
+	auto time = std::filesystem::last_write_time(path, error);
+	if (error) {
+		return false;
+	}
+	stamp.size = size;
+	stamp.time = (int64_t)time.time_since_epoch().count();
+	stamp.hash = 0;
+	return true;
+}
+
+// Hash do conteúdo do arquivo.
+inline uint64_t hash_file(const std::string& path) {
+	MappedFile file;
+	if (!file.open(path)) {
+		return 0;
+	}
+	return hash_bytes(file.data(), file.size());
+}
@@ -0,0 +1,151 @@
+#include "TextureArray.h"
+
+#include <algorithm>
+
+#include "TextureCompressor.h"
+
+void TextureArrays::initialize(TextureStreamer* streamer) {
+	this->streamer = streamer;
+	GLint layers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &layers);
+	maxLayers = std::max(1, (int)layers);
+}
+
+void TextureArrays::destroy() {
+	for (const auto& array : arrays) {
+		glDeleteTextures(1, &array.first);
+	}
+	arrays.clear();
+	requests.clear();
+}
+
+bool TextureArrays::acquire(const std::string& path, GLuint& array, int& layer) {
+	TextureShape shape;
+	if (!streamer->probe(path, shape)) {
+		return false;
+	}
+
+	// Primeiro uma camada livre de um array da mesma forma; depois, um que ainda possa crescer; por último, um novo.
+	GLuint growable = 0;
+	for (auto& candidate : arrays) {
+		std::vector<std::string>& layers = candidate.second.layers;
+		if (!(candidate.second.shape == shape)) {
+			continue;
+		}
+		auto free = std::find(layers.begin(), layers.end(), std::string());
+		if (free != layers.end()) {
+			*free = path;
+			array = candidate.first;
+			layer = (int)(free - layers.begin());
+			requests.emplace_back(array, layer);
+			return true;
+		}
+		if (growable == 0 && (int)layers.size() < maxLayers) {
+			growable = candidate.first;
+		}
+	}
+	if (growable == 0) {
+		glGenTextures(1, &growable);
+		arrays[growable].shape = shape;
+	}
+
+	std::vector<std::string>& layers = arrays[growable].layers;
+	layers.push_back(path);
+	array = growable;
+	layer = (int)layers.size() - 1;
+	requests.emplace_back(array, layer);
+	return true;
+}
+
+void TextureArrays::release(GLuint array, int layer) {
+	auto found = arrays.find(array);
+	if (found == arrays.end() || layer < 0 || layer >= (int)found->second.layers.size()) {
+		return;
+	}
+	streamer->releaseLayer(array, layer);
+
+	std::vector<std::string>& layers = found->second.layers;
+	layers[layer].clear();
+	while (!layers.empty() && layers.back().empty()) {
+		layers.pop_back();
+	}
+	if (layers.empty()) {
+		glDeleteTextures(1, &array);
+		arrays.erase(found);
+	}
+}
+
+// Aloca todos os níveis de capacity camadas (o conteúdo anterior é descartado).
+void TextureArrays::allocate(GLuint id, Array& array, int capacity) {
+	const TextureShape& shape = array.shape;
+	uint32_t blockSize = texture_block_size(shape.format);
+
+	glBindTexture(GL_TEXTURE_2D_ARRAY, id);
+	for (uint32_t level = 0; level < shape.levelCount; level++) {
+		uint32_t width = std::max(1u, shape.width >> level);
+		uint32_t height = std::max(1u, shape.height >> level);
+		if (shape.format == TEXTURE_RGBA8) {
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, width, height, capacity, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+						 nullptr);
+		} else {
+			size_t layerSize = (size_t)((width + blockSize - 1) / blockSize) * ((height + blockSize - 1) / blockSize) *
+							   texture_block_bytes(shape.format);
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, level, texture_internal_format(shape.format), width, height,
+								   capacity, 0, (GLsizei)(layerSize * capacity), nullptr);
+		}
+	}
+
+	// Mesmos parâmetros das texturas 2D do TextureStreamer.
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, shape.levelCount - 1);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	array.capacity = capacity;
+}
+
+void TextureArrays::update() {
+	for (auto& entry : arrays) {
+		Array& array = entry.second;
+		int used = (int)array.layers.size();
+		if (used <= array.capacity) {
+			continue;
+		}
+		// Na primeira alocação, o número exato de camadas reservadas na carga da cena; depois, o dobro, para não
+		// realocar a cada textura nova. A realocação descarta as imagens: todas as camadas são lidas de novo.
+		bool grown = array.capacity > 0;
+		allocate(entry.first, array, grown ? std::min(maxLayers, std::max(used, array.capacity * 2)) : used);
+		for (int layer = 0; grown && layer < used; layer++) {
+			requests.emplace_back(entry.first, layer);
+		}
+	}
+
+	std::sort(requests.begin(), requests.end());
+	requests.erase(std::unique(requests.begin(), requests.end()), requests.end());
+	for (const auto& request : requests) {
+		// A camada pode ter sido liberada depois da reserva.
+		auto found = arrays.find(request.first);
+		if (found == arrays.end() || request.second >= (int)found->second.layers.size() ||
+			found->second.layers[request.second].empty()) {
+			continue;
+		}
+		const Array& array = found->second;
+		streamer->requestLayer(request.first, request.second, array.shape, array.layers[request.second]);
+	}
+	requests.clear();
+}
+
+size_t TextureArrays::getLayerBytes(GLuint array) const {
+	auto found = arrays.find(array);
+	return found != arrays.end() ? texture_shape_bytes(found->second.shape) : 0;
+}
+
+size_t TextureArrays::getGpuBytes() const {
+	size_t total = 0;
+	for (const auto& array : arrays) {
+		total += texture_shape_bytes(array.second.shape) * array.second.capacity;
+	}
+	return total;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+#include "TextureStreamer.h"
+
+// Empacotamento das texturas em arrays (GL_TEXTURE_2D_ARRAY): texturas com o mesmo formato e dimensões ocupam camadas
+// de um único array, e o shader escolhe a camada pelo atributo de instância. Assim os objetos de um mesmo OBJ com
+// texturas diferentes são desenhados na mesma chamada, sem trocar de textura entre eles.
+// As camadas são reservadas em acquire (o nome do array já é válido) e o armazenamento é alocado em update, uma vez
+// para todas as reservas feitas até ali; um array que precisa de mais camadas é realocado com o dobro delas e as
+// imagens são relidas. As imagens são lidas e enviadas pelo TextureStreamer.
+class TextureArrays {
+   public:
+	void initialize(TextureStreamer* streamer);
+	void destroy();
+
+	// Reserva uma camada no array da forma da imagem (lida só do cabeçalho). Retorna false se o arquivo não puder ser
+	// lido.
+	bool acquire(const std::string& path, GLuint& array, int& layer);
+	// Libera a camada; o array é apagado junto com a última.
+	void release(GLuint array, int layer);
+
+	// Aloca os arrays novos (ou que cresceram) e agenda a leitura das camadas reservadas desde a última chamada.
+	// Chamada uma vez por quadro, na thread com o contexto OpenGL, antes de TextureStreamer::update.
+	void update();
+
+	int getArrayCount() const { return (int)arrays.size(); }
+	// Memória de vídeo de uma camada do array e de todos os arrays (camadas livres incluídas).
+	size_t getLayerBytes(GLuint array) const;
+	size_t getGpuBytes() const;
+
+   protected:
+	struct Array {
+		TextureShape shape;
+		int capacity = 0;				  // camadas alocadas na GPU
+		std::vector<std::string> layers;  // arquivo de cada camada reservada (vazio = livre)
+	};
+
+	void allocate(GLuint id, Array& array, int capacity);
+
+	TextureStreamer* streamer = nullptr;
+	int maxLayers = 256;
+	std::map<GLuint, Array> arrays;
+	std::vector<std::pair<GLuint, int>> requests;  // camadas a ler no próximo update
+};
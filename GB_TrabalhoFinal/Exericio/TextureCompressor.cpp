@@ -0,0 +1,598 @@
+#include "TextureCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static uint64_t align16(uint64_t value) { return (value + 15) & ~(uint64_t)15; }
+
+size_t texture_block_bytes(uint32_t format) {
+	switch (format) {
+		case TEXTURE_BC1:
+			return 8;
+		case TEXTURE_BC3:
+		case TEXTURE_BC7:
+			return 16;
+		default:
+			return 4;
+	}
+}
+
+uint32_t texture_block_size(uint32_t format) { return format == TEXTURE_RGBA8 ? 1 : 4; }
+
+// Eixo principal (maior variância) de n pontos com dimension canais, por iteração de potência sobre a covariância.
+// Retorna false se os pontos forem todos iguais.
+static bool principal_axis(const float* points, int count, int dimension, float* mean, float* axis) {
+	for (int c = 0; c < dimension; c++) {
+		mean[c] = 0.0f;
+		for (int i = 0; i < count; i++) {
+			mean[c] += points[i * dimension + c];
+		}
+		mean[c] /= count;
+	}
+
+	float covariance[4][4] = {};
+	for (int i = 0; i < count; i++) {
+		for (int a = 0; a < dimension; a++) {
+			for (int b = 0; b < dimension; b++) {
+				covariance[a][b] += (points[i * dimension + a] - mean[a]) * (points[i * dimension + b] - mean[b]);
+			}
+		}
+	}
+
+	for (int c = 0; c < dimension; c++) {
+		axis[c] = 1.0f;
+	}
+	for (int iteration = 0; iteration < 8; iteration++) {
+		float next[4] = {};
+		float length = 0.0f;
+		for (int a = 0; a < dimension; a++) {
+			for (int b = 0; b < dimension; b++) {
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length += next[a] * next[a];
+		}
+		if (length < 1e-12f) {
+			return false;
+		}
+		length = std::sqrt(length);
+		for (int c = 0; c < dimension; c++) {
+			axis[c] = next[c] / length;
+		}
+	}
+	return true;
+}
+
+// Extremos dos pontos projetados no eixo principal, aproximados para dentro em 1/16 da faixa (reduz o erro médio).
+static void axis_endpoints(const float* points, int count, int dimension, float* low, float* high) {
+	float mean[4], axis[4];
+	if (!principal_axis(points, count, dimension, mean, axis)) {
+		for (int c = 0; c < dimension; c++) {
+			low[c] = high[c] = mean[c];
+		}
+		return;
+	}
+	float minimum = 1e30f, maximum = -1e30f;
+	for (int i = 0; i < count; i++) {
+		float t = 0.0f;
+		for (int c = 0; c < dimension; c++) {
+			t += (points[i * dimension + c] - mean[c]) * axis[c];
+		}
+		minimum = std::min(minimum, t);
+		maximum = std::max(maximum, t);
+	}
+	float inset = (maximum - minimum) / 16.0f;
+	minimum += inset;
+	maximum -= inset;
+	for (int c = 0; c < dimension; c++) {
+		low[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * minimum));
+		high[c] = std::min(255.0f, std::max(0.0f, mean[c] + axis[c] * maximum));
+	}
+}
+
+// Ajuste por mínimos quadrados dos dois extremos, dados os pesos do primeiro extremo em cada ponto.
+// Retorna false se o sistema for singular (todos os pontos no mesmo índice).
+static bool least_squares_endpoints(const float* points, const float* weights, int count, int dimension, float* first,
+									float* second) {
+	float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+	float ax[4] = {}, bx[4] = {};
+	for (int i = 0; i < count; i++) {
+		float a = weights[i], b = 1.0f - weights[i];
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for (int c = 0; c < dimension; c++) {
+			ax[c] += a * points[i * dimension + c];
+			bx[c] += b * points[i * dimension + c];
+		}
+	}
+	float determinant = aa * bb - ab * ab;
+	if (std::fabs(determinant) < 1e-6f) {
+		return false;
+	}
+	for (int c = 0; c < dimension; c++) {
+		first[c] = std::min(255.0f, std::max(0.0f, (ax[c] * bb - bx[c] * ab) / determinant));
+		second[c] = std::min(255.0f, std::max(0.0f, (bx[c] * aa - ax[c] * ab) / determinant));
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// BC1
+
+static uint16_t pack_565(const float* color) {
+	int r = (int)std::lround(color[0] * 31.0f / 255.0f);
+	int g = (int)std::lround(color[1] * 63.0f / 255.0f);
+	int b = (int)std::lround(color[2] * 31.0f / 255.0f);
+	return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+static void unpack_565(uint16_t packed, int* color) {
+	int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+	color[0] = (r << 3) | (r >> 2);
+	color[1] = (g << 2) | (g >> 4);
+	color[2] = (b << 3) | (b >> 2);
+}
+
+// Paleta de um bloco BC1. fourColors = false só quando color0 <= color1 fora do BC3 (3 cores + transparente).
+static void bc1_palette(uint16_t color0, uint16_t color1, bool fourColors, int palette[4][4]) {
+	unpack_565(color0, palette[0]);
+	unpack_565(color1, palette[1]);
+	palette[0][3] = palette[1][3] = 255;
+	for (int c = 0; c < 3; c++) {
+		if (fourColors) {
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		} else {
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = fourColors ? 255 : 0;
+}
+
+// Escolhe os índices dos pixels para os extremos e retorna o erro quadrático do bloco.
+static int bc1_fit(const float* points, uint16_t color0, uint16_t color1, uint32_t& indices) {
+	int palette[4][4];
+	bc1_palette(color0, color1, true, palette);
+	int error = 0;
+	indices = 0;
+	for (int i = 0; i < 16; i++) {
+		int best = 0, bestError = 1 << 30;
+		for (int p = 0; p < 4; p++) {
+			int e = 0;
+			for (int c = 0; c < 3; c++) {
+				int d = (int)points[i * 3 + c] - palette[p][c];
+				e += d * d;
+			}
+			if (e < bestError) {
+				best = p;
+				bestError = e;
+			}
+		}
+		indices |= (uint32_t)best << (2 * i);
+		error += bestError;
+	}
+	return error;
+}
+
+// Extremos (color0 > color1, modo de 4 cores) e índices de um bloco de cor.
+static void encode_bc1_colors(const uint8_t* pixels, uint16_t& bestColor0, uint16_t& bestColor1,
+							  uint32_t& bestIndices) {
+	float points[16 * 3];
+	for (int i = 0; i < 16; i++) {
+		for (int c = 0; c < 3; c++) {
+			points[i * 3 + c] = pixels[i * 4 + c];
+		}
+	}
+
+	float low[3], high[3];
+	axis_endpoints(points, 16, 3, low, high);
+	uint16_t color0 = pack_565(high), color1 = pack_565(low);
+	if (color0 == color1) {
+		bestColor0 = color0;
+		bestColor1 = color1;
+		bestIndices = 0;
+		return;
+	}
+	if (color0 < color1) {
+		std::swap(color0, color1);
+	}
+	uint32_t indices;
+	int bestError = bc1_fit(points, color0, color1, indices);
+	bestColor0 = color0;
+	bestColor1 = color1;
+	bestIndices = indices;
+
+	// Um refinamento dos extremos por mínimos quadrados a partir dos índices escolhidos.
+	static const float WEIGHTS[4] = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+	float weights[16];
+	for (int i = 0; i < 16; i++) {
+		weights[i] = WEIGHTS[(indices >> (2 * i)) & 3];
+	}
+	float first[3], second[3];
+	if (least_squares_endpoints(points, weights, 16, 3, first, second)) {
+		color0 = pack_565(first);
+		color1 = pack_565(second);
+		if (color0 < color1) {
+			std::swap(color0, color1);
+		}
+		if (color0 != color1) {
+			int error = bc1_fit(points, color0, color1, indices);
+			if (error < bestError) {
+				bestColor0 = color0;
+				bestColor1 = color1;
+				bestIndices = indices;
+			}
+		}
+	}
+}
+
+static void write_bc1_colors(uint8_t* block, uint16_t color0, uint16_t color1, uint32_t indices) {
+	memcpy(block, &color0, 2);
+	memcpy(block + 2, &color1, 2);
+	memcpy(block + 4, &indices, 4);
+}
+
+void encode_bc1_block(const uint8_t* pixels, uint8_t* block) {
+	uint16_t color0, color1;
+	uint32_t indices;
+	encode_bc1_colors(pixels, color0, color1, indices);
+	write_bc1_colors(block, color0, color1, indices);
+}
+
+static void decode_bc1_colors(const uint8_t* block, bool forceFourColors, uint8_t* pixels) {
+	uint16_t color0, color1;
+	uint32_t indices;
+	memcpy(&color0, block, 2);
+	memcpy(&color1, block + 2, 2);
+	memcpy(&indices, block + 4, 4);
+	int palette[4][4];
+	bc1_palette(color0, color1, forceFourColors || color0 > color1, palette);
+	for (int i = 0; i < 16; i++) {
+		const int* color = palette[(indices >> (2 * i)) & 3];
+		for (int c = 0; c < 4; c++) {
+			pixels[i * 4 + c] = (uint8_t)color[c];
+		}
+	}
+}
+
+void decode_bc1_block(const uint8_t* block, uint8_t* pixels) { decode_bc1_colors(block, false, pixels); }
+
+// ---------------------------------------------------------------------------------------------------------------------
+// BC3
+
+static void bc3_alpha_palette(int alpha0, int alpha1, int palette[8]) {
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+	if (alpha0 > alpha1) {
+		for (int k = 2; k < 8; k++) {
+			palette[k] = ((8 - k) * alpha0 + (k - 1) * alpha1) / 7;
+		}
+	} else {
+		for (int k = 2; k < 6; k++) {
+			palette[k] = ((6 - k) * alpha0 + (k - 1) * alpha1) / 5;
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+void encode_bc3_block(const uint8_t* pixels, uint8_t* block) {
+	int alpha0 = 0, alpha1 = 255;
+	for (int i = 0; i < 16; i++) {
+		alpha0 = std::max(alpha0, (int)pixels[i * 4 + 3]);
+		alpha1 = std::min(alpha1, (int)pixels[i * 4 + 3]);
+	}
+
+	uint64_t indices = 0;
+	if (alpha0 != alpha1) {
+		int palette[8];
+		bc3_alpha_palette(alpha0, alpha1, palette);
+		for (int i = 0; i < 16; i++) {
+			int best = 0, bestError = 1 << 30;
+			for (int p = 0; p < 8; p++) {
+				int error = std::abs((int)pixels[i * 4 + 3] - palette[p]);
+				if (error < bestError) {
+					best = p;
+					bestError = error;
+				}
+			}
+			indices |= (uint64_t)best << (3 * i);
+		}
+	}
+	block[0] = (uint8_t)alpha0;
+	block[1] = (uint8_t)alpha1;
+	for (int i = 0; i < 6; i++) {
+		block[2 + i] = (uint8_t)(indices >> (8 * i));
+	}
+
+	// No BC3 o bloco de cor é sempre lido no modo de 4 cores.
+	uint16_t color0, color1;
+	uint32_t colorIndices;
+	encode_bc1_colors(pixels, color0, color1, colorIndices);
+	write_bc1_colors(block + 8, color0, color1, colorIndices);
+}
+
+void decode_bc3_block(const uint8_t* block, uint8_t* pixels) {
+	decode_bc1_colors(block + 8, true, pixels);
+	int palette[8];
+	bc3_alpha_palette(block[0], block[1], palette);
+	uint64_t indices = 0;
+	for (int i = 0; i < 6; i++) {
+		indices |= (uint64_t)block[2 + i] << (8 * i);
+	}
+	for (int i = 0; i < 16; i++) {
+		pixels[i * 4 + 3] = (uint8_t)palette[(indices >> (3 * i)) & 7];
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// BC7 (modo 6)
+
+static const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+// Escrita e leitura de campos de bits de um bloco de 128 bits, do bit menos significativo em diante.
+struct BlockBits {
+	uint8_t* data;
+	int position = 0;
+
+	void write(uint32_t value, int bits) {
+		for (int i = 0; i < bits; i++, position++) {
+			if ((value >> i) & 1) {
+				data[position >> 3] |= (uint8_t)(1 << (position & 7));
+			}
+		}
+	}
+	uint32_t read(int bits) {
+		uint32_t value = 0;
+		for (int i = 0; i < bits; i++, position++) {
+			value |= (uint32_t)((data[position >> 3] >> (position & 7)) & 1) << i;
+		}
+		return value;
+	}
+};
+
+// Extremo em 7 bits por canal + p-bit compartilhado pelos canais (o que der o menor erro).
+static void quantize_bc7_endpoint(const float* color, int* quantized, int& pbit) {
+	float bestError = 1e30f;
+	for (int p = 0; p < 2; p++) {
+		int candidate[4];
+		float error = 0.0f;
+		for (int c = 0; c < 4; c++) {
+			candidate[c] = std::min(127, std::max(0, (int)std::lround((color[c] - p) / 2.0f)));
+			float d = (float)((candidate[c] << 1) | p) - color[c];
+			error += d * d;
+		}
+		if (error < bestError) {
+			bestError = error;
+			pbit = p;
+			memcpy(quantized, candidate, sizeof(candidate));
+		}
+	}
+}
+
+static void bc7_palette(const int* endpoint0, int pbit0, const int* endpoint1, int pbit1, int palette[16][4]) {
+	for (int c = 0; c < 4; c++) {
+		int e0 = (endpoint0[c] << 1) | pbit0;
+		int e1 = (endpoint1[c] << 1) | pbit1;
+		for (int i = 0; i < 16; i++) {
+			palette[i][c] = ((64 - BC7_WEIGHTS4[i]) * e0 + BC7_WEIGHTS4[i] * e1 + 32) >> 6;
+		}
+	}
+}
+
+static int bc7_fit(const float* points, const int palette[16][4], uint8_t* indices) {
+	int error = 0;
+	for (int i = 0; i < 16; i++) {
+		int best = 0, bestError = 1 << 30;
+		for (int p = 0; p < 16; p++) {
+			int e = 0;
+			for (int c = 0; c < 4; c++) {
+				int d = (int)points[i * 4 + c] - palette[p][c];
+				e += d * d;
+			}
+			if (e < bestError) {
+				best = p;
+				bestError = e;
+			}
+		}
+		indices[i] = (uint8_t)best;
+		error += bestError;
+	}
+	return error;
+}
+
+void encode_bc7_block(const uint8_t* pixels, uint8_t* block) {
+	float points[16 * 4];
+	for (int i = 0; i < 64; i++) {
+		points[i] = pixels[i];
+	}
+
+	float low[4], high[4];
+	axis_endpoints(points, 16, 4, low, high);
+
+	int endpoint0[4], endpoint1[4], pbit0, pbit1;
+	quantize_bc7_endpoint(low, endpoint0, pbit0);
+	quantize_bc7_endpoint(high, endpoint1, pbit1);
+	int palette[16][4];
+	bc7_palette(endpoint0, pbit0, endpoint1, pbit1, palette);
+	uint8_t indices[16];
+	int bestError = bc7_fit(points, palette, indices);
+
+	// Um refinamento dos extremos por mínimos quadrados a partir dos índices escolhidos.
+	float weights[16];
+	for (int i = 0; i < 16; i++) {
+		weights[i] = 1.0f - BC7_WEIGHTS4[indices[i]] / 64.0f;
+	}
+	float first[4], second[4];
+	if (least_squares_endpoints(points, weights, 16, 4, first, second)) {
+		int refined0[4], refined1[4], refinedPbit0, refinedPbit1;
+		quantize_bc7_endpoint(first, refined0, refinedPbit0);
+		quantize_bc7_endpoint(second, refined1, refinedPbit1);
+		int refinedPalette[16][4];
+		bc7_palette(refined0, refinedPbit0, refined1, refinedPbit1, refinedPalette);
+		uint8_t refinedIndices[16];
+		int error = bc7_fit(points, refinedPalette, refinedIndices);
+		if (error < bestError) {
+			memcpy(endpoint0, refined0, sizeof(endpoint0));
+			memcpy(endpoint1, refined1, sizeof(endpoint1));
+			pbit0 = refinedPbit0;
+			pbit1 = refinedPbit1;
+			memcpy(indices, refinedIndices, sizeof(indices));
+		}
+	}
+
+	// O bit mais significativo do índice do primeiro pixel não é gravado (tem de ser 0): troca os extremos se preciso.
+	if (indices[0] & 8) {
+		std::swap(endpoint0, endpoint1);
+		std::swap(pbit0, pbit1);
+		for (int i = 0; i < 16; i++) {
+			indices[i] = (uint8_t)(15 - indices[i]);
+		}
+	}
+
+	memset(block, 0, 16);
+	BlockBits bits{block};
+	bits.write(1 << 6, 7);	// modo 6
+	for (int c = 0; c < 4; c++) {
+		bits.write(endpoint0[c], 7);
+		bits.write(endpoint1[c], 7);
+	}
+	bits.write(pbit0, 1);
+	bits.write(pbit1, 1);
+	bits.write(indices[0], 3);
+	for (int i = 1; i < 16; i++) {
+		bits.write(indices[i], 4);
+	}
+}
+
+void decode_bc7_block(const uint8_t* block, uint8_t* pixels) {
+	if ((block[0] & 0x7F) != 0x40) {
+		for (int i = 0; i < 16; i++) {
+			pixels[i * 4 + 0] = 255;
+			pixels[i * 4 + 1] = 0;
+			pixels[i * 4 + 2] = 255;
+			pixels[i * 4 + 3] = 255;
+		}
+		return;
+	}
+
+	BlockBits bits{(uint8_t*)block};
+	bits.read(7);
+	int endpoint0[4], endpoint1[4];
+	for (int c = 0; c < 4; c++) {
+		endpoint0[c] = (int)bits.read(7);
+		endpoint1[c] = (int)bits.read(7);
+	}
+	int pbit0 = (int)bits.read(1), pbit1 = (int)bits.read(1);
+	int palette[16][4];
+	bc7_palette(endpoint0, pbit0, endpoint1, pbit1, palette);
+	for (int i = 0; i < 16; i++) {
+		const int* color = palette[bits.read(i == 0 ? 3 : 4)];
+		for (int c = 0; c < 4; c++) {
+			pixels[i * 4 + c] = (uint8_t)color[c];
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// Texturas
+
+bool texture_has_alpha(const TextureData& rgba) {
+	const TextureLevel& level = rgba.levels[0];
+	const uint8_t* pixels = &rgba.data[level.offset];
+	for (uint64_t i = 3; i < level.size; i += 4) {
+		if (pixels[i] != 255) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Cadeia de níveis do formato com as dimensões da textura, com os dados vazios.
+static void allocate_levels(const TextureData& source, uint32_t format, TextureData& target) {
+	size_t blockBytes = texture_block_bytes(format);
+	uint32_t blockSize = texture_block_size(format);
+	target.format = format;
+	target.width = source.width;
+	target.height = source.height;
+	target.levels.clear();
+	uint64_t total = 0;
+	for (const TextureLevel& level : source.levels) {
+		uint64_t blocks =
+			(uint64_t)((level.width + blockSize - 1) / blockSize) * ((level.height + blockSize - 1) / blockSize);
+		TextureLevel allocated = {total, blocks * blockBytes, level.width, level.height};
+		target.levels.push_back(allocated);
+		total = align16(total + allocated.size);
+	}
+	target.data.assign(total, 0);
+}
+
+void compress_texture(const TextureData& rgba, uint32_t format, TextureData& compressed) {
+	if (format == TEXTURE_RGBA8) {
+		compressed = rgba;
+		return;
+	}
+	allocate_levels(rgba, format, compressed);
+	size_t blockBytes = texture_block_bytes(format);
+
+	for (size_t l = 0; l < rgba.levels.size(); l++) {
+		const TextureLevel& source = rgba.levels[l];
+		const uint8_t* in = &rgba.data[source.offset];
+		uint8_t* out = &compressed.data[compressed.levels[l].offset];
+		for (uint32_t by = 0; by < source.height; by += 4) {
+			for (uint32_t bx = 0; bx < source.width; bx += 4, out += blockBytes) {
+				// Blocos na borda de níveis com dimensão não múltipla de 4 repetem a última linha/coluna.
+				uint8_t pixels[16 * 4];
+				for (uint32_t y = 0; y < 4; y++) {
+					for (uint32_t x = 0; x < 4; x++) {
+						uint32_t sx = std::min(bx + x, source.width - 1);
+						uint32_t sy = std::min(by + y, source.height - 1);
+						memcpy(&pixels[(y * 4 + x) * 4], &in[(sy * source.width + sx) * 4], 4);
+					}
+				}
+				if (format == TEXTURE_BC1) {
+					encode_bc1_block(pixels, out);
+				} else if (format == TEXTURE_BC3) {
+					encode_bc3_block(pixels, out);
+				} else {
+					encode_bc7_block(pixels, out);
+				}
+			}
+		}
+	}
+}
+
+void decompress_texture(const TextureData& compressed, TextureData& rgba) {
+	if (compressed.format == TEXTURE_RGBA8) {
+		rgba = compressed;
+		return;
+	}
+	allocate_levels(compressed, TEXTURE_RGBA8, rgba);
+	size_t blockBytes = texture_block_bytes(compressed.format);
+
+	for (size_t l = 0; l < compressed.levels.size(); l++) {
+		const TextureLevel& target = rgba.levels[l];
+		const uint8_t* in = &compressed.data[compressed.levels[l].offset];
+		uint8_t* out = &rgba.data[target.offset];
+		for (uint32_t by = 0; by < target.height; by += 4) {
+			for (uint32_t bx = 0; bx < target.width; bx += 4, in += blockBytes) {
+				uint8_t pixels[16 * 4];
+				if (compressed.format == TEXTURE_BC1) {
+					decode_bc1_block(in, pixels);
+				} else if (compressed.format == TEXTURE_BC3) {
+					decode_bc3_block(in, pixels);
+				} else {
+					decode_bc7_block(in, pixels);
+				}
+				for (uint32_t y = 0; y < 4 && by + y < target.height; y++) {
+					for (uint32_t x = 0; x < 4 && bx + x < target.width; x++) {
+						memcpy(&out[((by + y) * target.width + bx + x) * 4], &pixels[(y * 4 + x) * 4], 4);
+					}
+				}
+			}
+		}
+	}
+}
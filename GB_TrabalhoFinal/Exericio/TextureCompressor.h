@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "TextureFile.h"
+
+// Compressão em blocos 4x4 (BC1, BC3 e BC7) das texturas preparadas pelo assetcook, feita só na CPU. A GPU lê os blocos
+// diretamente (glCompressedTexImage2D), ocupando de 4x (BC3/BC7) a 8x (BC1) menos memória que RGBA8.
+// - BC1: 8 bytes por bloco, cor RGB565 interpolada (sem alfa);
+// - BC3: 16 bytes por bloco, alfa interpolado em 8 níveis + bloco BC1;
+// - BC7: 16 bytes por bloco; o codificador usa só o modo 6 (RGBA 7.7.7.7 + p-bit, índices de 4 bits), que já dá
+//   qualidade bem maior que BC1/BC3 nas imagens do trabalho.
+
+// Bytes por bloco 4x4 do formato (1 "bloco" = 1 pixel em RGBA8).
+size_t texture_block_bytes(uint32_t format);
+// Dimensão do bloco do formato (4 nos formatos comprimidos, 1 em RGBA8).
+uint32_t texture_block_size(uint32_t format);
+
+// Comprime ou descomprime um bloco. pixels = 16 pixels RGBA8, linha a linha.
+void encode_bc1_block(const uint8_t* pixels, uint8_t* block);
+void encode_bc3_block(const uint8_t* pixels, uint8_t* block);
+void encode_bc7_block(const uint8_t* pixels, uint8_t* block);
+void decode_bc1_block(const uint8_t* block, uint8_t* pixels);
+void decode_bc3_block(const uint8_t* block, uint8_t* pixels);
+// Só decodifica o modo 6 (o único gerado por encode_bc7_block); outros modos resultam em magenta.
+void decode_bc7_block(const uint8_t* block, uint8_t* pixels);
+
+// true se algum pixel da cadeia RGBA8 tiver alfa diferente de 255.
+bool texture_has_alpha(const TextureData& rgba);
+
+// Comprime todos os níveis de uma textura RGBA8 (mipmaps já gerados) no formato indicado.
+void compress_texture(const TextureData& rgba, uint32_t format, TextureData& compressed);
+// Volta uma textura comprimida para RGBA8 (placas sem suporte ao formato e comparação de qualidade).
+void decompress_texture(const TextureData& compressed, TextureData& rgba);
@@ -0,0 +1,158 @@
+#include "TextureFile.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
+#include "TextureCompressor.h"
+
+static_assert(sizeof(TextureFileHeader) == 64, "TextureFileHeader faz parte do formato em disco");
+
+static uint64_t align16(uint64_t value) { return (value + 15) & ~(uint64_t)15; }
+
+bool TextureFile::open(const std::string& path) {
+	close();
+	if (!file.open(path) || file.size() < sizeof(TextureFileHeader)) {
+		file.close();
+		return false;
+	}
+
+	const TextureFileHeader* candidate = (const TextureFileHeader*)file.data();
+	uint64_t size = file.size();
+	bool valid = candidate->magic == TEXTURE_FILE_MAGIC && candidate->version == TEXTURE_FILE_VERSION &&
+				 candidate->format <= TEXTURE_BC7 && candidate->width > 0 && candidate->height > 0 &&
+				 candidate->levelCount > 0 && candidate->levelCount <= 32 &&
+				 candidate->levelsOffset + candidate->levelCount * sizeof(TextureLevel) <= size;
+	if (valid) {
+		// Cada nível precisa ter as dimensões da cadeia e o tamanho delas no formato: quem lê os níveis (ex.:
+		// TextureStreamer) calcula as linhas a copiar pelas dimensões.
+		const TextureLevel* levels = (const TextureLevel*)(file.data() + candidate->levelsOffset);
+		uint32_t blockSize = texture_block_size(candidate->format);
+		uint64_t blockBytes = texture_block_bytes(candidate->format);
+		for (uint32_t i = 0; i < candidate->levelCount && valid; i++) {
+			const TextureLevel& level = levels[i];
+			uint32_t width = std::max(1u, candidate->width >> i), height = std::max(1u, candidate->height >> i);
+			uint64_t blocks =
+				(uint64_t)((width + blockSize - 1) / blockSize) * ((height + blockSize - 1) / blockSize);
+			valid = level.width == width && level.height == height && level.size == blocks * blockBytes &&
+					level.offset <= size && level.size <= size - level.offset;
+		}
+	}
+	if (!valid) {
+		file.close();
+		return false;
+	}
+
+	header = candidate;
+	return true;
+}
+
+std::string texture_file_path(const std::string& imagePath) { return imagePath + ".gbtex"; }
+
+void build_rgba8_mip_chain(const uint8_t* pixels, uint32_t width, uint32_t height, TextureData& texture) {
+	texture.format = TEXTURE_RGBA8;
+	texture.width = width;
+	texture.height = height;
+	texture.levels.clear();
+
+	// Tamanho total da cadeia.
+	uint64_t total = 0;
+	for (uint32_t w = width, h = height;; w = std::max(1u, w / 2), h = std::max(1u, h / 2)) {
+		TextureLevel level = {total, (uint64_t)w * h * 4, w, h};
+		texture.levels.push_back(level);
+		total = align16(total + level.size);
+		if (w == 1 && h == 1) {
+			break;
+		}
+	}
+	texture.data.assign(total, 0);
+	std::copy(pixels, pixels + texture.levels[0].size, texture.data.begin());
+
+	// Cada nível é a média de blocos 2x2 do anterior (nas dimensões ímpares a última linha/coluna é repetida).
+	for (size_t i = 1; i < texture.levels.size(); i++) {
+		const TextureLevel& source = texture.levels[i - 1];
+		const TextureLevel& target = texture.levels[i];
+		const uint8_t* in = &texture.data[source.offset];
+		uint8_t* out = &texture.data[target.offset];
+		for (uint32_t y = 0; y < target.height; y++) {
+			uint32_t y0 = std::min(y * 2, source.height - 1);
+			uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+			for (uint32_t x = 0; x < target.width; x++) {
+				uint32_t x0 = std::min(x * 2, source.width - 1);
+				uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+				for (int c = 0; c < 4; c++) {
+					uint32_t sum = in[(y0 * source.width + x0) * 4 + c] + in[(y0 * source.width + x1) * 4 + c] +
+								   in[(y1 * source.width + x0) * 4 + c] + in[(y1 * source.width + x1) * 4 + c];
+					out[(y * target.width + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+bool write_texture_file(const std::string& path, const TextureData& texture, const SourceStamp& source,
+						uint32_t flags) {
+	TextureFileHeader header{};
+	header.magic = TEXTURE_FILE_MAGIC;
+	header.version = TEXTURE_FILE_VERSION;
+	header.source = source;
+	header.format = texture.format;
+	header.width = texture.width;
+	header.height = texture.height;
+	header.levelCount = (uint32_t)texture.levels.size();
+	header.levelsOffset = align16(sizeof(TextureFileHeader));
+	header.flags = flags;
+
+	uint64_t dataOffset = align16(header.levelsOffset + header.levelCount * sizeof(TextureLevel));
+	std::vector<TextureLevel> levels = texture.levels;
+	for (TextureLevel& level : levels) {
+		level.offset += dataOffset;
+	}
+
+	std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream out(temporaryPath, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			return false;
+		}
+		auto writeAt = [&out](uint64_t offset, const void* data, uint64_t size) {
+			static const char zeros[16] = {0};
+			uint64_t position = (uint64_t)out.tellp();
+			if (offset > position) {
+				out.write(zeros, (std::streamsize)(offset - position));
+			}
+			out.write((const char*)data, (std::streamsize)size);
+		};
+		writeAt(0, &header, sizeof(header));
+		writeAt(header.levelsOffset, levels.data(), levels.size() * sizeof(TextureLevel));
+		writeAt(dataOffset, texture.data.data(), texture.data.size());
+		if (!out.good()) {
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error) {
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+	return true;
+}
+
+bool open_texture_file(const std::string& imagePath, TextureFile& texture) {
+	if (!texture.open(texture_file_path(imagePath))) {
+		return false;
+	}
+
+	SourceStamp source;
+	if (!stat_source(imagePath, source)) {
+		return true;
+	}
+	const SourceStamp& cooked = texture.getHeader().source;
+	if (cooked.size == source.size && (cooked.time == source.time || cooked.hash == hash_file(imagePath))) {
+		return true;
+	}
+	texture.close();
+	return false;
+}
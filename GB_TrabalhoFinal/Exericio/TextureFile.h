@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MappedFile.h"
+#include "SourceStamp.h"
+
+// Formato binário de textura (.gbtex) gerado pelo assetcook ao lado da imagem original: cadeia de mipmaps já
+// decodificada (RGBA8) ou comprimida em blocos (BC1/BC3/BC7), pronta para o glTexImage2D/glCompressedTexImage2D, sem
+// passar pelo stb_image em tempo de execução.
+// Layout: cabeçalho | tabela de níveis | dados de cada nível (alinhados em 16 bytes).
+const uint32_t TEXTURE_FILE_MAGIC = 0x58544247;	 // "GBTX"
+const uint32_t TEXTURE_FILE_VERSION = 2;
+
+// Formato dos níveis. Os comprimidos são gravados em blocos 4x4 (ver TextureCompressor.h).
+enum TextureFormat : uint32_t {
+	TEXTURE_RGBA8 = 0,
+	TEXTURE_BC1 = 1,
+	TEXTURE_BC3 = 2,
+	TEXTURE_BC7 = 3,
+};
+
+// Como os mipmaps foram filtrados (TextureFileHeader::flags): o assetcook refaz a textura quando o filtro pedido muda.
+const uint32_t TEXTURE_MIP_KAISER = 1;	// Kaiser (sem a flag, caixa 2x2)
+const uint32_t TEXTURE_MIP_LINEAR = 2;	// filtrados direto nos bytes (sem a flag, em luz linear)
+
+struct TextureLevel {
+	uint64_t offset;  // a partir do início do arquivo (ou de TextureData::data)
+	uint64_t size;
+	uint32_t width;
+	uint32_t height;
+};
+
+struct TextureFileHeader {
+	uint32_t magic;
+	uint32_t version;
+	SourceStamp source;
+	uint32_t format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t levelCount;
+	uint64_t levelsOffset;
+	uint32_t flags;	 // TEXTURE_MIP_*
+	uint32_t reserved;
+};
+
+// Textura em memória com todos os níveis de mipmap em um único bloco.
+struct TextureData {
+	uint32_t format = TEXTURE_RGBA8;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<TextureLevel> levels;
+	std::vector<uint8_t> data;
+};
+
+// Arquivo de textura aberto (mapeado em memória).
+class TextureFile {
+   public:
+	bool open(const std::string& path);
+	void close() {
+		file.close();
+		header = nullptr;
+	}
+
+	bool isOpen() const { return header != nullptr; }
+	const TextureFileHeader& getHeader() const { return *header; }
+	const TextureLevel& getLevel(uint32_t level) const {
+		return ((const TextureLevel*)(file.data() + header->levelsOffset))[level];
+	}
+	const void* getLevelData(uint32_t level) const { return file.data() + getLevel(level).offset; }
+
+   protected:
+	MappedFile file;
+	const TextureFileHeader* header = nullptr;
+};
+
+// Caminho do arquivo preparado de uma imagem.
+std::string texture_file_path(const std::string& imagePath);
+
+// Gera a cadeia completa de mipmaps RGBA8 (filtro caixa 2x2) a partir dos pixels RGBA8 do nível 0.
+void build_rgba8_mip_chain(const uint8_t* pixels, uint32_t width, uint32_t height, TextureData& texture);
+
+// Grava a textura (em um arquivo temporário renomeado no fim).
+bool write_texture_file(const std::string& path, const TextureData& texture, const SourceStamp& source,
+						uint32_t flags = 0);
+
+// Abre o arquivo preparado da imagem se ele ainda corresponder a ela (ou se a imagem não existir mais).
+bool open_texture_file(const std::string& imagePath, TextureFile& texture);
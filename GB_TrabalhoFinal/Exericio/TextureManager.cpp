@@ -0,0 +1,112 @@
+#include "TextureManager.h"
+
+#include <filesystem>
+#include <set>
+
+#include "SourceStamp.h"
+
+// Caminho absoluto sem "..", links simbólicos resolvidos (o arquivo pode não existir).
+static std::string canonical_path(const std::string& path) {
+	std::error_code error;
+	std::filesystem::path canonical = std::filesystem::weakly_canonical(path, error);
+	if (error) {
+		return std::filesystem::absolute(path).lexically_normal().string();
+	}
+	return canonical.string();
+}
+
+void TextureManager::initialize(TextureStreamer* streamer, bool packArrays) {
+	this->streamer = streamer;
+	this->packArrays = packArrays;
+	arrays.initialize(streamer);
+}
+
+void TextureManager::destroy() {
+	byPath.clear();
+	byContent.clear();
+	arrays.destroy();
+}
+
+TextureHandle TextureManager::acquire(const std::string& path) {
+	std::string canonical = canonical_path(path);
+	auto known = byPath.find(canonical);
+	if (known != byPath.end()) {
+		if (TextureHandle texture = known->second.lock()) {
+			return texture;
+		}
+	}
+
+	// Outro arquivo com o mesmo conteúdo (cópia da imagem com outro nome) também é reaproveitado. O hash é calculado
+	// sobre o arquivo mapeado, bem mais rápido que a decodificação que ele evita.
+	uint64_t hash = hash_file(canonical);
+	if (hash != 0) {
+		auto same = byContent.find(hash);
+		if (same != byContent.end()) {
+			if (TextureHandle texture = same->second.lock()) {
+				byPath[canonical] = texture;
+				return texture;
+			}
+		}
+	}
+
+	ManagedTexture* created = new ManagedTexture();
+	if (packArrays && arrays.acquire(path, created->id, created->layer)) {
+		created->target = GL_TEXTURE_2D_ARRAY;
+	} else {
+		created->id = streamer->request(path);
+	}
+	created->path = canonical;
+	created->contentHash = hash;
+	TextureHandle texture(created, [this](const ManagedTexture* texture) {
+		release(texture);
+		delete texture;
+	});
+	byPath[canonical] = texture;
+	if (hash != 0) {
+		byContent[hash] = texture;
+	}
+	return texture;
+}
+
+void TextureManager::release(const ManagedTexture* texture) {
+	if (texture->layer >= 0) {
+		arrays.release(texture->id, texture->layer);
+	} else {
+		streamer->release(texture->id);
+	}
+
+	// Remove as entradas que apontavam para a textura (todas já expiradas).
+	for (auto entry = byPath.begin(); entry != byPath.end();) {
+		entry = entry->second.expired() ? byPath.erase(entry) : std::next(entry);
+	}
+	for (auto entry = byContent.begin(); entry != byContent.end();) {
+		entry = entry->second.expired() ? byContent.erase(entry) : std::next(entry);
+	}
+}
+
+std::vector<TextureUsage> TextureManager::getUsage() const {
+	std::vector<TextureUsage> usage;
+	std::set<const ManagedTexture*> listed;
+	for (const auto& entry : byPath) {
+		TextureHandle texture = entry.second.lock();
+		if (texture && listed.insert(texture.get()).second) {
+			size_t bytes = texture->layer >= 0 ? arrays.getLayerBytes(texture->id) : streamer->getGpuBytes(texture->id);
+			// A referência local não conta como usuário.
+			usage.push_back({texture->path, bytes, texture.use_count() - 1});
+		}
+	}
+	return usage;
+}
+
+size_t TextureManager::getTotalGpuBytes() const {
+	// Os arrays contam inteiros, com as camadas livres.
+	size_t total = arrays.getGpuBytes();
+	std::set<GLuint> listed;
+	for (const auto& entry : byPath) {
+		TextureHandle texture = entry.second.lock();
+		if (texture && texture->layer < 0 && listed.insert(texture->id).second) {
+			total += streamer->getGpuBytes(texture->id);
+		}
+	}
+	return total;
+}
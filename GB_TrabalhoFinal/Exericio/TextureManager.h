@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+#include "TextureArray.h"
+#include "TextureStreamer.h"
+
+// Textura compartilhada pelos seus usuários: uma textura 2D ou uma camada de um array (id = array).
+struct ManagedTexture {
+	GLuint id = 0;
+	GLenum target = GL_TEXTURE_2D;
+	int layer = -1;	 // camada no GL_TEXTURE_2D_ARRAY (-1 nas texturas 2D)
+	std::string path;  // caminho canônico do primeiro arquivo que a carregou
+	uint64_t contentHash = 0;
+};
+
+// Referência a uma textura do TextureManager: a textura é apagada da GPU quando a última referência deixa de existir.
+// As referências devem ser liberadas na thread com o contexto OpenGL, antes de TextureManager::destroy.
+using TextureHandle = std::shared_ptr<const ManagedTexture>;
+
+// Uso de memória de vídeo de uma textura.
+struct TextureUsage {
+	std::string path;
+	size_t gpuBytes;
+	long users;
+};
+
+// Cache de texturas: caminhos que levam ao mesmo arquivo, ou arquivos com o mesmo conteúdo, compartilham uma única
+// textura na GPU (lida e enviada pelo TextureStreamer uma só vez). Com packArrays, as texturas ficam em camadas dos
+// arrays de TextureArrays (as que não podem ser lidas continuam como texturas 2D, com a imagem provisória).
+class TextureManager {
+   public:
+	void initialize(TextureStreamer* streamer, bool packArrays = false);
+	void destroy();
+
+	TextureHandle acquire(const std::string& path);
+
+	// Aloca os arrays e agenda a leitura das camadas novas. Uma vez por quadro, antes de TextureStreamer::update.
+	void update() { arrays.update(); }
+	int getArrayCount() const { return arrays.getArrayCount(); }
+
+	// Texturas vivas e a memória de vídeo ocupada por cada uma (cresce à medida que os níveis são enviados).
+	std::vector<TextureUsage> getUsage() const;
+	size_t getTotalGpuBytes() const;
+
+   protected:
+	void release(const ManagedTexture* texture);
+
+	TextureStreamer* streamer = nullptr;
+	bool packArrays = false;
+	TextureArrays arrays;
+	std::map<std::string, std::weak_ptr<const ManagedTexture>> byPath;	// caminho canônico
+	std::map<uint64_t, std::weak_ptr<const ManagedTexture>> byContent;	// hash do conteúdo
+};
@@ -0,0 +1,413 @@
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "MipGenerator.h"
+#include "TextureCompressor.h"
+
+// STB_IMAGE.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+// Formatos comprimidos (EXT_texture_compression_s3tc e ARB_texture_compression_bptc), ausentes do GLAD 3.3.
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+
+GLenum texture_internal_format(uint32_t format) {
+	switch (format) {
+		case TEXTURE_BC1:
+			return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+		case TEXTURE_BC3:
+			return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		case TEXTURE_BC7:
+			return GL_COMPRESSED_RGBA_BPTC_UNORM;
+		default:
+			return GL_RGBA8;
+	}
+}
+
+size_t texture_shape_bytes(const TextureShape& shape) {
+	uint32_t blockSize = texture_block_size(shape.format);
+	size_t bytes = 0;
+	for (uint32_t level = 0; level < shape.levelCount; level++) {
+		uint32_t width = std::max(1u, shape.width >> level);
+		uint32_t height = std::max(1u, shape.height >> level);
+		bytes += (size_t)((width + blockSize - 1) / blockSize) * ((height + blockSize - 1) / blockSize) *
+				 texture_block_bytes(shape.format);
+	}
+	return bytes;
+}
+
+// Define (data != nullptr) ou só aloca um nível.
+static void specify_level(uint32_t format, int level, const TextureLevel& info, const void* data) {
+	if (format == TEXTURE_RGBA8) {
+		glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, info.width, info.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	} else {
+		glCompressedTexImage2D(GL_TEXTURE_2D, level, texture_internal_format(format), info.width, info.height, 0,
+							   (GLsizei)info.size, data);
+	}
+}
+
+bool decode_texture(const std::string& path, TextureData& texture, ThreadPool* pool) {
+	// Usa a textura preparada pelo assetcook (mipmaps já gerados), se existir.
+	TextureFile cooked;
+	if (open_texture_file(path, cooked)) {
+		const TextureFileHeader& header = cooked.getHeader();
+		texture.format = header.format;
+		texture.width = header.width;
+		texture.height = header.height;
+		texture.levels.clear();
+		uint64_t total = 0;
+		for (uint32_t level = 0; level < header.levelCount; level++) {
+			TextureLevel info = cooked.getLevel(level);
+			info.offset = total;
+			texture.levels.push_back(info);
+			total += info.size;
+		}
+		texture.data.resize(total);
+		for (uint32_t level = 0; level < header.levelCount; level++) {
+			memcpy(&texture.data[texture.levels[level].offset], cooked.getLevelData(level), texture.levels[level].size);
+		}
+		return true;
+	}
+
+	// Carrega a imagem (sempre com 4 canais, para enviar todas no mesmo formato) e gera os mipmaps em luz linear,
+	// dividindo cada nível entre as threads do pool.
+	int width, height, channels;
+	unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+	if (!pixels) {
+		return false;
+	}
+	MipOptions options;
+	options.pool = pool;
+	build_mip_chain(pixels, width, height, 4, texture, options);
+	stbi_image_free(pixels);
+	return true;
+}
+
+void TextureStreamer::initialize(ThreadPool* pool, size_t slotSize, int slotCount) {
+	this->pool = pool;
+	this->slotSize = slotSize;
+	slots.resize(slotCount);
+	for (int i = 0; i < slotCount; i++) {
+		slots[i] = {i * slotSize, nullptr};
+	}
+	nextSlot = 0;
+
+	GLint extensionCount = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+	for (GLint i = 0; i < extensionCount; i++) {
+		std::string extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		s3tcSupported |= extension == "GL_EXT_texture_compression_s3tc";
+		bptcSupported |= extension == "GL_ARB_texture_compression_bptc";
+	}
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, slotCount * slotSize, nullptr, GL_STREAM_DRAW);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	closed = false;
+}
+
+void TextureStreamer::destroy() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closed = true;
+		generations.clear();
+		layerShapes.clear();
+		decoded.clear();
+	}
+	uploads.clear();
+	gpuBytes.clear();
+	for (Slot& slot : slots) {
+		if (slot.fence) {
+			glDeleteSync(slot.fence);
+		}
+	}
+	slots.clear();
+	glDeleteBuffers(1, &buffer);
+	buffer = 0;
+}
+
+GLuint TextureStreamer::request(const std::string& path) {
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	// Configura os parâmetros.
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// Imagem provisória, usada até a leitura terminar.
+	const unsigned char placeholder[4] = {128, 128, 128, 255};
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	gpuBytes[texture] = sizeof(placeholder);
+
+	schedule(Target(texture, -1), path, true);
+	return texture;
+}
+
+void TextureStreamer::requestLayer(GLuint array, int layer, const TextureShape& shape, const std::string& path) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		layerShapes[Target(array, layer)] = shape;
+	}
+	schedule(Target(array, layer), path, true);
+}
+
+void TextureStreamer::reload(GLuint texture, const std::string& path, int layer) {
+	schedule(Target(texture, layer), path, false);
+}
+
+void TextureStreamer::release(GLuint texture) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		generations.erase(Target(texture, -1));
+	}
+	gpuBytes.erase(texture);
+	glDeleteTextures(1, &texture);
+}
+
+void TextureStreamer::releaseLayer(GLuint array, int layer) {
+	std::lock_guard<std::mutex> lock(mutex);
+	generations.erase(Target(array, layer));
+	layerShapes.erase(Target(array, layer));
+}
+
+bool TextureStreamer::probe(const std::string& path, TextureShape& shape) const {
+	TextureFile cooked;
+	if (open_texture_file(path, cooked)) {
+		const TextureFileHeader& header = cooked.getHeader();
+		shape.format = header.format;
+		shape.width = header.width;
+		shape.height = header.height;
+		shape.levelCount = header.levelCount;
+	} else {
+		// Só o cabeçalho da imagem; a cadeia gerada por build_mip_chain vai até 1x1.
+		int width, height, channels;
+		if (!stbi_info(path.c_str(), &width, &height, &channels)) {
+			return false;
+		}
+		shape.format = TEXTURE_RGBA8;
+		shape.width = width;
+		shape.height = height;
+		shape.levelCount = 1;
+		for (uint32_t size = std::max(shape.width, shape.height); size > 1; size /= 2) {
+			shape.levelCount++;
+		}
+	}
+	if (!isSupported(shape.format)) {
+		shape.format = TEXTURE_RGBA8;
+	}
+	return true;
+}
+
+void TextureStreamer::schedule(Target target, const std::string& path, bool created) {
+	uint64_t generation;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// Na recarga, a textura pode já ter sido apagada.
+		if (closed || (!created && !generations.count(target))) {
+			return;
+		}
+		generation = ++generations[target];
+	}
+	pending++;
+
+	pool->submit([this, target, generation, path] {
+		auto data = std::make_shared<TextureData>();
+		bool loaded = decode_texture(path, *data, pool);
+		if (!loaded) {
+			std::cout << "Failed to load texture " << path << std::endl;
+		} else if (!isSupported(data->format)) {
+			auto rgba = std::make_shared<TextureData>();
+			decompress_texture(*data, *rgba);
+			data = rgba;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto current = generations.find(target);
+		if (!loaded || closed || current == generations.end() || current->second != generation) {
+			pending--;
+			return;
+		}
+		// As camadas de um array têm todas a mesma forma (uma imagem alterada para outro tamanho não cabe mais nele).
+		if (target.second >= 0) {
+			const TextureShape& shape = layerShapes[target];
+			if (data->format != shape.format || data->width != shape.width || data->height != shape.height ||
+				data->levels.size() != shape.levelCount) {
+				std::cout << "Textura " << path << " com formato ou dimensoes diferentes das outras camadas do array"
+						  << std::endl;
+				pending--;
+				return;
+			}
+		}
+		decoded.push_back({target.first, target.second, generation, data, (int)data->levels.size() - 1, 0, false});
+	});
+}
+
+bool TextureStreamer::isSupported(uint32_t format) const {
+	switch (format) {
+		case TEXTURE_BC1:
+		case TEXTURE_BC3:
+			return s3tcSupported;
+		case TEXTURE_BC7:
+			return bptcSupported;
+		default:
+			return true;
+	}
+}
+
+bool TextureStreamer::isCurrent(const Upload& upload) {
+	std::lock_guard<std::mutex> lock(mutex);
+	auto current = generations.find(Target(upload.texture, upload.layer));
+	return current != generations.end() && current->second == upload.generation;
+}
+
+// Aloca todos os níveis com as dimensões da imagem e envia o menor direto (poucos bytes): a partir daqui a textura
+// mostra a cor média da imagem em vez da provisória.
+// As camadas de um array já estão alocadas: todos os níveis são enviados pelo anel.
+void TextureStreamer::specify(Upload& upload) {
+	const TextureData& data = *upload.data;
+	int last = (int)data.levels.size() - 1;
+	if (upload.layer >= 0) {
+		upload.level = last;
+		upload.row = 0;
+		upload.specified = true;
+		return;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, upload.texture);
+	gpuBytes[upload.texture] = 0;
+	for (const TextureLevel& info : data.levels) {
+		gpuBytes[upload.texture] += info.size;
+	}
+	for (int level = 0; level < last; level++) {
+		specify_level(data.format, level, data.levels[level], nullptr);
+	}
+	specify_level(data.format, last, data.levels[last], &data.data[data.levels[last].offset]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, last);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, last);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	upload.level = last - 1;
+	upload.row = 0;
+	upload.specified = true;
+}
+
+size_t TextureStreamer::uploadRows(Upload& upload, size_t budget) {
+	// O trecho do anel só é reescrito depois que a GPU terminou a cópia anterior feita a partir dele.
+	Slot& slot = slots[nextSlot];
+	if (slot.fence) {
+		if (glClientWaitSync(slot.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+			return 0;
+		}
+		glDeleteSync(slot.fence);
+		slot.fence = nullptr;
+	}
+
+	// Linhas de blocos 4x4 nos formatos comprimidos, de pixels em RGBA8.
+	uint32_t format = upload.data->format;
+	uint32_t blockSize = texture_block_size(format);
+	const TextureLevel& info = upload.data->levels[upload.level];
+	uint32_t rowCount = (info.height + blockSize - 1) / blockSize;
+	size_t rowSize = (size_t)((info.width + blockSize - 1) / blockSize) * texture_block_bytes(format);
+	size_t maxRows = std::max<size_t>(1, std::min(slotSize, budget) / rowSize);
+	uint32_t rows = (uint32_t)std::min<size_t>(rowCount - upload.row, maxRows);
+	size_t size = rows * rowSize;
+	const uint8_t* source = &upload.data->data[info.offset + upload.row * rowSize];
+
+	// O mapeamento sem sincronização é seguro pela cerca acima (o efeito de um buffer mapeado persistentemente).
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+	void* target = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, slot.offset, size,
+									GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	if (!target) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		return 0;
+	}
+	memcpy(target, source, size);
+	glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+	GLenum bindTarget = upload.layer >= 0 ? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D;
+	glBindTexture(bindTarget, upload.texture);
+	uint32_t y = upload.row * blockSize;
+	uint32_t height = std::min(rows * blockSize, info.height - y);
+	if (upload.layer >= 0 && format == TEXTURE_RGBA8) {
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, upload.level, 0, y, upload.layer, info.width, height, 1, GL_RGBA,
+						GL_UNSIGNED_BYTE, (const GLvoid*)slot.offset);
+	} else if (upload.layer >= 0) {
+		glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, upload.level, 0, y, upload.layer, info.width, height, 1,
+								  texture_internal_format(format), (GLsizei)size, (const GLvoid*)slot.offset);
+	} else if (format == TEXTURE_RGBA8) {
+		glTexSubImage2D(GL_TEXTURE_2D, upload.level, 0, y, info.width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+						(const GLvoid*)slot.offset);
+	} else {
+		glCompressedTexSubImage2D(GL_TEXTURE_2D, upload.level, 0, y, info.width, height,
+								  texture_internal_format(format), (GLsizei)size, (const GLvoid*)slot.offset);
+	}
+	slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	nextSlot = (nextSlot + 1) % slots.size();
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	upload.row += rows;
+	if (upload.row == rowCount) {
+		// Nível completo: passa a ser o mais detalhado amostrado (nas texturas 2D).
+		if (upload.layer < 0) {
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, upload.level);
+		}
+		upload.level--;
+		upload.row = 0;
+	}
+	glBindTexture(bindTarget, 0);
+	return size;
+}
+
+void TextureStreamer::update(size_t budget) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (Upload& upload : decoded) {
+			uploads.push_back(std::move(upload));
+		}
+		decoded.clear();
+	}
+
+	while (!uploads.empty() && budget > 0) {
+		Upload& upload = uploads.front();
+		// Substituída por uma leitura mais nova (recarga) ou textura sem níveis a enviar.
+		if (!isCurrent(upload)) {
+			uploads.pop_front();
+			pending--;
+			continue;
+		}
+		if (!upload.specified) {
+			specify(upload);
+		}
+		if (upload.level >= 0) {
+			size_t sent = uploadRows(upload, budget);
+			if (sent == 0) {
+				break;
+			}
+			budget -= std::min(sent, budget);
+		}
+		if (upload.level < 0) {
+			uploads.pop_front();
+			pending--;
+		}
+	}
+}
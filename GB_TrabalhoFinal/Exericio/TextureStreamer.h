@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+#include "TextureFile.h"
+#include "ThreadPool.h"
+
+// Formato em que a textura vai para a GPU, dimensões e número de níveis: as camadas de um array de texturas precisam
+// ter todos iguais.
+struct TextureShape {
+	uint32_t format = TEXTURE_RGBA8;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t levelCount = 0;
+
+	bool operator<(const TextureShape& other) const {
+		return std::tie(format, width, height, levelCount) <
+			   std::tie(other.format, other.width, other.height, other.levelCount);
+	}
+	bool operator==(const TextureShape& other) const {
+		return format == other.format && width == other.width && height == other.height &&
+			   levelCount == other.levelCount;
+	}
+};
+
+// Carregamento assíncrono de texturas. A imagem (ou o .gbtex do assetcook) é lida e decodificada no pool de threads,
+// junto com a cadeia de mipmaps; a thread de renderização envia os níveis aos poucos, a cada quadro, por um anel de
+// pixel buffer objects. Texturas comprimidas (BC1/BC3/BC7) vão à GPU em blocos, sem descompressão, se a placa tiver
+// suporte ao formato; se não tiver, são descomprimidas para RGBA8 no pool.
+// A textura é criada na hora com uma imagem provisória (cinza 1x1) e pode ser usada normalmente: os níveis chegam do
+// menor para o maior e GL_TEXTURE_BASE_LEVEL só desce até um nível já completo.
+// Também envia imagens para camadas de um GL_TEXTURE_2D_ARRAY já alocado (ver TextureArrays); nesse caso o nível base é
+// o do array inteiro e não muda, e a camada só mostra a imagem depois do envio do nível 0.
+class TextureStreamer {
+   public:
+	TextureStreamer() {}
+	TextureStreamer(const TextureStreamer&) = delete;
+	TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+	// slotSize = bytes de cada um dos slotCount trechos do anel de envio.
+	void initialize(ThreadPool* pool, size_t slotSize = 4 << 20, int slotCount = 3);
+	void destroy();
+
+	// Cria a textura (com a imagem provisória) e agenda a leitura do arquivo.
+	GLuint request(const std::string& path);
+	// Agenda a leitura do arquivo para a camada layer de um array alocado com o formato e as dimensões de shape. Uma
+	// imagem com outra forma é descartada (a camada fica como estava).
+	void requestLayer(GLuint array, int layer, const TextureShape& shape, const std::string& path);
+	// Lê de novo o arquivo de uma textura existente ou de uma camada (recarga). Pode ser chamada de qualquer thread;
+	// uma leitura anterior ainda não enviada da mesma textura é descartada.
+	void reload(GLuint texture, const std::string& path, int layer = -1);
+	// Apaga a textura, descartando a leitura e o envio ainda pendentes.
+	void release(GLuint texture);
+	// Descarta a leitura e o envio pendentes de uma camada (o array é apagado por quem o alocou).
+	void releaseLayer(GLuint array, int layer);
+
+	// Forma que a textura terá na GPU, lida só do cabeçalho do .gbtex ou da imagem (formatos comprimidos sem suporte na
+	// placa viram RGBA8). Retorna false se o arquivo não puder ser lido.
+	bool probe(const std::string& path, TextureShape& shape) const;
+
+	// Envia até budget bytes de níveis lidos. Chamada uma vez por quadro, na thread com o contexto OpenGL.
+	void update(size_t budget);
+
+	// Texturas lidas ou ainda sendo lidas/enviadas.
+	int getPendingCount() const { return pending; }
+	// Memória de vídeo alocada para a textura (todos os níveis, mesmo os ainda não enviados).
+	size_t getGpuBytes(GLuint texture) const {
+		auto bytes = gpuBytes.find(texture);
+		return bytes != gpuBytes.end() ? bytes->second : 0;
+	}
+
+   protected:
+	// Textura 2D (layer = -1) ou camada de um array.
+	using Target = std::pair<GLuint, int>;
+
+	struct Upload {
+		GLuint texture;
+		int layer;
+		uint64_t generation;
+		std::shared_ptr<TextureData> data;
+		int level;		// nível sendo enviado (do último para o 0)
+		uint32_t row;	// próxima linha de blocos do nível (de pixels em RGBA8)
+		bool specified;	// níveis já alocados com as dimensões da imagem
+	};
+
+	struct Slot {
+		size_t offset;
+		GLsync fence;
+	};
+
+	void schedule(Target target, const std::string& path, bool created);
+	void specify(Upload& upload);
+	// Envia uma parte do nível atual; retorna os bytes enviados (0 se o próximo trecho do anel ainda está em uso).
+	size_t uploadRows(Upload& upload, size_t budget);
+	bool isCurrent(const Upload& upload);
+	bool isSupported(uint32_t format) const;
+
+	ThreadPool* pool = nullptr;
+	GLuint buffer = 0;
+	size_t slotSize = 0;
+	std::vector<Slot> slots;
+	size_t nextSlot = 0;
+	std::deque<Upload> uploads;
+	std::atomic<int> pending{0};
+	std::map<GLuint, size_t> gpuBytes;
+	bool s3tcSupported = false;  // BC1 e BC3
+	bool bptcSupported = false;  // BC7
+
+	std::mutex mutex;
+	bool closed = false;
+	std::map<Target, uint64_t> generations;	 // leitura mais recente de cada textura ou camada
+	std::map<Target, TextureShape> layerShapes;
+	std::vector<Upload> decoded;
+};
+
+// Lê a textura preparada pelo assetcook (RGBA8 ou comprimida) ou decodifica a imagem (RGBA8) e gera os mipmaps.
+// Retorna false se o arquivo não puder ser lido. Com um pool, cada nível dos mipmaps é dividido entre as threads.
+bool decode_texture(const std::string& path, TextureData& texture, ThreadPool* pool = nullptr);
+
+// Formato interno da OpenGL correspondente a um TextureFormat.
+GLenum texture_internal_format(uint32_t format);
+
+// Bytes de todos os níveis de uma textura com a forma indicada.
+size_t texture_shape_bytes(const TextureShape& shape);
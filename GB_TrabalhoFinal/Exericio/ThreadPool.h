@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Conjunto fixo de threads que consomem uma fila de tarefas.
+class ThreadPool {
+   public:
+	// threads = 0 usa o número de núcleos da máquina.
+	explicit ThreadPool(int threads = 0) {
+		if (threads <= 0) {
+			threads = (int)std::thread::hardware_concurrency();
+		}
+		if (threads <= 0) {
+			threads = 1;
+		}
+		for (int i = 0; i < threads; i++) {
+			workers.emplace_back([this] { workerLoop(); });
+		}
+	}
+
+	~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		available.notify_all();
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int size() const { return (int)workers.size(); }
+
+	void submit(std::function<void()> task) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.push_back(std::move(task));
+		}
+		available.notify_one();
+		finished.notify_all();
+	}
+
+	// Executa body(i) para i em [0, count) nas threads do pool e espera o término.
+	// A thread chamadora também consome tarefas enquanto espera, então pode ser chamada de dentro de uma tarefa.
+	template <typename Body>
+	void parallelFor(int count, Body body) {
+		if (count <= 0) {
+			return;
+		}
+		if (count == 1) {
+			body(0);
+			return;
+		}
+
+		auto remaining = std::make_shared<std::atomic<int>>(count);
+		for (int i = 0; i < count; i++) {
+			submit([this, remaining, &body, i] {
+				body(i);
+				if (remaining->fetch_sub(1) == 1) {
+					std::lock_guard<std::mutex> lock(mutex);
+					finished.notify_all();
+				}
+			});
+		}
+
+		while (remaining->load() > 0) {
+			if (!runPendingTask()) {
+				std::unique_lock<std::mutex> lock(mutex);
+				finished.wait(lock, [&] { return remaining->load() == 0 || !tasks.empty(); });
+			}
+		}
+	}
+
+   protected:
+	bool runPendingTask() {
+		std::function<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tasks.empty()) {
+				return false;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+		return true;
+	}
+
+	void workerLoop() {
+		while (true) {
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				available.wait(lock, [this] { return stopping || !tasks.empty(); });
+				if (stopping && tasks.empty()) {
+					return;
+				}
+				task = std::move(tasks.front());
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable available;
+	std::condition_variable finished;
+	bool stopping = false;
+};
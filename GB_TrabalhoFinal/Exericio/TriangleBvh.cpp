@@ -0,0 +1,573 @@
+#include "TriangleBvh.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cstring>
+
+#include "CpuFeatures.h"
+
+// Nós a partir destes tamanhos montam as duas metades em tarefas do pool e calculam as caixas e as faixas em trechos
+// de BUILD_CHUNK triângulos, também em paralelo (nos menores, o custo das tarefas passa o ganho).
+static const size_t PARALLEL_SUBTREE_MIN = 4096;
+static const size_t PARALLEL_BINNING_MIN = 65536;
+static const size_t BUILD_CHUNK = 16384;
+
+// Bit de WideNode::child que marca uma folha (o resto é o índice do pacote).
+static const uint32_t WIDE_LEAF = 0x80000000u;
+
+TriangleSimd triangle_simd_supported() {
+#ifdef CPU_X86
+	return cpu_has_avx2() ? TRIANGLE_SIMD_AVX2 : TRIANGLE_SIMD_SSE2;
+#else
+	return TRIANGLE_SIMD_SCALAR;
+#endif
+}
+
+const char* triangle_simd_name(TriangleSimd simd) {
+	switch (simd) {
+		case TRIANGLE_SIMD_SCALAR:
+			return "escalar";
+		case TRIANGLE_SIMD_SSE2:
+			return "SSE2";
+		case TRIANGLE_SIMD_AVX2:
+			return "AVX2";
+		default:
+			return "auto";
+	}
+}
+
+static glm::vec3 read_position(const uint8_t* positions, size_t positionStride, uint32_t vertex) {
+	float position[3];
+	memcpy(position, positions + vertex * positionStride, sizeof(position));
+	return glm::vec3(position[0], position[1], position[2]);
+}
+
+static uint32_t corner_vertex(const uint32_t* indices, uint32_t triangle, int corner) {
+	return indices ? indices[3 * triangle + corner] : 3 * triangle + corner;
+}
+
+// Executa body(trecho, primeiro, último) nos trechos de BUILD_CHUNK elementos de [begin, end), em paralelo se houver
+// pool.
+template <typename Body>
+static void for_each_chunk(ThreadPool* pool, size_t begin, size_t end, Body body) {
+	size_t chunks = (end - begin + BUILD_CHUNK - 1) / BUILD_CHUNK;
+	auto run = [&](int chunk) {
+		size_t first = begin + (size_t)chunk * BUILD_CHUNK;
+		body((size_t)chunk, first, std::min(end, first + BUILD_CHUNK));
+	};
+	if (pool && chunks > 1) {
+		pool->parallelFor((int)chunks, run);
+	} else {
+		for (size_t chunk = 0; chunk < chunks; chunk++) {
+			run((int)chunk);
+		}
+	}
+}
+
+struct TriangleBvh::BuildContext {
+	ThreadPool* pool;
+	std::vector<BuildTriangle> triangles;
+	std::atomic<uint32_t> nodeCount;
+};
+
+void TriangleBvh::build(const uint8_t* positions, size_t positionStride, const uint32_t* indices,
+						size_t triangleCount, ThreadPool* pool) {
+	nodes.clear();
+	packets.clear();
+	wideNodes4.clear();
+	wideNodes8.clear();
+	this->triangleCount = triangleCount;
+	depth = 0;
+	width = 0;
+	wideDepth = 0;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	BuildContext context;
+	context.pool = pool;
+	context.triangles.resize(triangleCount);
+	for_each_chunk(pool, 0, triangleCount, [&](size_t, size_t first, size_t last) {
+		for (size_t t = first; t < last; t++) {
+			BuildTriangle& triangle = context.triangles[t];
+			triangle.box = Aabb();
+			for (int corner = 0; corner < 3; corner++) {
+				triangle.box.extend(
+					read_position(positions, positionStride, corner_vertex(indices, (uint32_t)t, corner)));
+			}
+			triangle.centroid = triangle.box.center();
+			triangle.index = (uint32_t)t;
+		}
+	});
+
+	// Uma árvore binária com folhas de 1 a 4 triângulos tem menos de 2 * triângulos nós. Os pares de filhos são
+	// reservados com um contador atômico: sem pool, a ordem é a da montagem em profundidade.
+	nodes.resize(2 * triangleCount);
+	context.nodeCount = 1;
+	depth = buildNode(context, 0, 0, triangleCount);
+	nodes.resize(context.nodeCount);
+	nodes.shrink_to_fit();
+
+	// Durante a montagem as folhas guardam a faixa dos seus triângulos em context.triangles; os pacotes seguem a ordem
+	// dos nós.
+	std::vector<uint32_t> leaves;
+	for (uint32_t node = 0; node < (uint32_t)nodes.size(); node++) {
+		if (nodes[node].count > 0) {
+			leaves.push_back(node);
+		}
+	}
+	packets.resize(leaves.size());
+	for_each_chunk(pool, 0, leaves.size(), [&](size_t, size_t first, size_t last) {
+		for (size_t leaf = first; leaf < last; leaf++) {
+			Node& node = nodes[leaves[leaf]];
+			Packet& packet = packets[leaf];
+			memset(&packet, 0, sizeof(packet));
+			for (uint32_t lane = 0; lane < node.count; lane++) {
+				uint32_t triangle = context.triangles[node.first + lane].index;
+				glm::vec3 v0 = read_position(positions, positionStride, corner_vertex(indices, triangle, 0));
+				glm::vec3 v1 = read_position(positions, positionStride, corner_vertex(indices, triangle, 1));
+				glm::vec3 v2 = read_position(positions, positionStride, corner_vertex(indices, triangle, 2));
+				for (int axis = 0; axis < 3; axis++) {
+					packet.origin[axis][lane] = v0[axis];
+					packet.edge1[axis][lane] = v1[axis] - v0[axis];
+					packet.edge2[axis][lane] = v2[axis] - v0[axis];
+				}
+				packet.triangle[lane] = triangle;
+			}
+			node.first = (uint32_t)leaf;
+		}
+	});
+}
+
+// Monta a subárvore dos triângulos context.triangles[begin, end) no nó node e retorna a sua profundidade. A partição
+// testa SAH_BINS faixas dos centros em cada eixo, como DynamicBvh::buildRange; sem partição útil (centros iguais),
+// divide ao meio.
+int TriangleBvh::buildNode(BuildContext& context, uint32_t node, size_t begin, size_t end) {
+	std::vector<BuildTriangle>& triangles = context.triangles;
+	size_t count = end - begin;
+	ThreadPool* pool = count >= PARALLEL_BINNING_MIN ? context.pool : nullptr;
+
+	// Caixa do nó e dos centros.
+	size_t chunks = (count + BUILD_CHUNK - 1) / BUILD_CHUNK;
+	std::vector<Aabb> chunkBoxes(pool ? 2 * chunks : 0);
+	Aabb box, centers;
+	for_each_chunk(pool, begin, end, [&](size_t chunk, size_t first, size_t last) {
+		Aabb chunkBox, chunkCenters;
+		for (size_t i = first; i < last; i++) {
+			chunkBox.extend(triangles[i].box);
+			chunkCenters.extend(triangles[i].centroid);
+		}
+		if (pool) {
+			chunkBoxes[2 * chunk] = chunkBox;
+			chunkBoxes[2 * chunk + 1] = chunkCenters;
+		} else {
+			box.extend(chunkBox);
+			centers.extend(chunkCenters);
+		}
+	});
+	for (size_t chunk = 0; chunk < chunkBoxes.size(); chunk += 2) {
+		box.extend(chunkBoxes[chunk]);
+		centers.extend(chunkBoxes[chunk + 1]);
+	}
+	nodes[node].box = box;
+
+	// Folha: a faixa dos triângulos vira um pacote no fim de build.
+	if (count <= (size_t)PACKET_SIZE) {
+		nodes[node].first = (uint32_t)begin;
+		nodes[node].count = (uint32_t)count;
+		return 1;
+	}
+
+	// Distribuição dos triângulos nas faixas dos três eixos (DynamicBvh.h: SahBins), em trechos somados no fim.
+	glm::vec3 scale = sah_bin_scale(centers);
+	std::vector<SahBins> chunkBins(pool ? chunks : 0);
+	SahBins bins;
+	for_each_chunk(pool, begin, end, [&](size_t chunk, size_t first, size_t last) {
+		SahBins& target = pool ? chunkBins[chunk] : bins;
+		for (size_t i = first; i < last; i++) {
+			target.add(triangles[i].box, triangles[i].centroid, centers, scale);
+		}
+	});
+	for (const SahBins& chunk : chunkBins) {
+		bins.merge(chunk);
+	}
+
+	size_t middle = begin + count / 2;
+	SahSplit split = sah_best_split(bins, centers);
+	if (split.axis >= 0) {
+		float minimum = centers.boundsMin[split.axis], axisScale = scale[split.axis];
+		auto right = std::partition(triangles.begin() + begin, triangles.begin() + end, [&](const BuildTriangle& t) {
+			return sah_bin(t.centroid[split.axis], minimum, axisScale) <= split.bin;
+		});
+		middle = right - triangles.begin();
+	}
+
+	// Os filhos ficam lado a lado. As duas metades de um nó grande são montadas em tarefas do pool; a thread que
+	// espera executa outras tarefas pendentes (de qualquer subárvore) enquanto isso.
+	uint32_t children = context.nodeCount.fetch_add(2);
+	nodes[node].first = children;
+	nodes[node].count = 0;
+	int depths[2];
+	auto buildChild = [&](int c) {
+		depths[c] = c == 0 ? buildNode(context, children, begin, middle)
+							: buildNode(context, children + 1, middle, end);
+	};
+	if (context.pool && count >= PARALLEL_SUBTREE_MIN) {
+		context.pool->parallelFor(2, buildChild);
+	} else {
+		buildChild(0);
+		buildChild(1);
+	}
+	return 1 + std::max(depths[0], depths[1]);
+}
+
+void TriangleBvh::collapse(int width) {
+	wideNodes4.clear();
+	wideNodes8.clear();
+	this->width = 0;
+	wideDepth = 0;
+	if (nodes.empty() || (width != 4 && width != 8)) {
+		return;
+	}
+	if (width == 8) {
+		wideNodes8.reserve(nodes.size() / 4 + 1);
+		collapseNode(wideNodes8, 0, 1);
+	} else {
+		wideNodes4.reserve(nodes.size() / 2 + 1);
+		collapseNode(wideNodes4, 0, 1);
+	}
+	this->width = width;
+}
+
+// Cria o nó de W filhos equivalente ao nó binário node e retorna o seu índice: começa com os dois filhos e troca o
+// filho interno de maior área pelos dois filhos dele até ter W (ou só restarem folhas).
+template <int W>
+uint32_t TriangleBvh::collapseNode(std::vector<WideNode<W>>& wide, uint32_t node, int level) {
+	wideDepth = std::max(wideDepth, level);
+	uint32_t children[W];
+	int count = 0;
+	if (nodes[node].count > 0) {
+		children[count++] = node;
+	} else {
+		children[count++] = nodes[node].first;
+		children[count++] = nodes[node].first + 1;
+		while (count < W) {
+			int opened = -1;
+			float largest = -1.0f;
+			for (int i = 0; i < count; i++) {
+				if (nodes[children[i]].count == 0 && nodes[children[i]].box.area() > largest) {
+					largest = nodes[children[i]].box.area();
+					opened = i;
+				}
+			}
+			if (opened < 0) {
+				break;
+			}
+			uint32_t first = nodes[children[opened]].first;
+			children[opened] = first;
+			children[count++] = first + 1;
+		}
+	}
+
+	uint32_t index = (uint32_t)wide.size();
+	wide.emplace_back();
+	memset(&wide[index], 0, sizeof(WideNode<W>));
+	for (int i = 0; i < count; i++) {
+		const Aabb& box = nodes[children[i]].box;
+		for (int axis = 0; axis < 3; axis++) {
+			wide[index].boundsMin[axis][i] = box.boundsMin[axis];
+			wide[index].boundsMax[axis][i] = box.boundsMax[axis];
+		}
+	}
+	wide[index].childCount = (uint32_t)count;
+	// A recursão pode realocar o vetor: o nó é acessado pelo índice depois de cada filho.
+	for (int i = 0; i < count; i++) {
+		const Node& child = nodes[children[i]];
+		uint32_t code = child.count > 0 ? WIDE_LEAF | child.first : collapseNode(wide, children[i], level + 1);
+		wide[index].child[i] = code;
+	}
+	return index;
+}
+
+// Teste de Möller e Trumbore nos triângulos do pacote: retorna a posição do acerto mais próximo antes de maxDistance
+// (-1 se nenhum) e a sua distância em hitDistance. Os triângulos sem área (determinante nulo) nunca são atingidos.
+static int intersect_packet_scalar(const float (*origin)[4], const float (*edge1)[4], const float (*edge2)[4],
+								   const Ray& ray, float maxDistance, float& hitDistance) {
+	int hit = -1;
+	for (int lane = 0; lane < TriangleBvh::PACKET_SIZE; lane++) {
+		float e1x = edge1[0][lane], e1y = edge1[1][lane], e1z = edge1[2][lane];
+		float e2x = edge2[0][lane], e2y = edge2[1][lane], e2z = edge2[2][lane];
+		float px = ray.direction.y * e2z - ray.direction.z * e2y;
+		float py = ray.direction.z * e2x - ray.direction.x * e2z;
+		float pz = ray.direction.x * e2y - ray.direction.y * e2x;
+		float determinant = e1x * px + e1y * py + e1z * pz;
+		float inverse = 1.0f / determinant;
+		float tx = ray.origin.x - origin[0][lane];
+		float ty = ray.origin.y - origin[1][lane];
+		float tz = ray.origin.z - origin[2][lane];
+		float u = (tx * px + ty * py + tz * pz) * inverse;
+		float qx = ty * e1z - tz * e1y;
+		float qy = tz * e1x - tx * e1z;
+		float qz = tx * e1y - ty * e1x;
+		float v = (ray.direction.x * qx + ray.direction.y * qy + ray.direction.z * qz) * inverse;
+		float t = (e2x * qx + e2y * qy + e2z * qz) * inverse;
+		if (determinant != 0.0f && u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= 0.0f && t < maxDistance) {
+			maxDistance = t;
+			hit = lane;
+		}
+	}
+	hitDistance = maxDistance;
+	return hit;
+}
+
+#ifdef CPU_X86
+// Mesmo teste, os 4 triângulos de uma vez.
+static int intersect_packet_sse2(const float (*origin)[4], const float (*edge1)[4], const float (*edge2)[4],
+								 const Ray& ray, float maxDistance, float& hitDistance) {
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 dx = _mm_set1_ps(ray.direction.x), dy = _mm_set1_ps(ray.direction.y), dz = _mm_set1_ps(ray.direction.z);
+	__m128 e1x = _mm_loadu_ps(edge1[0]), e1y = _mm_loadu_ps(edge1[1]), e1z = _mm_loadu_ps(edge1[2]);
+	__m128 e2x = _mm_loadu_ps(edge2[0]), e2y = _mm_loadu_ps(edge2[1]), e2z = _mm_loadu_ps(edge2[2]);
+	__m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+	__m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+	__m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+	__m128 determinant = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+	__m128 inverse = _mm_div_ps(one, determinant);
+	__m128 tx = _mm_sub_ps(_mm_set1_ps(ray.origin.x), _mm_loadu_ps(origin[0]));
+	__m128 ty = _mm_sub_ps(_mm_set1_ps(ray.origin.y), _mm_loadu_ps(origin[1]));
+	__m128 tz = _mm_sub_ps(_mm_set1_ps(ray.origin.z), _mm_loadu_ps(origin[2]));
+	__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tx, px), _mm_mul_ps(ty, py)), _mm_mul_ps(tz, pz)), inverse);
+	__m128 qx = _mm_sub_ps(_mm_mul_ps(ty, e1z), _mm_mul_ps(tz, e1y));
+	__m128 qy = _mm_sub_ps(_mm_mul_ps(tz, e1x), _mm_mul_ps(tx, e1z));
+	__m128 qz = _mm_sub_ps(_mm_mul_ps(tx, e1y), _mm_mul_ps(ty, e1x));
+	__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), inverse);
+	__m128 t =
+		_mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), inverse);
+
+	__m128 hit = _mm_and_ps(_mm_cmpneq_ps(determinant, zero), _mm_cmpge_ps(u, zero));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(v, zero));
+	hit = _mm_and_ps(hit, _mm_cmple_ps(_mm_add_ps(u, v), one));
+	hit = _mm_and_ps(hit, _mm_cmpge_ps(t, zero));
+	hit = _mm_and_ps(hit, _mm_cmplt_ps(t, _mm_set1_ps(maxDistance)));
+	if (_mm_movemask_ps(hit) == 0) {
+		hitDistance = maxDistance;
+		return -1;
+	}
+
+	// Menor distância entre os acertos e a primeira posição que a tem (a mesma que o caminho escalar escolhe).
+	__m128 distances = _mm_or_ps(_mm_and_ps(hit, t), _mm_andnot_ps(hit, _mm_set1_ps(FLT_MAX)));
+	__m128 closest = _mm_min_ps(distances, _mm_shuffle_ps(distances, distances, _MM_SHUFFLE(2, 3, 0, 1)));
+	closest = _mm_min_ps(closest, _mm_shuffle_ps(closest, closest, _MM_SHUFFLE(1, 0, 3, 2)));
+	int lanes = _mm_movemask_ps(_mm_and_ps(hit, _mm_cmpeq_ps(distances, closest)));
+	hitDistance = _mm_cvtss_f32(closest);
+	int lane = 0;
+	while (!((lanes >> lane) & 1)) {
+		lane++;
+	}
+	return lane;
+}
+
+// Entrada da semirreta nas caixas dos filhos de um nó de 4 (mesmas contas de ray_aabb). Retorna a máscara dos filhos
+// válidos atingidos antes de maxDistance.
+static int wide_boxes_sse2(const float (*boundsMin)[4], const float (*boundsMax)[4], uint32_t childCount,
+						   const float origin[3], const float inverseDirection[3], float maxDistance,
+						   float entries[4]) {
+	__m128 closer[3], farther[3];
+	for (int axis = 0; axis < 3; axis++) {
+		__m128 o = _mm_set1_ps(origin[axis]), inverse = _mm_set1_ps(inverseDirection[axis]);
+		__m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boundsMin[axis]), o), inverse);
+		__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(boundsMax[axis]), o), inverse);
+		closer[axis] = _mm_min_ps(t0, t1);
+		farther[axis] = _mm_max_ps(t0, t1);
+	}
+	__m128 entry = _mm_max_ps(_mm_max_ps(closer[0], closer[1]), _mm_max_ps(closer[2], _mm_setzero_ps()));
+	__m128 exit = _mm_min_ps(_mm_min_ps(farther[0], farther[1]), _mm_min_ps(farther[2], _mm_set1_ps(maxDistance)));
+	_mm_storeu_ps(entries, entry);
+	return _mm_movemask_ps(_mm_cmple_ps(entry, exit)) & ((1 << childCount) - 1);
+}
+
+// Mesmo teste nos filhos de um nó de 8.
+CPU_TARGET_AVX2 static int wide_boxes_avx2(const float (*boundsMin)[8], const float (*boundsMax)[8],
+												uint32_t childCount, const float origin[3],
+												const float inverseDirection[3], float maxDistance, float entries[8]) {
+	__m256 closer[3], farther[3];
+	for (int axis = 0; axis < 3; axis++) {
+		__m256 o = _mm256_set1_ps(origin[axis]), inverse = _mm256_set1_ps(inverseDirection[axis]);
+		__m256 t0 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boundsMin[axis]), o), inverse);
+		__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(boundsMax[axis]), o), inverse);
+		closer[axis] = _mm256_min_ps(t0, t1);
+		farther[axis] = _mm256_max_ps(t0, t1);
+	}
+	__m256 entry = _mm256_max_ps(_mm256_max_ps(closer[0], closer[1]), _mm256_max_ps(closer[2], _mm256_setzero_ps()));
+	__m256 exit =
+		_mm256_min_ps(_mm256_min_ps(farther[0], farther[1]), _mm256_min_ps(farther[2], _mm256_set1_ps(maxDistance)));
+	_mm256_storeu_ps(entries, entry);
+	return _mm256_movemask_ps(_mm256_cmp_ps(entry, exit, _CMP_LE_OQ)) & ((1 << childCount) - 1);
+}
+
+// Percurso das árvores de W filhos: testBoxes dá as entradas nas caixas dos filhos de um nó e a máscara dos atingidos,
+// que são empilhados do mais distante para o mais próximo (o mais próximo fica no topo).
+template <int W, typename WideNodeT, typename PacketT, typename BoxTest>
+static bool intersect_wide(const std::vector<WideNodeT>& wide, const std::vector<PacketT>& packets, int depth,
+						   const Ray& ray, float& distance, uint32_t& triangle, BoxTest testBoxes) {
+	float origin[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+	float inverseDirection[3] = {1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z};
+
+	// Cada nível deixa na pilha no máximo W - 1 filhos além do visitado.
+	struct Entry {
+		uint32_t child;
+		float entry;
+	};
+	Entry local[256];
+	std::vector<Entry> allocated;
+	Entry* stack = local;
+	size_t capacity = (size_t)depth * (W - 1) + 2;
+	if (capacity > 256) {
+		allocated.resize(capacity);
+		stack = allocated.data();
+	}
+	int size = 0;
+	stack[size++] = {0, 0.0f};
+
+	bool found = false;
+	while (size > 0) {
+		Entry top = stack[--size];
+		if (top.entry > distance) {
+			continue;
+		}
+		if (top.child & WIDE_LEAF) {
+			const PacketT& packet = packets[top.child & ~WIDE_LEAF];
+			float hitDistance;
+			int lane = intersect_packet_sse2(packet.origin, packet.edge1, packet.edge2, ray, distance, hitDistance);
+			if (lane >= 0) {
+				distance = hitDistance;
+				triangle = packet.triangle[lane];
+				found = true;
+			}
+			continue;
+		}
+
+		const WideNodeT& node = wide[top.child];
+		float entries[W];
+		int mask = testBoxes(node.boundsMin, node.boundsMax, node.childCount, origin, inverseDirection, distance,
+							 entries);
+		int order[W];
+		int hits = 0;
+		for (int i = 0; i < W; i++) {
+			if ((mask >> i) & 1) {
+				// Inserção em ordem decrescente de entrada.
+				int position = hits++;
+				while (position > 0 && entries[order[position - 1]] < entries[i]) {
+					order[position] = order[position - 1];
+					position--;
+				}
+				order[position] = i;
+			}
+		}
+		for (int h = 0; h < hits; h++) {
+			stack[size++] = {node.child[order[h]], entries[order[h]]};
+		}
+	}
+	return found;
+}
+#endif
+
+bool TriangleBvh::intersect(const Ray& ray, float& distance, uint32_t& triangle, TriangleSimd simd) const {
+	static const TriangleSimd supported = triangle_simd_supported();
+	if (simd == TRIANGLE_SIMD_AUTO || simd > supported) {
+		simd = supported;
+	}
+	if (nodes.empty()) {
+		return false;
+	}
+	if (simd == TRIANGLE_SIMD_AVX2 && width == 8) {
+		return intersectWide8(ray, distance, triangle);
+	}
+	if (simd >= TRIANGLE_SIMD_SSE2 && width == 4) {
+		return intersectWide4(ray, distance, triangle);
+	}
+	return intersectBinary(ray, distance, triangle, simd >= TRIANGLE_SIMD_SSE2);
+}
+
+bool TriangleBvh::intersectWide4(const Ray& ray, float& distance, uint32_t& triangle) const {
+#ifdef CPU_X86
+	return intersect_wide<4>(wideNodes4, packets, wideDepth, ray, distance, triangle, wide_boxes_sse2);
+#else
+	return intersectBinary(ray, distance, triangle, false);
+#endif
+}
+
+bool TriangleBvh::intersectWide8(const Ray& ray, float& distance, uint32_t& triangle) const {
+#ifdef CPU_X86
+	return intersect_wide<8>(wideNodes8, packets, wideDepth, ray, distance, triangle, wide_boxes_avx2);
+#else
+	return intersectBinary(ray, distance, triangle, false);
+#endif
+}
+
+bool TriangleBvh::intersectBinary(const Ray& ray, float& distance, uint32_t& triangle, bool sse2) const {
+	glm::vec3 inverseDirection = 1.0f / ray.direction;
+	float entry;
+	if (!ray_aabb(nodes[0].box, ray.origin, inverseDirection, distance, entry)) {
+		return false;
+	}
+
+	// Pilha dos nós a visitar com a entrada da semirreta em cada um; a profundidade da árvore limita o seu tamanho.
+	struct Entry {
+		uint32_t node;
+		float entry;
+	};
+	Entry local[64];
+	std::vector<Entry> allocated;
+	Entry* stack = local;
+	if (depth + 1 > 64) {
+		allocated.resize(depth + 1);
+		stack = allocated.data();
+	}
+	int size = 0;
+	stack[size++] = {0, entry};
+
+	bool found = false;
+	while (size > 0) {
+		Entry top = stack[--size];
+		if (top.entry > distance) {
+			continue;
+		}
+		const Node& node = nodes[top.node];
+		if (node.count > 0) {
+			const Packet& packet = packets[node.first];
+			float hitDistance;
+#ifdef CPU_X86
+			int lane = sse2 ? intersect_packet_sse2(packet.origin, packet.edge1, packet.edge2, ray, distance,
+													hitDistance)
+							: intersect_packet_scalar(packet.origin, packet.edge1, packet.edge2, ray, distance,
+													  hitDistance);
+#else
+			int lane = intersect_packet_scalar(packet.origin, packet.edge1, packet.edge2, ray, distance, hitDistance);
+#endif
+			if (lane >= 0) {
+				distance = hitDistance;
+				triangle = packet.triangle[lane];
+				found = true;
+			}
+			continue;
+		}
+
+		float entries[2];
+		bool hits[2];
+		for (int c = 0; c < 2; c++) {
+			hits[c] = ray_aabb(nodes[node.first + c].box, ray.origin, inverseDirection, distance, entries[c]);
+		}
+		// O filho mais próximo fica no topo da pilha.
+		int first = entries[1] < entries[0] ? 1 : 0;
+		if (hits[1 - first]) {
+			stack[size++] = {node.first + 1 - first, entries[1 - first]};
+		}
+		if (hits[first]) {
+			stack[size++] = {node.first + first, entries[first]};
+		}
+	}
+	return found;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Caixa envolvente (Aabb) e semirreta (Ray)
+#include "DynamicBvh.h"
+#include "ThreadPool.h"
+
+// Hierarquia de volumes envolventes estática sobre os triângulos de uma malha, nas coordenadas do modelo, para
+// consultas de raios (seleção com o mouse, colisão, traçado de raios na CPU).
+// - A árvore binária é montada uma única vez (SAH com intervalos, como em DynamicBvh::build), com as duas metades dos
+//   nós grandes montadas em tarefas do pool, e fica em dois arrays contíguos: os nós, de 32 bytes, com os dois filhos
+//   de cada nó interno lado a lado, e os pacotes das folhas, com até 4 triângulos em SoA testados contra a semirreta de
+//   uma vez (Möller e Trumbore).
+// - collapse gera a versão com 4 ou 8 filhos por nó, com as caixas dos filhos em SoA: cada nó é testado com uma
+//   instrução por plano (SSE2 ou AVX2) e a árvore tem de metade a um terço da profundidade.
+// Os caminhos escalar e vetorizados fazem as mesmas contas, na mesma ordem, e dão as mesmas distâncias.
+
+enum TriangleSimd {
+	TRIANGLE_SIMD_AUTO,	   // o melhor disponível no processador
+	TRIANGLE_SIMD_SCALAR,  // árvore binária, um triângulo por vez
+	TRIANGLE_SIMD_SSE2,	   // nós de 4 filhos (árvore binária sem collapse(4)), 4 triângulos por vez
+	TRIANGLE_SIMD_AVX2,	   // nós de 8 filhos (como SSE2 sem collapse(8))
+};
+
+// Melhor conjunto de instruções disponível (nunca TRIANGLE_SIMD_AUTO) e o seu nome.
+TriangleSimd triangle_simd_supported();
+const char* triangle_simd_name(TriangleSimd simd);
+
+class TriangleBvh {
+   public:
+	static const int PACKET_SIZE = 4;
+
+	// Monta a árvore binária com os triângulos indices[3 * t], indices[3 * t + 1], indices[3 * t + 2], t <
+	// triangleCount (indices nulo = vértices em sequência). positions: x, y, z em float, a cada positionStride bytes.
+	// Com pool, os nós grandes são divididos em paralelo; a árvore é a mesma da montagem sem pool.
+	void build(const uint8_t* positions, size_t positionStride, const uint32_t* indices, size_t triangleCount,
+			   ThreadPool* pool = nullptr);
+
+	// Gera a versão com width (4 ou 8) filhos por nó a partir da árvore binária, substituindo a anterior: cada nó
+	// absorve os netos dos filhos de maior área até ter width filhos. Os pacotes das folhas são os mesmos. Outro width
+	// (ex.: 0) só descarta a versão colapsada.
+	void collapse(int width);
+
+	// Acerto mais próximo da semirreta (dos dois lados dos triângulos) antes de distance. Retorna true e atualiza
+	// distance e triangle (índice t de build). A distância é medida em unidades de ray.direction, que não precisa ser
+	// unitária: uma semirreta do mundo levada para o modelo pela inversa da matriz modelo mantém as distâncias do
+	// mundo. Um simd não suportado pelo processador é rebaixado para o melhor suportado.
+	bool intersect(const Ray& ray, float& distance, uint32_t& triangle, TriangleSimd simd = TRIANGLE_SIMD_AUTO) const;
+
+	size_t getTriangleCount() const { return triangleCount; }
+	size_t getNodeCount() const { return nodes.size(); }
+	int getDepth() const { return depth; }
+	// Filhos por nó da versão colapsada (0 = só a árvore binária), quantidade e profundidade dos seus nós.
+	int getWidth() const { return width; }
+	size_t getWideNodeCount() const { return width == 8 ? wideNodes8.size() : wideNodes4.size(); }
+	int getWideDepth() const { return wideDepth; }
+	// Memória ocupada pelos nós (das duas versões) e pacotes.
+	size_t getMemoryBytes() const {
+		return nodes.size() * sizeof(Node) + wideNodes4.size() * sizeof(WideNode<4>) +
+			   wideNodes8.size() * sizeof(WideNode<8>) + packets.size() * sizeof(Packet);
+	}
+
+   protected:
+	// Nó interno (count = 0): filhos em nodes[first] e nodes[first + 1]. Folha: count triângulos em packets[first].
+	struct Node {
+		Aabb box;
+		uint32_t first;
+		uint32_t count;
+	};
+
+	// Triângulos de uma folha: primeiro vértice e as duas arestas que saem dele, um componente por array. As posições
+	// sem triângulo ficam com arestas nulas e nunca são atingidas.
+	struct Packet {
+		float origin[3][PACKET_SIZE];
+		float edge1[3][PACKET_SIZE];
+		float edge2[3][PACKET_SIZE];
+		uint32_t triangle[PACKET_SIZE];
+	};
+
+	// Nó com até W filhos, os childCount primeiros válidos: caixas em SoA e, em child, o índice do nó filho ou, com o
+	// bit mais alto ligado, o do pacote da folha.
+	template <int W>
+	struct WideNode {
+		float boundsMin[3][W];
+		float boundsMax[3][W];
+		uint32_t child[W];
+		uint32_t childCount;
+	};
+
+	struct BuildTriangle {
+		Aabb box;
+		glm::vec3 centroid;
+		uint32_t index;
+	};
+	struct BuildContext;
+
+	int buildNode(BuildContext& context, uint32_t node, size_t begin, size_t end);
+	template <int W>
+	uint32_t collapseNode(std::vector<WideNode<W>>& wide, uint32_t node, int level);
+
+	bool intersectBinary(const Ray& ray, float& distance, uint32_t& triangle, bool sse2) const;
+	bool intersectWide4(const Ray& ray, float& distance, uint32_t& triangle) const;
+	bool intersectWide8(const Ray& ray, float& distance, uint32_t& triangle) const;
+
+	std::vector<Node> nodes;
+	std::vector<Packet> packets;
+	std::vector<WideNode<4>> wideNodes4;
+	std::vector<WideNode<8>> wideNodes8;
+	size_t triangleCount = 0;
+	int depth = 0;
+	int width = 0;
+	int wideDepth = 0;
+};
+
+// Acerto mais próximo da semirreta do mundo ray com os triângulos de uma instância de matriz modelo model (a seleção
+// com o mouse): a semirreta é levada para o modelo por transform_ray e a distância continua sendo a do mundo.
+inline bool intersect_instance(const TriangleBvh& bvh, const glm::mat4& model, const Ray& ray, float& distance,
+							   uint32_t& triangle, TriangleSimd simd = TRIANGLE_SIMD_AUTO) {
+	return bvh.intersect(transform_ray(glm::inverse(model), ray), distance, triangle, simd);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// GLAD
+#include <glad/glad.h>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "Material.h"
+
+// Pontos de ligação dos blocos uniformes declarados em Shader.vs/Shader.fs.
+const GLuint FRAME_BLOCK_BINDING = 0;
+const GLuint MATERIAL_BLOCK_BINDING = 1;
+
+// Tamanho do array de materiais do MaterialBlock (deve ser igual ao MAX_MATERIALS dos shaders). 128 * 80 bytes fica
+// abaixo dos 16 KB garantidos para GL_MAX_UNIFORM_BLOCK_SIZE.
+const int MAX_MATERIALS = 128;
+
+// Bloco por quadro (layout std140): matrizes da câmera e fonte de luz. Vetores de 3 componentes ocupam 16 bytes.
+struct FrameBlockData {
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec4 cameraPos;
+	glm::vec4 lightPos;
+	glm::vec4 lightColor;
+};
+static_assert(sizeof(FrameBlockData) == 176, "FrameBlockData deve seguir o layout std140 de FrameBlock");
+
+// Material no layout std140 de MaterialData. params = (Ns, Ni, d, illum).
+struct MaterialBlockData {
+	glm::vec4 ka;
+	glm::vec4 kd;
+	glm::vec4 ks;
+	glm::vec4 ke;
+	glm::vec4 params;
+
+	MaterialBlockData() {}
+	explicit MaterialBlockData(const Material& material)
+		: ka(material.Ka, 0.0f),
+		  kd(material.Kd, 0.0f),
+		  ks(material.Ks, 0.0f),
+		  ke(material.Ke, 0.0f),
+		  params(material.Ns, material.Ni, material.d, (float)material.illum) {}
+};
+static_assert(sizeof(MaterialBlockData) == 80, "MaterialBlockData deve seguir o layout std140 de MaterialData");
+
+// Buffer de um bloco uniforme, ligado a um ponto de ligação fixo.
+class UniformBuffer {
+   public:
+	void initialize(GLuint binding, GLsizeiptr size, const void* data = nullptr) {
+		glGenBuffers(1, &buffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferData(GL_UNIFORM_BUFFER, size, data, data ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void destroy() { glDeleteBuffers(1, &buffer); }
+
+	void update(const void* data, GLsizeiptr size, GLintptr offset = 0) {
+		glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+   protected:
+	GLuint buffer = 0;
+};
@@ -0,0 +1,223 @@
+// Benchmark da BVH dinâmica (DynamicBvh.h) com 1 mil, 100 mil e 1 milhão de entidades: caixas de 0.5 a 2 unidades
+// espalhadas com densidade constante (um cubo de lado 4 * raiz cúbica de n, centrado na origem). Para cada tamanho:
+// - montagem pela SAH (build), inserção incremental de todas as folhas e rebuild depois da inserção: tempo, custo SAH
+//   (áreas dos nós internos relativas à raiz) e altura;
+// - movimento de todas as entidades (até 0.5 unidade): setBounds + refit, update folha a folha (refit dos ancestrais)
+//   e o custo da árvore depois do movimento;
+// - remoção e reinserção de 10% das entidades;
+// - consultas, comparadas com a varredura linear de todas as caixas (que devem dar os mesmos resultados): frustum da
+//   Camera (45 graus, 800x600, planos em 0.1 e 100) da origem em 8 direções, 1000 raios com o acerto mais próximo e
+//   1000 caixas de 4 unidades.
+// Uso: bvh_bench [entidades...] (padrão: 1000 100000 1000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "DynamicBvh.h"
+
+using namespace std;
+
+static uint32_t seed = 12345;
+
+static float random_unit() {
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) / 16777216.0f;
+}
+
+static glm::vec3 random_vec3(float low, float high) {
+	float x = random_unit(), y = random_unit(), z = random_unit();
+	return glm::vec3(low) + (high - low) * glm::vec3(x, y, z);
+}
+
+template <typename Step>
+static double elapsed_ms(Step step) {
+	auto start = chrono::steady_clock::now();
+	step();
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+static bool inside_frustum(const Frustum& frustum, const Aabb& box) {
+	glm::vec3 center = box.center(), extent = (box.boundsMax - box.boundsMin) * 0.5f;
+	for (const glm::vec4& plane : frustum.planes) {
+		if (glm::dot(glm::vec3(plane), center) + plane.w + glm::dot(glm::abs(glm::vec3(plane)), extent) < 0.0f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Entrada da semirreta na caixa mais próxima que ela atravessa (maxDistance se nenhuma).
+static float closest_linear(const vector<Aabb>& boxes, const Ray& ray, float maxDistance) {
+	glm::vec3 inverseDirection = 1.0f / ray.direction;
+	for (const Aabb& box : boxes) {
+		float entry;
+		if (ray_aabb(box, ray.origin, inverseDirection, maxDistance, entry)) {
+			maxDistance = entry;
+		}
+	}
+	return maxDistance;
+}
+
+static void print_tree(const char* step, double ms, const DynamicBvh& bvh) {
+	printf("  %-34s %10.2f ms   custo %9.1f   altura %3d\n", step, ms, bvh.getCost(), bvh.getHeight());
+}
+
+static void print_query(const char* query, double bvhMs, double linearMs, size_t results, bool same) {
+	printf("  %-34s %10.3f ms   linear %10.3f ms (%6.1fx)   %zu resultados%s\n", query, bvhMs, linearMs,
+		   linearMs / bvhMs, results, same ? "" : "   DIFERENTE DA VARREDURA");
+}
+
+static void run(int count) {
+	float side = 4.0f * cbrt((float)count);
+	vector<Aabb> boxes(count);
+	for (Aabb& box : boxes) {
+		glm::vec3 center = random_vec3(-side * 0.5f, side * 0.5f);
+		glm::vec3 extent = random_vec3(0.25f, 1.0f);
+		box = {center - extent, center + extent};
+	}
+	printf("%d entidades (cubo de %.0f unidades)\n", count, side);
+
+	// Montagem.
+	DynamicBvh built;
+	print_tree("build (SAH)", elapsed_ms([&] { built.build(boxes); }), built);
+	DynamicBvh bvh;
+	print_tree("insercao incremental", elapsed_ms([&] {
+				   for (int i = 0; i < count; i++) {
+					   bvh.insert(boxes[i], (uint32_t)i);
+				   }
+			   }),
+			   bvh);
+	print_tree("rebuild das folhas inseridas", elapsed_ms([&] { bvh.rebuild(); }), bvh);
+
+	// Movimento: a árvore montada recebe as caixas deslocadas.
+	vector<Aabb> moved(boxes);
+	for (Aabb& box : moved) {
+		glm::vec3 offset = random_vec3(-0.5f, 0.5f);
+		box = {box.boundsMin + offset, box.boundsMax + offset};
+	}
+	DynamicBvh updated = built;
+	print_tree("movimento: setBounds + refit", elapsed_ms([&] {
+				   for (int i = 0; i < count; i++) {
+					   built.setBounds(i, moved[i]);
+				   }
+				   built.refit();
+			   }),
+			   built);
+	print_tree("movimento: update por folha", elapsed_ms([&] {
+				   for (int i = 0; i < count; i++) {
+					   updated.update(i, moved[i]);
+				   }
+			   }),
+			   updated);
+	boxes.swap(moved);
+
+	// Remoção e reinserção de 10% das entidades (o proxy de uma folha reinserida pode mudar).
+	int changed = max(1, count / 10);
+	vector<int> proxies(changed);
+	double removeMs = elapsed_ms([&] {
+		for (int i = 0; i < changed; i++) {
+			built.remove(i);
+		}
+	});
+	double insertMs = elapsed_ms([&] {
+		for (int i = 0; i < changed; i++) {
+			proxies[i] = built.insert(boxes[i], (uint32_t)i);
+		}
+	});
+	printf("  %-34s %10.2f ms + %.2f ms (%d folhas)\n", "remocao + reinsercao de 10%", removeMs, insertMs, changed);
+	print_tree("arvore depois da reinsercao", 0.0, built);
+
+	// Frustum.
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+	vector<uint32_t> found, expected;
+	double bvhMs = 0.0, linearMs = 0.0;
+	size_t results = 0;
+	bool same = true;
+	for (int direction = 0; direction < 8; direction++) {
+		float yaw = glm::radians(45.0f * direction);
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(cos(yaw), 0.2f, sin(yaw)), glm::vec3(0.0f, 1.0f, 0.0f));
+		Frustum frustum = frustum_from_matrix(projection * view);
+		found.clear();
+		expected.clear();
+		bvhMs += elapsed_ms([&] { built.queryFrustum(frustum, [&](uint32_t data) { found.push_back(data); }); });
+		linearMs += elapsed_ms([&] {
+			for (int i = 0; i < count; i++) {
+				if (inside_frustum(frustum, boxes[i])) {
+					expected.push_back((uint32_t)i);
+				}
+			}
+		});
+		sort(found.begin(), found.end());
+		same &= found == expected;
+		results += found.size();
+	}
+	print_query("frustum (8 direcoes)", bvhMs, linearMs, results, same);
+
+	// Raios: acerto mais próximo.
+	const int QUERIES = 1000;
+	vector<Ray> rays(QUERIES);
+	for (Ray& ray : rays) {
+		ray.origin = random_vec3(-side * 0.5f, side * 0.5f);
+		ray.direction = glm::normalize(random_vec3(-1.0f, 1.0f) + glm::vec3(1e-3f));
+	}
+	vector<float> closest(QUERIES), reference(QUERIES);
+	bvhMs = elapsed_ms([&] {
+		for (int q = 0; q < QUERIES; q++) {
+			closest[q] = 1e30f;
+			built.queryRay(rays[q], 1e30f, [&](uint32_t, float entry, float) {
+				closest[q] = entry;
+				return entry;
+			});
+		}
+	});
+	linearMs = elapsed_ms([&] {
+		for (int q = 0; q < QUERIES; q++) {
+			reference[q] = closest_linear(boxes, rays[q], 1e30f);
+		}
+	});
+	print_query("1000 raios (mais proximo)", bvhMs, linearMs, QUERIES, closest == reference);
+
+	// Caixas.
+	vector<Aabb> regions(QUERIES);
+	for (Aabb& region : regions) {
+		glm::vec3 center = random_vec3(-side * 0.5f, side * 0.5f);
+		region = {center - glm::vec3(2.0f), center + glm::vec3(2.0f)};
+	}
+	size_t overlapCount = 0, linearCount = 0;
+	bvhMs = elapsed_ms([&] {
+		for (const Aabb& region : regions) {
+			built.queryOverlap(region, [&](uint32_t) { overlapCount++; });
+		}
+	});
+	linearMs = elapsed_ms([&] {
+		for (const Aabb& region : regions) {
+			for (const Aabb& box : boxes) {
+				linearCount += box.overlaps(region) ? 1 : 0;
+			}
+		}
+	});
+	print_query("1000 caixas de 4 unidades", bvhMs, linearMs, overlapCount, overlapCount == linearCount);
+	printf("\n");
+}
+
+int main(int argc, char** argv) {
+	vector<int> counts;
+	for (int i = 1; i < argc; i++) {
+		counts.push_back(atoi(argv[i]));
+	}
+	if (counts.empty()) {
+		counts = {1000, 100000, 1000000};
+	}
+	for (int count : counts) {
+		run(count);
+	}
+	return 0;
+}
@@ -0,0 +1,197 @@
+// Benchmark do descarte fora do frustum: 100 mil instâncias (padrão) dos OBJs encontrados, espalhadas em um cubo de
+// 200 unidades em volta da câmera, com a projeção da Camera (45 graus, 800x600, planos em 0.1 e 100). Para 8
+// direções da câmera mede, por quadro:
+// - o cálculo dos volumes no mundo (CullBounds::set, como em MeshBatch::enqueue);
+// - o teste contra os planos com um array de estruturas (uma instância por vez, com a GLM) e com o SoA de
+//   cull_bounds nos caminhos escalar, SSE2 e AVX2 (que devem dar os mesmos índices);
+// - instâncias e triângulos (malha completa) descartados.
+// Uso: frustum_bench [instâncias] [diretório...] (padrão: 100000 ../../3D_Models)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "FrustumCulling.h"
+#include "ObjLoader.h"
+
+using namespace std;
+
+struct MeshInfo {
+	glm::vec3 center;
+	glm::vec3 extent;
+	float radius;
+	size_t triangles;
+};
+
+struct Instance {
+	int mesh;
+	glm::mat4 model;
+};
+
+// Volumes no mundo em um array de estruturas, como ficariam guardados em cada objeto.
+struct InstanceBounds {
+	glm::vec3 center;
+	glm::vec3 extent;
+	float radius;
+};
+
+template <typename Step>
+static double best_ms(int runs, Step step) {
+	double best = 1e30;
+	for (int run = 0; run < runs; run++) {
+		auto start = chrono::steady_clock::now();
+		step();
+		best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+// Mesmo teste de cull_bounds, uma instância por vez.
+static size_t cull_aos(const Frustum& frustum, const vector<InstanceBounds>& bounds, uint32_t* visible) {
+	size_t count = 0;
+	for (size_t i = 0; i < bounds.size(); i++) {
+		bool inside = true;
+		for (const glm::vec4& plane : frustum.planes) {
+			glm::vec3 normal(plane);
+			float distance = glm::dot(normal, bounds[i].center) + plane.w;
+			float reach = glm::dot(glm::abs(normal), bounds[i].extent);
+			inside &= distance + min(reach, bounds[i].radius) >= 0.0f;
+		}
+		visible[count] = (uint32_t)i;
+		count += inside ? 1 : 0;
+	}
+	return count;
+}
+
+int main(int argc, char** argv) {
+	int instanceCount = argc > 1 ? atoi(argv[1]) : 100000;
+	vector<string> roots;
+	for (int i = 2; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	// Caixa, esfera e triângulos de cada malha, como em upload_mesh.
+	vector<MeshInfo> meshes;
+	for (const filesystem::path& file : files) {
+		ObjData data;
+		if (!load_obj(file.string(), data) || data.positions.empty()) {
+			continue;
+		}
+		glm::vec3 boundsMin(data.positions[0], data.positions[1], data.positions[2]), boundsMax = boundsMin;
+		for (size_t i = 0; i + 3 <= data.positions.size(); i += 3) {
+			glm::vec3 position(data.positions[i], data.positions[i + 1], data.positions[i + 2]);
+			boundsMin = glm::min(boundsMin, position);
+			boundsMax = glm::max(boundsMax, position);
+		}
+		glm::vec3 extent = (boundsMax - boundsMin) * 0.5f;
+		meshes.push_back({(boundsMin + boundsMax) * 0.5f, extent, glm::length(extent), data.corners.size() / 3});
+	}
+	if (meshes.empty()) {
+		printf("Nenhum OBJ encontrado\n");
+		return 0;
+	}
+
+	// Instâncias em um cubo de 200 unidades centrado na câmera, com rotação e escala aleatórias.
+	vector<Instance> instances;
+	uint32_t seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / 16777216.0f;
+	};
+	for (int i = 0; i < instanceCount; i++) {
+		glm::vec3 position(200.0f * random() - 100.0f, 200.0f * random() - 100.0f, 200.0f * random() - 100.0f);
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+		model = glm::rotate(model, 6.2832f * random(), glm::normalize(glm::vec3(random(), random(), random()) + 0.1f));
+		model = glm::scale(model, glm::vec3(0.25f + random()));
+		instances.push_back({i % (int)meshes.size(), model});
+	}
+	size_t totalTriangles = 0;
+	for (const Instance& instance : instances) {
+		totalTriangles += meshes[instance.mesh].triangles;
+	}
+
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+	printf("%d instancias de %zu malhas, %zu triangulos; teste vetorizado: %s\n", instanceCount, meshes.size(),
+		   totalTriangles, cull_simd_name(cull_simd_supported()));
+	printf("%-8s %9s %9s %9s %9s %9s | %10s %14s\n", "direcao", "ms vol.", "ms AoS", "ms SoA", "ms SSE2", "ms AVX2",
+		   "visiveis", "tris desenhados");
+
+	CullBounds bounds;
+	bounds.resize(instances.size());
+	vector<InstanceBounds> aos(instances.size());
+	vector<uint32_t> visible(instances.size()), reference(instances.size());
+	double totals[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+	size_t culledInstances = 0, culledTriangles = 0;
+	const int DIRECTIONS = 8;
+	for (int direction = 0; direction < DIRECTIONS; direction++) {
+		float yaw = glm::radians(360.0f * direction / DIRECTIONS);
+		glm::vec3 front(cos(yaw), 0.3f * sin(yaw * 2.0f), sin(yaw));
+		glm::mat4 view = glm::lookAt(glm::vec3(0.0f), front, glm::vec3(0.0f, 1.0f, 0.0f));
+		Frustum frustum = frustum_from_matrix(projection * view);
+
+		double times[5];
+		times[0] = best_ms(5, [&] {
+			for (size_t i = 0; i < instances.size(); i++) {
+				const MeshInfo& mesh = meshes[instances[i].mesh];
+				bounds.set(i, instances[i].model, mesh.center, mesh.extent, mesh.radius);
+			}
+		});
+		for (size_t i = 0; i < instances.size(); i++) {
+			aos[i] = {glm::vec3(bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i]),
+					  glm::vec3(bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i]), bounds.radius[i]};
+		}
+
+		size_t count = 0;
+		times[1] = best_ms(5, [&] { count = cull_aos(frustum, aos, reference.data()); });
+		const CullSimd PATHS[] = {CULL_SIMD_SCALAR, CULL_SIMD_SSE2, CULL_SIMD_AVX2};
+		for (int path = 0; path < 3; path++) {
+			size_t pathCount = 0;
+			times[2 + path] =
+				best_ms(5, [&] { pathCount = cull_bounds(frustum, bounds, visible.data(), PATHS[path]); });
+			if (pathCount != count || !equal(visible.begin(), visible.begin() + count, reference.begin())) {
+				printf("%s: indices diferentes do teste de referencia (%zu x %zu)\n", cull_simd_name(PATHS[path]),
+					   pathCount, count);
+			}
+		}
+
+		size_t drawnTriangles = 0;
+		for (size_t v = 0; v < count; v++) {
+			drawnTriangles += meshes[instances[reference[v]].mesh].triangles;
+		}
+		culledInstances += instances.size() - count;
+		culledTriangles += totalTriangles - drawnTriangles;
+		for (int i = 0; i < 5; i++) {
+			totals[i] += times[i];
+		}
+		printf("%5.0f    %9.3f %9.3f %9.3f %9.3f %9.3f | %10zu %14zu\n", 360.0f * direction / DIRECTIONS, times[0],
+			   times[1], times[2], times[3], times[4], count, drawnTriangles);
+	}
+	printf("media    %9.3f %9.3f %9.3f %9.3f %9.3f | descartadas %.1f%% das instancias, %.1f%% dos triangulos\n",
+		   totals[0] / DIRECTIONS, totals[1] / DIRECTIONS, totals[2] / DIRECTIONS, totals[3] / DIRECTIONS,
+		   totals[4] / DIRECTIONS, 100.0 * culledInstances / ((double)instances.size() * DIRECTIONS),
+		   100.0 * culledTriangles / ((double)totalTriangles * DIRECTIONS));
+	printf("(AVX2 %.1fx mais rapido que o array de estruturas; caminhos nao suportados usam o melhor disponivel)\n",
+		   totals[1] / totals[4]);
+	return 0;
+}
@@ -0,0 +1,160 @@
+// Benchmark dos níveis de detalhe:
+// - para cada OBJ, o tempo de generate_mesh_lods e os triângulos e o erro (relativo ao maior lado da caixa envolvente)
+//   de cada nível;
+// - uma cena com centenas de cadeiras e sofás (BlueChair, OrangeChair e couch de 3D_Models/Novos) espalhados entre 2 e
+//   60 unidades da câmera, com a projeção da Camera (45 graus, 800x600): triângulos desenhados por quadro com a escolha
+//   de nível desligada e com vários erros aceitos em pixels (lod_pixel_error), e quantas instâncias usam cada nível.
+// Uso: lod_bench [instâncias] [diretório...] (padrão: 600 ../../3D_Models)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "LodSelection.h"
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+
+using namespace std;
+
+struct SceneMesh {
+	string name;
+	vector<size_t> triangles;  // por nível
+	vector<float> errors;
+	glm::vec3 center;
+	float radius;
+};
+
+struct Instance {
+	int mesh;
+	glm::mat4 model;
+};
+
+int main(int argc, char** argv) {
+	int instanceCount = argc > 1 ? atoi(argv[1]) : 600;
+	vector<string> roots;
+	for (int i = 2; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	const char* SCENE_MODELS[] = {"BlueChair.obj", "OrangeChair.obj", "couch.obj"};
+	vector<SceneMesh> sceneMeshes;
+
+	printf("%-46s %8s %9s  %s\n", "arquivo", "ms", "erro max", "triangulos por nivel");
+	for (const filesystem::path& file : files) {
+		ObjData data;
+		if (!load_obj(file.string(), data)) {
+			printf("%-46s falha ao ler o arquivo\n", file.string().c_str());
+			continue;
+		}
+		MeshData mesh;
+		build_mesh_data(data, mesh);
+		if (mesh.indices.empty()) {
+			continue;
+		}
+		auto start = chrono::steady_clock::now();
+		generate_mesh_lods(mesh);
+		double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+
+		SceneMesh levels;
+		levels.name = file.filename().string();
+		glm::vec3 boundsMin(mesh.boundsMin[0], mesh.boundsMin[1], mesh.boundsMin[2]);
+		glm::vec3 boundsMax(mesh.boundsMax[0], mesh.boundsMax[1], mesh.boundsMax[2]);
+		levels.center = (boundsMin + boundsMax) * 0.5f;
+		levels.radius = glm::length(boundsMax - boundsMin) * 0.5f;
+		float extent = max(boundsMax.x - boundsMin.x, max(boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z));
+		string counts;
+		for (const MeshLod& lod : mesh.lods) {
+			size_t triangles = 0;
+			for (uint32_t s = lod.firstSubmesh; s < lod.firstSubmesh + lod.submeshCount; s++) {
+				triangles += mesh.submeshes[s].indexCount / 3;
+			}
+			levels.triangles.push_back(triangles);
+			levels.errors.push_back(lod.error);
+			counts += (counts.empty() ? "" : " / ") + to_string(triangles);
+		}
+		printf("%-46s %8.1f %8.4f%%  %s\n", file.string().c_str(), ms,
+			   extent > 0.0f ? 100.0f * levels.errors.back() / extent : 0.0f, counts.c_str());
+
+		for (const char* model : SCENE_MODELS) {
+			if (levels.name == model) {
+				sceneMeshes.push_back(levels);
+			}
+		}
+	}
+	if (sceneMeshes.empty()) {
+		printf("Modelos da cena (3D_Models/Novos) nao encontrados\n");
+		return 0;
+	}
+
+	// Instâncias espalhadas à frente da câmera (na origem, olhando para -z), com a escala da cena do escritório.
+	vector<Instance> instances;
+	uint32_t seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / 16777216.0f;
+	};
+	for (int i = 0; i < instanceCount; i++) {
+		float distance = 2.0f + 58.0f * random();
+		float angle = glm::radians(-25.0f + 50.0f * random());
+		glm::vec3 position(distance * sin(angle), -1.0f, -distance * cos(angle));
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+		model = glm::rotate(model, 6.2832f * random(), glm::vec3(0.0f, 1.0f, 0.0f));
+		model = glm::scale(model, glm::vec3(0.5f));
+		instances.push_back({i % (int)sceneMeshes.size(), model});
+	}
+
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+	const float PIXEL_ERRORS[] = {0.0f, 0.5f, 1.0f, 2.0f, 4.0f};
+	printf("\nCena: %d instancias de", instanceCount);
+	for (const SceneMesh& mesh : sceneMeshes) {
+		printf(" %s", mesh.name.c_str());
+	}
+	printf(" entre 2 e 60 unidades da camera\n");
+	printf("%-10s %12s %9s  %s\n", "erro (px)", "triangulos", "reducao", "instancias por nivel");
+	size_t fullTriangles = 0;
+	for (float pixelError : PIXEL_ERRORS) {
+		LodSelection selection = lod_selection(projection, 600.0f, glm::vec3(0.0f), pixelError);
+		size_t triangles = 0;
+		vector<int> perLevel;
+		for (const Instance& instance : instances) {
+			const SceneMesh& mesh = sceneMeshes[instance.mesh];
+			int level = select_lod(selection, instance.model, 1.0f, mesh.center, mesh.radius, mesh.errors.data(),
+								   (int)mesh.errors.size());
+			triangles += mesh.triangles[level];
+			if ((int)perLevel.size() <= level) {
+				perLevel.resize(level + 1, 0);
+			}
+			perLevel[level]++;
+		}
+		if (pixelError == 0.0f) {
+			fullTriangles = triangles;
+		}
+		string levels;
+		for (int count : perLevel) {
+			levels += (levels.empty() ? "" : " / ") + to_string(count);
+		}
+		printf("%-10.1f %12zu %8.1fx  %s\n", pixelError, triangles, (double)fullTriangles / triangles, levels.c_str());
+	}
+	return 0;
+}
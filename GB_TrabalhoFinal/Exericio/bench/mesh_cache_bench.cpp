@@ -0,0 +1,88 @@
+// Benchmark do cache binário de malhas: compara a leitura do OBJ em texto (parse + indexação) com a abertura do
+// arquivo .gbmesh mapeado. A leitura dos blocos mapeados simula a cópia feita pelo glBufferData.
+// Uso: mesh_cache_bench [diretório...] (padrão: ../../3D_Models/Novos)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "MeshCache.h"
+#include "ObjLoader.h"
+
+using namespace std;
+
+// Percorre os bytes como o driver faria ao copiar o bloco para a GPU.
+static uint64_t touch(const void* data, uint64_t size) {
+	const uint64_t* words = (const uint64_t*)data;
+	uint64_t sum = 0;
+	for (uint64_t i = 0; i < size / 8; i++) {
+		sum += words[i];
+	}
+	return sum;
+}
+
+int main(int argc, char** argv) {
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models/Novos");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	printf("%-44s %12s %12s %10s %9s\n", "arquivo", "texto ms", "cache ms", "cache KB", "ganho");
+	double totalText = 0.0, totalCache = 0.0;
+	uint64_t checksum = 0;
+	for (const filesystem::path& file : files) {
+		string path = file.string();
+
+		// Garante que o cache existe e está atualizado.
+		MeshCacheFile warmup;
+		if (!load_mesh_cached(path, warmup)) {
+			printf("%-44s falha ao gerar o cache\n", path.c_str());
+			continue;
+		}
+		uint64_t cacheBytes = warmup.getHeader().vertexBytes + warmup.getHeader().indexBytes;
+		warmup.close();
+
+		double textTime = 1e30, cacheTime = 1e30;
+		for (int run = 0; run < 5; run++) {
+			auto start = chrono::steady_clock::now();
+			ObjData data;
+			MeshData mesh;
+			load_obj(path, data);
+			build_mesh_data(data, mesh);
+			checksum += touch(mesh.vertices.data(), mesh.vertices.size());
+			auto middle = chrono::steady_clock::now();
+
+			MeshCacheFile cache;
+			load_mesh_cached(path, cache);
+			checksum += touch(cache.getVertexData(), cache.getHeader().vertexBytes);
+			checksum += touch(cache.getIndexData(), cache.getHeader().indexBytes);
+			auto stop = chrono::steady_clock::now();
+
+			textTime = min(textTime, chrono::duration<double, milli>(middle - start).count());
+			cacheTime = min(cacheTime, chrono::duration<double, milli>(stop - middle).count());
+		}
+		totalText += textTime;
+		totalCache += cacheTime;
+		printf("%-44s %12.2f %12.3f %10.1f %8.1fx\n", path.c_str(), textTime, cacheTime, cacheBytes / 1024.0,
+			   textTime / cacheTime);
+	}
+	printf("%-44s %12.2f %12.3f %10s %8.1fx\n", "total", totalText, totalCache, "", totalText / totalCache);
+	printf("(checksum %llu)\n", (unsigned long long)checksum);
+	return 0;
+}
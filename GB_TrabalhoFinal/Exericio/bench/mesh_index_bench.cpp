@@ -0,0 +1,62 @@
+// Benchmark da geometria indexada: compara a memória do VBO expandido (11 floats por canto de face) com VBO + EBO
+// após a unificação das trincas (v, vt, vn). Uso: mesh_index_bench [diretório...] (padrão: ../../3D_Models/Novos)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "ObjLoader.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models/Novos");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	printf("%-44s %9s %9s %9s %12s %12s %7s %9s\n", "arquivo", "tris", "cantos", "vertices", "expandido KB",
+		   "VBO+EBO KB", "razao", "ms index");
+	size_t totalBefore = 0, totalAfter = 0;
+	for (const filesystem::path& file : files) {
+		ObjData data;
+		load_obj(file.string(), data);
+
+		vector<float> vertices;
+		vector<uint32_t> indices;
+		double best = 1e30;
+		for (int run = 0; run < 5; run++) {
+			auto start = chrono::steady_clock::now();
+			build_indexed_vertex_buffer(data, glm::vec3(1.0f), vertices, indices);
+			auto stop = chrono::steady_clock::now();
+			best = min(best, chrono::duration<double>(stop - start).count());
+		}
+
+		size_t before = data.corners.size() * 11 * sizeof(float);
+		size_t after = vertices.size() * sizeof(float) + indices.size() * sizeof(uint32_t);
+		totalBefore += before;
+		totalAfter += after;
+		printf("%-44s %9zu %9zu %9zu %12.1f %12.1f %6.2fx %9.2f\n", file.string().c_str(), data.corners.size() / 3,
+			   data.corners.size(), vertices.size() / 11, before / 1024.0, after / 1024.0, (double)before / after,
+			   best * 1000.0);
+	}
+	printf("%-44s %9s %9s %9s %12.1f %12.1f %6.2fx\n", "total", "", "", "", totalBefore / 1024.0, totalAfter / 1024.0,
+		   (double)totalBefore / max<size_t>(totalAfter, 1));
+	return 0;
+}
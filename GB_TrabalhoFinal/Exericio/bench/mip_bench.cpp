@@ -0,0 +1,173 @@
+// Benchmark do gerador de mipmaps: mede cada filtro (caixa linear, caixa sRGB e Kaiser sRGB) com o código escalar,
+// SSE2 e AVX2, em uma thread e com o pool, e compara as cadeias geradas com as de referência (imagens douradas):
+// - caixa linear: build_rgba8_mip_chain, bit a bit (inteiros);
+// - demais filtros: a versão escalar do mesmo filtro, com até 1 de diferença por byte (em ponto flutuante, o compilador
+//   pode fundir multiplicações e somas em FMA, ex.: com -march=native, e mudar o arredondamento de alguns bytes).
+// Colunas: tempo em uma thread e com o pool, ganho sobre a caixa linear original (com o pool) e, em uma thread, sobre
+// o código escalar do mesmo filtro (o ganho dos caminhos vetorizados nos filtros sRGB).
+// Retorna 1 se alguma cadeia diferir. Além das imagens, usa uma imagem sintética 4096x4096 (ruído + gradiente).
+// Uso: mip_bench [diretório...] (padrão: ../models_archives)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "MipGenerator.h"
+#include "TextureFile.h"
+#include "ThreadPool.h"
+
+// STB_IMAGE.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+using namespace std;
+
+struct Image {
+	string name;
+	uint32_t width, height;
+	vector<uint8_t> pixels;	 // RGBA8
+};
+
+struct Variant {
+	const char* name;
+	MipFilter filter;
+	bool srgb;
+};
+
+// Maior diferença entre dois bytes das cadeias (níveis 1 em diante).
+static int max_difference(const TextureData& a, const TextureData& b) {
+	if (a.data.size() != b.data.size()) {
+		return 256;
+	}
+	int difference = 0;
+	for (size_t l = 1; l < a.levels.size(); l++) {
+		const uint8_t* pa = &a.data[a.levels[l].offset];
+		const uint8_t* pb = &b.data[b.levels[l].offset];
+		for (uint64_t i = 0; i < a.levels[l].size; i++) {
+			difference = max(difference, abs((int)pa[i] - (int)pb[i]));
+		}
+	}
+	return difference;
+}
+
+template <typename Build>
+static double best_ms(Build build) {
+	double best = 1e30;
+	for (int run = 0; run < 3; run++) {
+		auto start = chrono::steady_clock::now();
+		build();
+		best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+int main(int argc, char** argv) {
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../models_archives");
+	}
+
+	vector<Image> images;
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			string extension = entry.path().extension().string();
+			transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+			if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg")) {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+	for (const filesystem::path& file : files) {
+		int width, height, channels;
+		unsigned char* pixels = stbi_load(file.string().c_str(), &width, &height, &channels, 4);
+		if (!pixels) {
+			printf("%s: falha ao ler a imagem\n", file.string().c_str());
+			continue;
+		}
+		images.push_back({file.filename().string(), (uint32_t)width, (uint32_t)height,
+						  vector<uint8_t>(pixels, pixels + (size_t)width * height * 4)});
+		stbi_image_free(pixels);
+	}
+
+	Image synthetic = {"sintetica 4096x4096", 4096, 4096, vector<uint8_t>((size_t)4096 * 4096 * 4)};
+	uint32_t seed = 12345;
+	for (size_t i = 0; i < synthetic.pixels.size(); i++) {
+		seed = seed * 1664525u + 1013904223u;
+		size_t x = (i / 4) % 4096;
+		synthetic.pixels[i] = (uint8_t)((x / 16 + (seed >> 27)) & 0xFF);
+	}
+	images.push_back(synthetic);
+
+	ThreadPool pool;
+	MipSimd supported = mip_simd_supported();
+	vector<MipSimd> levels = {MIP_SIMD_SCALAR};
+	if (supported >= MIP_SIMD_SSE2) {
+		levels.push_back(MIP_SIMD_SSE2);
+	}
+	if (supported >= MIP_SIMD_AVX2) {
+		levels.push_back(MIP_SIMD_AVX2);
+	}
+	const Variant VARIANTS[] = {{"caixa linear", MIP_FILTER_BOX, false},
+								{"caixa sRGB", MIP_FILTER_BOX, true},
+								{"Kaiser sRGB", MIP_FILTER_KAISER, true}};
+
+	bool allEqual = true;
+	printf("%-24s %-13s %-8s %10s %10s %8s %10s  %s\n", "imagem", "filtro", "codigo", "1 thread", "pool", "ganho",
+		   "vs escalar", "comparacao");
+	for (const Image& image : images) {
+		TextureData reference;
+		double referenceMs = best_ms([&] {
+			build_rgba8_mip_chain(image.pixels.data(), image.width, image.height, reference);
+		});
+		printf("%-24s %-13s %-8s %10.1f %10s %8s %10s  %s\n", image.name.c_str(), "caixa linear", "original",
+			   referenceMs, "-", "1.0x", "-", "referencia");
+
+		for (const Variant& variant : VARIANTS) {
+			TextureData golden = reference;
+			int tolerance = variant.filter == MIP_FILTER_BOX && !variant.srgb ? 0 : 1;
+			double scalarMs = 0.0;
+			for (MipSimd simd : levels) {
+				MipOptions options;
+				options.filter = variant.filter;
+				options.srgb = variant.srgb;
+				options.simd = simd;
+				TextureData chain;
+				auto build = [&] {
+					build_mip_chain(image.pixels.data(), image.width, image.height, 4, chain, options);
+				};
+				double singleMs = best_ms(build);
+				options.pool = &pool;
+				double poolMs = best_ms(build);
+
+				// A referência dos filtros novos é a própria versão escalar.
+				if (simd == MIP_SIMD_SCALAR) {
+					scalarMs = singleMs;
+					if (variant.filter != MIP_FILTER_BOX || variant.srgb) {
+						golden = chain;
+					}
+				}
+				int difference = max_difference(golden, chain);
+				allEqual = allEqual && difference <= tolerance;
+				string comparison = difference == 0			? "identica"
+									: difference <= tolerance ? "ate 1 (arredondamento)"
+															  : "DIFERENTE (ate " + to_string(difference) + ")";
+				printf("%-24s %-13s %-8s %10.1f %10.1f %7.1fx %9.1fx  %s\n", image.name.c_str(), variant.name,
+					   mip_simd_name(simd), singleMs, poolMs, referenceMs / poolMs, scalarMs / singleMs,
+					   comparison.c_str());
+			}
+		}
+	}
+	printf("%s (%d threads no pool)\n", allEqual ? "Todas as cadeias conferem com a referencia"
+											   : "ERRO: cadeias diferentes da referencia",
+		   pool.size());
+	return allEqual ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+// Benchmark de escalabilidade da leitura paralela de OBJ: lê cada arquivo com 1..N threads e confere que o resultado
+// é idêntico bit a bit ao da leitura serial. Uso: obj_parallel_bench [max_threads] [arquivo.obj...]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MappedFile.h"
+#include "ObjLoader.h"
+
+using namespace std;
+
+template <typename T>
+static bool same_bytes(const vector<T>& a, const vector<T>& b) {
+	return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+}
+
+static bool same_data(const ObjData& a, const ObjData& b) {
+	return same_bytes(a.positions, b.positions) && same_bytes(a.texCoords, b.texCoords) &&
+		   same_bytes(a.normals, b.normals) && same_bytes(a.corners, b.corners) && a.mtllib == b.mtllib &&
+		   a.materialNames == b.materialNames && same_bytes(a.materialRanges, b.materialRanges);
+}
+
+int main(int argc, char** argv) {
+	int maxThreads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+	maxThreads = max(1, maxThreads);
+
+	vector<string> files;
+	for (int i = 2; i < argc; i++) {
+		files.push_back(argv[i]);
+	}
+	if (files.empty()) {
+		files.push_back("../../3D_Models/Novos/couch.obj");
+		files.push_back("../../3D_Models/Novos/desk.obj");
+	}
+
+	for (const string& filepath : files) {
+		MappedFile file;
+		if (!file.open(filepath)) {
+			printf("Nao foi possivel abrir %s\n", filepath.c_str());
+			continue;
+		}
+		const char* begin = file.data();
+		const char* end = begin + file.size();
+		double megabytes = (double)file.size() / (1024.0 * 1024.0);
+
+		ObjData serial;
+		parse_obj(begin, end, serial);
+
+		printf("%s (%.1f MB, %zu triangulos)\n", filepath.c_str(), megabytes, serial.corners.size() / 3);
+		printf("%8s %10s %10s %9s %s\n", "threads", "ms", "MB/s", "speedup", "saida");
+		double baseline = 0.0;
+		for (int threads = 1; threads <= maxThreads; threads++) {
+			ThreadPool pool(threads);
+			ObjData data;
+			double best = 1e30;
+			for (int run = 0; run < 10; run++) {
+				data.clear();
+				auto start = chrono::steady_clock::now();
+				if (threads == 1) {
+					parse_obj(begin, end, data);
+				} else {
+					parse_obj_parallel(begin, end, data, pool);
+				}
+				auto stop = chrono::steady_clock::now();
+				best = min(best, chrono::duration<double>(stop - start).count());
+			}
+			if (threads == 1) {
+				baseline = best;
+			}
+			printf("%8d %10.2f %10.1f %8.2fx %s\n", threads, best * 1000.0, megabytes / best, baseline / best,
+				   same_data(serial, data) ? "identica" : "DIFERENTE");
+		}
+		printf("\n");
+	}
+	return 0;
+}
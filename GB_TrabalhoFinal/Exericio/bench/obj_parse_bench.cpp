@@ -0,0 +1,151 @@
+// Benchmark do carregamento de OBJ: compara o loader antigo (getline + istringstream por linha) com o loader mapeado
+// em memória (ObjLoader). Uso: obj_parse_bench [diretório...] (padrão: ../../3D_Models)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ObjLoader.h"
+
+using namespace std;
+
+// Cópia do laço de leitura original de load_simple_obj (sem a parte OpenGL), usada como referência.
+static void legacy_load_simple_obj(const string& filepath, vector<float>& vbuffer, glm::vec3 color) {
+	vector<glm::vec3> vertices;
+	vector<unsigned int> indices;
+	vector<glm::vec2> texCoords;
+	vector<glm::vec3> normals;
+
+	ifstream inputFile;
+	inputFile.open(filepath.c_str());
+	if (inputFile.is_open()) {
+		char line[100];
+		string sline;
+
+		while (!inputFile.eof()) {
+			inputFile.getline(line, 100);
+			sline = line;
+
+			string word;
+			istringstream ssline(line);
+			ssline >> word;
+
+			if (word == "v") {
+				glm::vec3 v;
+				ssline >> v.x >> v.y >> v.z;
+				vertices.push_back(v);
+			}
+			if (word == "vt") {
+				glm::vec2 vt;
+				ssline >> vt.s >> vt.t;
+				texCoords.push_back(vt);
+			}
+			if (word == "vn") {
+				glm::vec3 vn;
+				ssline >> vn.x >> vn.y >> vn.z;
+				normals.push_back(vn);
+			}
+			if (word == "f") {
+				string tokens[3];
+				ssline >> tokens[0] >> tokens[1] >> tokens[2];
+
+				for (int i = 0; i < 3; i++) {
+					int pos = tokens[i].find("/");
+					string token = tokens[i].substr(0, pos);
+					int index = atoi(token.c_str()) - 1;
+					indices.push_back(index);
+
+					vbuffer.push_back(vertices[index].x);
+					vbuffer.push_back(vertices[index].y);
+					vbuffer.push_back(vertices[index].z);
+					vbuffer.push_back(color.r);
+					vbuffer.push_back(color.g);
+					vbuffer.push_back(color.b);
+
+					tokens[i] = tokens[i].substr(pos + 1);
+					pos = tokens[i].find("/");
+					token = tokens[i].substr(0, pos);
+					index = atoi(token.c_str()) - 1;
+
+					vbuffer.push_back(texCoords[index].s);
+					vbuffer.push_back(texCoords[index].t);
+
+					tokens[i] = tokens[i].substr(pos + 1);
+					index = atoi(tokens[i].c_str()) - 1;
+
+					vbuffer.push_back(normals[index].x);
+					vbuffer.push_back(normals[index].y);
+					vbuffer.push_back(normals[index].z);
+				}
+			}
+		}
+	}
+}
+
+static void mapped_load(const string& filepath, vector<float>& vbuffer, glm::vec3 color) {
+	ObjData data;
+	load_obj(filepath, data);
+	build_vertex_buffer(data, color, vbuffer);
+}
+
+// Melhor tempo (em segundos) entre algumas execuções.
+template <typename Loader>
+static double best_time(Loader loader, const string& filepath, vector<float>& vbuffer) {
+	double best = 1e30;
+	for (int run = 0; run < 5; run++) {
+		vbuffer.clear();
+		auto start = chrono::steady_clock::now();
+		loader(filepath, vbuffer, glm::vec3(1.0f, 1.0f, 0.0f));
+		auto stop = chrono::steady_clock::now();
+		best = min(best, chrono::duration<double>(stop - start).count());
+	}
+	return best;
+}
+
+int main(int argc, char** argv) {
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	printf("%-48s %10s %12s %12s %9s %s\n", "arquivo", "KB", "antigo MB/s", "mmap MB/s", "ganho", "saida");
+	double totalBytes = 0.0, totalLegacy = 0.0, totalMapped = 0.0;
+	for (const filesystem::path& file : files) {
+		double megabytes = (double)filesystem::file_size(file) / (1024.0 * 1024.0);
+		vector<float> legacy, mapped;
+		double legacyTime = best_time(legacy_load_simple_obj, file.string(), legacy);
+		double mappedTime = best_time(mapped_load, file.string(), mapped);
+		bool same = legacy.size() == mapped.size();
+		for (size_t i = 0; same && i < legacy.size(); i++) {
+			same = fabs(legacy[i] - mapped[i]) <= 1e-6f * max(1.0f, fabs(legacy[i]));
+		}
+
+		printf("%-48s %10.1f %12.1f %12.1f %8.1fx %s\n", file.string().c_str(), megabytes * 1024.0,
+			   megabytes / legacyTime, megabytes / mappedTime, legacyTime / mappedTime, same ? "igual" : "DIFERENTE");
+		totalBytes += megabytes;
+		totalLegacy += legacyTime;
+		totalMapped += mappedTime;
+	}
+	printf("%-48s %10.1f %12.1f %12.1f %8.1fx\n", "total", totalBytes * 1024.0, totalBytes / totalLegacy,
+		   totalBytes / totalMapped, totalLegacy / totalMapped);
+	return 0;
+}
@@ -0,0 +1,243 @@
+// Benchmark da seleção com o mouse (Origem.cpp: pick_scene_object): instâncias dos OBJs encontrados até somar 1 milhão
+// de triângulos (padrão), espalhadas com rotação e escala aleatórias em uma caixa à frente da câmera. Mede:
+// - a montagem da BVH de triângulos de cada malha (TriangleBvh) e a memória ocupada;
+// - 1000 seleções em pontos aleatórios da tela, com a projeção da Camera (45 graus, 800x600, planos em 0.1 e 100):
+//   semirreta desfeita a partir do ponto, BVH das instâncias (DynamicBvh) e BVH de triângulos de cada instância
+//   atravessada, nos caminhos escalar e SSE2; tempo médio e o pior caso por seleção;
+// - a força bruta (todos os triângulos de todas as instâncias), que deve escolher as mesmas instâncias nas mesmas
+//   distâncias.
+// Uso: pick_bench [triângulos] [diretório...] (padrão: 1000000 ../../3D_Models)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "DynamicBvh.h"
+#include "ObjLoader.h"
+#include "TriangleBvh.h"
+
+using namespace std;
+
+struct PickMesh {
+	vector<float> positions;
+	vector<uint32_t> indices;
+	TriangleBvh triangles;
+	glm::vec3 center;
+	glm::vec3 extent;
+};
+
+struct Instance {
+	int mesh;
+	glm::mat4 model;
+};
+
+struct Pick {
+	int instance = -1;
+	float distance = FLT_MAX;
+};
+
+template <typename Step>
+static double elapsed_ms(Step step) {
+	auto start = chrono::steady_clock::now();
+	step();
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Mesma seleção de pick_scene_object, com as mesmas funções (unproject_ray e intersect_instance, que inverte a matriz
+// modelo a cada teste): BVH das instâncias, das mais próximas para as mais distantes, e os triângulos de cada
+// instância atravessada.
+static Pick pick(const DynamicBvh& bvh, const vector<Instance>& instances, const vector<PickMesh>& meshes,
+				 const Ray& ray, TriangleSimd simd) {
+	Pick result;
+	bvh.queryRay(ray, FLT_MAX, [&](uint32_t entity, float, float maxDistance) {
+		const Instance& instance = instances[entity];
+		uint32_t triangle;
+		if (intersect_instance(meshes[instance.mesh].triangles, instance.model, ray, maxDistance, triangle, simd)) {
+			result.instance = (int)entity;
+			result.distance = maxDistance;
+		}
+		return maxDistance;
+	});
+	return result;
+}
+
+// Möller e Trumbore em todos os triângulos de todas as instâncias, sem hierarquia.
+static Pick pick_brute_force(const vector<Instance>& instances, const vector<PickMesh>& meshes, const Ray& ray) {
+	Pick result;
+	for (size_t i = 0; i < instances.size(); i++) {
+		const PickMesh& mesh = meshes[instances[i].mesh];
+		Ray local = transform_ray(glm::inverse(instances[i].model), ray);
+		for (size_t t = 0; t + 3 <= mesh.indices.size(); t += 3) {
+			glm::vec3 v0 = glm::make_vec3(&mesh.positions[3 * mesh.indices[t]]);
+			glm::vec3 edge1 = glm::make_vec3(&mesh.positions[3 * mesh.indices[t + 1]]) - v0;
+			glm::vec3 edge2 = glm::make_vec3(&mesh.positions[3 * mesh.indices[t + 2]]) - v0;
+			glm::vec3 p = glm::cross(local.direction, edge2);
+			float determinant = glm::dot(edge1, p);
+			if (determinant == 0.0f) {
+				continue;
+			}
+			glm::vec3 offset = local.origin - v0;
+			float u = glm::dot(offset, p) / determinant;
+			glm::vec3 q = glm::cross(offset, edge1);
+			float v = glm::dot(local.direction, q) / determinant;
+			float distance = glm::dot(edge2, q) / determinant;
+			if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance >= 0.0f && distance < result.distance) {
+				result.instance = (int)i;
+				result.distance = distance;
+			}
+		}
+	}
+	return result;
+}
+
+// Mesma instância e distância (a ordem das contas difere da força bruta nos últimos bits).
+static bool same_pick(const Pick& a, const Pick& b) {
+	if (a.instance != b.instance) {
+		// Dois triângulos à mesma distância em instâncias diferentes (ex.: faces coincidentes) valem os dois.
+		return a.instance >= 0 && b.instance >= 0 && fabs(a.distance - b.distance) <= 1e-4f * b.distance;
+	}
+	return a.instance < 0 || fabs(a.distance - b.distance) <= 1e-4f * b.distance;
+}
+
+int main(int argc, char** argv) {
+	size_t targetTriangles = argc > 1 ? (size_t)atoll(argv[1]) : 1000000;
+	vector<string> roots;
+	for (int i = 2; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	// Malhas e as suas BVHs de triângulos.
+	vector<PickMesh> meshes;
+	double buildMs = 0.0;
+	size_t meshTriangles = 0, bvhBytes = 0;
+	for (const filesystem::path& file : files) {
+		ObjData data;
+		if (!load_obj(file.string(), data) || data.corners.size() < 3) {
+			continue;
+		}
+		meshes.emplace_back();
+		PickMesh& mesh = meshes.back();
+		mesh.positions = data.positions;
+		for (const ObjIndex& corner : data.corners) {
+			mesh.indices.push_back((uint32_t)corner.v);
+		}
+		Aabb box;
+		for (size_t i = 0; i + 3 <= mesh.positions.size(); i += 3) {
+			box.extend(glm::make_vec3(&mesh.positions[i]));
+		}
+		mesh.center = box.center();
+		mesh.extent = (box.boundsMax - box.boundsMin) * 0.5f;
+		buildMs += elapsed_ms([&] {
+			mesh.triangles.build((const uint8_t*)mesh.positions.data(), 3 * sizeof(float), mesh.indices.data(),
+								 mesh.indices.size() / 3);
+		});
+		meshTriangles += mesh.triangles.getTriangleCount();
+		bvhBytes += mesh.triangles.getMemoryBytes();
+	}
+	if (meshes.empty()) {
+		printf("Nenhum OBJ encontrado\n");
+		return 0;
+	}
+	printf("%zu malhas, %zu triangulos: BVHs de triangulos em %.1f ms, %.1f MB (%.1f bytes por triangulo)\n",
+		   meshes.size(), meshTriangles, buildMs, bvhBytes / 1048576.0, (double)bvhBytes / meshTriangles);
+
+	// Instâncias com o tamanho normalizado (maior meia-diagonal entre 1 e 3 unidades) em uma caixa de 24 x 18 x 30
+	// unidades à frente da câmera, até somar targetTriangles.
+	vector<Instance> instances;
+	vector<Aabb> boxes;
+	uint32_t seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / 16777216.0f;
+	};
+	size_t totalTriangles = 0;
+	while (totalTriangles < targetTriangles) {
+		int m = (int)(instances.size() % meshes.size());
+		const PickMesh& mesh = meshes[m];
+		float size = glm::max(mesh.extent.x, glm::max(mesh.extent.y, mesh.extent.z));
+		glm::vec3 position(24.0f * random() - 12.0f, 18.0f * random() - 9.0f, -30.0f * random() - 5.0f);
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+		model = glm::rotate(model, 6.2832f * random(), glm::normalize(glm::vec3(random(), random(), random()) + 0.1f));
+		model = glm::scale(model, glm::vec3((1.0f + 2.0f * random()) / size));
+		model = glm::translate(model, -mesh.center);
+		instances.push_back({m, model});
+		boxes.push_back(transform_aabb(model, mesh.center, mesh.extent));
+		totalTriangles += mesh.triangles.getTriangleCount();
+	}
+	DynamicBvh bvh;
+	double sceneMs = elapsed_ms([&] { bvh.build(boxes); });
+	printf("%zu instancias, %zu triangulos; BVH das instancias em %.2f ms; teste vetorizado: %s\n", instances.size(),
+		   totalTriangles, sceneMs, triangle_simd_name(triangle_simd_supported()));
+
+	// Pontos da tela e as semirretas da câmera na origem, olhando para -z.
+	const int PICKS = 1000;
+	glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 0.1f, 100.0f);
+	glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+	vector<glm::vec2> points(PICKS);
+	for (glm::vec2& point : points) {
+		point = glm::vec2(2.0f * random() - 1.0f, 2.0f * random() - 1.0f);
+	}
+
+	const TriangleSimd PATHS[] = {TRIANGLE_SIMD_SCALAR, TRIANGLE_SIMD_SSE2};
+	vector<Pick> results[2];
+	for (int path = 0; path < 2; path++) {
+		results[path].resize(PICKS);
+		double total = 0.0, worst = 0.0;
+		int hits = 0;
+		for (int run = 0; run < 3; run++) {
+			total = 0.0;
+			worst = 0.0;
+			for (int p = 0; p < PICKS; p++) {
+				double ms = elapsed_ms([&] {
+					Ray ray = unproject_ray(points[p], projection * view);
+					results[path][p] = pick(bvh, instances, meshes, ray, PATHS[path]);
+				});
+				total += ms;
+				worst = max(worst, ms);
+			}
+		}
+		for (const Pick& result : results[path]) {
+			hits += result.instance >= 0 ? 1 : 0;
+		}
+		printf("  %-8s %8.4f ms por selecao (pior %.4f ms), %d acertos em %d\n", triangle_simd_name(PATHS[path]),
+			   total / PICKS, worst, hits, PICKS);
+	}
+
+	// Força bruta em parte dos pontos (cada um percorre todos os triângulos).
+	const int CHECKED = 100;
+	int differences = 0;
+	double bruteMs = elapsed_ms([&] {
+		for (int p = 0; p < CHECKED; p++) {
+			Pick reference = pick_brute_force(instances, meshes, unproject_ray(points[p], projection * view));
+			for (int path = 0; path < 2; path++) {
+				differences += same_pick(results[path][p], reference) ? 0 : 1;
+			}
+		}
+	});
+	printf("  forca bruta %.3f ms por selecao; %d de %d selecoes diferentes\n", bruteMs / CHECKED, differences,
+		   2 * CHECKED);
+	return 0;
+}
@@ -0,0 +1,156 @@
+// Benchmark da fila de desenhos (RenderQueue.h) em cenas sintéticas com a estrutura da aplicação: lotes (OBJ, textura)
+// adicionados na ordem do map de Origem.cpp (por OBJ e depois por textura), cada lote com 1 a 3 níveis de detalhe em
+// uso (um grupo de instâncias por nível) e 1 a 8 faixas de material por nível. Mede:
+// - a ordenação das chaves de 64 bits: radix_sort_keys e std::stable_sort (que devem dar a mesma ordem);
+// - os vínculos de estado por quadro (programa, VAO, buffer, unidade ativa, textura e atributos de instância, com a
+//   mesma contagem da GlStateCache) da fila fora de ordem, desvinculando cada lote como antes da fila, e da fila
+//   ordenada; texturas em arrays (poucas texturas compartilhadas por muitos OBJs) e uma textura por lote.
+// Uso: render_queue_bench [lotes...] (padrão: 16 128 1024)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "RenderQueue.h"
+
+using namespace std;
+
+static uint32_t seed = 12345;
+
+static uint32_t random_int(uint32_t count) {
+	seed = seed * 1664525u + 1013904223u;
+	return (seed >> 8) % count;
+}
+
+// Desenho sintético: o estado que o item vincula em MeshBatch::drawItem.
+struct SyntheticItem {
+	uint32_t batch;
+	uint32_t vertexArray;
+	uint32_t texture;
+	uint32_t group;  // grupo de instâncias (origem dos atributos de instância)
+};
+
+// Contagem de vínculos enviados com uma cópia do estado, como a GlStateCache (sem a OpenGL).
+struct BindCounter {
+	uint32_t vertexArray = ~0u, arrayBuffer = ~0u, activeUnit = ~0u, texture = ~0u, source = ~0u, program = ~0u;
+	size_t binds = 0;
+
+	void bind(uint32_t& current, uint32_t value) {
+		binds += current != value ? 1 : 0;
+		current = value;
+	}
+
+	void draw(const SyntheticItem& item) {
+		bind(program, 1);
+		if (vertexArray != item.vertexArray) {
+			source = ~0u;
+		}
+		bind(vertexArray, item.vertexArray);
+		if (texture != item.texture) {
+			bind(activeUnit, 1);
+			bind(texture, item.texture);
+		}
+		if (source != item.group) {
+			bind(source, item.group);
+			bind(arrayBuffer, 1000000 + item.batch);
+		}
+	}
+
+	void unbind() {
+		bind(texture, 0);
+		bind(activeUnit, 0);
+		bind(arrayBuffer, 0);
+		bind(vertexArray, 0);
+	}
+};
+
+template <typename Step>
+static double best_ms(int runs, Step step) {
+	double best = 1e30;
+	for (int run = 0; run < runs; run++) {
+		auto start = chrono::steady_clock::now();
+		step();
+		best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+static bool run(size_t batchCount, size_t textureCount) {
+	// Lotes na ordem do map (OBJ, textura): cada OBJ aparece com algumas texturas.
+	vector<SyntheticItem> items;
+	vector<RenderKey> keys;
+	size_t meshCount = max<size_t>(1, batchCount / min<size_t>(textureCount, 4));
+	uint32_t group = 0;
+	for (size_t batch = 0; batch < batchCount; batch++) {
+		uint32_t vertexArray = 1 + (uint32_t)(batch % meshCount);
+		uint32_t texture = 1 + random_int((uint32_t)textureCount);
+		int levels = 1 + (int)random_int(3), ranges = 1 + (int)random_int(8);
+		for (int level = 0; level < levels; level++, group++) {
+			float depth = 1.0f + (float)random_int(100000) * 0.001f;
+			for (int range = 0; range < ranges; range++) {
+				keys.push_back({render_sort_key(1, texture, vertexArray, depth, (uint32_t)random_int(64)),
+								(uint32_t)items.size()});
+				items.push_back({(uint32_t)batch, vertexArray, texture, group});
+			}
+		}
+	}
+
+	// Ordenação: radix e std::stable_sort, com as mesmas chaves.
+	vector<RenderKey> radixKeys, scratch, stdKeys;
+	double radixMs = best_ms(20, [&] {
+		radixKeys = keys;
+		radix_sort_keys(radixKeys, scratch);
+	});
+	double stdMs = best_ms(20, [&] {
+		stdKeys = keys;
+		stable_sort(stdKeys.begin(), stdKeys.end(),
+					[](const RenderKey& a, const RenderKey& b) { return a.key < b.key; });
+	});
+	double copyMs = best_ms(20, [&] { stdKeys.assign(keys.begin(), keys.end()); });
+	stable_sort(stdKeys.begin(), stdKeys.end(), [](const RenderKey& a, const RenderKey& b) { return a.key < b.key; });
+	bool same = true;
+	for (size_t i = 0; i < keys.size(); i++) {
+		same &= radixKeys[i].item == stdKeys[i].item;
+	}
+
+	// Vínculos: fora de ordem, desvinculando cada lote, e na ordem das chaves.
+	BindCounter before, after;
+	for (size_t i = 0; i < items.size(); i++) {
+		before.draw(items[i]);
+		if (i + 1 == items.size() || items[i + 1].batch != items[i].batch) {
+			before.unbind();
+		}
+	}
+	for (const RenderKey& key : radixKeys) {
+		after.draw(items[key.item]);
+	}
+	after.bind(after.vertexArray, 0);
+	after.bind(after.activeUnit, 0);
+
+	double draws = (double)items.size();
+	printf("%6zu lotes, %6zu texturas, %6zu desenhos: radix_sort_keys %7.3f ms, std::stable_sort %7.3f ms%s\n",
+		   batchCount, textureCount, items.size(), radixMs - copyMs, stdMs - copyMs, same ? "" : " ORDEM DIFERENTE");
+	printf("    vinculos por quadro: lote por lote %zu (%.2f por desenho), fila ordenada %zu (%.2f por desenho)\n",
+		   before.binds, before.binds / draws, after.binds, after.binds / draws);
+	return same;
+}
+
+int main(int argc, char** argv) {
+	vector<size_t> batchCounts;
+	for (int i = 1; i < argc; i++) {
+		batchCounts.push_back((size_t)atoll(argv[i]));
+	}
+	if (batchCounts.empty()) {
+		batchCounts = {16, 128, 1024};
+	}
+
+	bool ok = true;
+	for (size_t batchCount : batchCounts) {
+		// Arrays de texturas (poucas texturas para todos os OBJs) e uma textura por lote.
+		ok &= run(batchCount, 4);
+		ok &= run(batchCount, batchCount);
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+// Benchmark da compressão de texturas do assetcook: para cada imagem, comprime a cadeia de mipmaps em BC1, BC3 e BC7,
+// descomprime de volta e mede tempo de compressão, tamanho em relação ao RGBA8 e PSNR do nível 0 (só na CPU).
+// Uso: texture_compress_bench [diretório...] (padrão: ../models_archives)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "TextureCompressor.h"
+#include "TextureFile.h"
+
+// STB_IMAGE.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+using namespace std;
+
+// PSNR (dB) dos canais RGB ou RGBA do nível 0.
+static double level0_psnr(const TextureData& original, const TextureData& decoded, int channels) {
+	const TextureLevel& level = original.levels[0];
+	const uint8_t* a = &original.data[level.offset];
+	const uint8_t* b = &decoded.data[decoded.levels[0].offset];
+	double error = 0.0;
+	uint64_t samples = 0;
+	for (uint64_t i = 0; i < level.size; i += 4) {
+		for (int c = 0; c < channels; c++) {
+			double d = (double)a[i + c] - b[i + c];
+			error += d * d;
+			samples++;
+		}
+	}
+	if (error == 0.0) {
+		return 99.0;
+	}
+	return 10.0 * log10(255.0 * 255.0 / (error / samples));
+}
+
+int main(int argc, char** argv) {
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../models_archives");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			string extension = entry.path().extension().string();
+			transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+			if (entry.is_regular_file() && (extension == ".png" || extension == ".jpg" || extension == ".jpeg")) {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	const uint32_t FORMATS[] = {TEXTURE_BC1, TEXTURE_BC3, TEXTURE_BC7};
+	const char* NAMES[] = {"BC1", "BC3", "BC7"};
+
+	printf("%-44s %-4s %10s %10s %8s %9s\n", "arquivo", "fmt", "ms", "KB", "reducao", "PSNR dB");
+	for (const filesystem::path& file : files) {
+		string path = file.string();
+		int width, height, channels;
+		unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+		if (!pixels) {
+			printf("%-44s falha ao ler a imagem\n", path.c_str());
+			continue;
+		}
+		TextureData rgba;
+		build_rgba8_mip_chain(pixels, (uint32_t)width, (uint32_t)height, rgba);
+		stbi_image_free(pixels);
+		int psnrChannels = texture_has_alpha(rgba) ? 4 : 3;
+
+		for (int f = 0; f < 3; f++) {
+			TextureData compressed, decoded;
+			double best = 1e30;
+			for (int run = 0; run < 3; run++) {
+				auto start = chrono::steady_clock::now();
+				compress_texture(rgba, FORMATS[f], compressed);
+				best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+			}
+			decompress_texture(compressed, decoded);
+			printf("%-44s %-4s %10.1f %10.1f %7.1fx %9.2f\n", path.c_str(), NAMES[f], best,
+				   compressed.data.size() / 1024.0, (double)rgba.data.size() / compressed.data.size(),
+				   level0_psnr(rgba, decoded, psnrChannels));
+		}
+	}
+	return 0;
+}
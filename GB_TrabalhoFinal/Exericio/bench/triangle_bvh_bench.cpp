@@ -0,0 +1,190 @@
+// Benchmark da BVH de triângulos (TriangleBvh.h) sobre a saída indexada do leitor de OBJ (build_indexed_vertex_buffer:
+// 11 floats por vértice e 3 índices por triângulo). Para cada malha mede:
+// - a montagem em uma thread e com o pool (as duas devem dar a mesma árvore: nós, profundidade e acertos);
+// - o colapso para nós de 4 e de 8 filhos: tempo, nós, profundidade e memória;
+// - a taxa de raios (milhões por segundo) da árvore binária com os triângulos um a um (escalar) e 4 por vez (SSE2), e
+//   das árvores de 4 (SSE2) e 8 filhos (AVX2), em 200 mil raios que saem de uma esfera em volta da malha em direção a
+//   pontos da sua caixa envolvente; todos os caminhos devem acertar os mesmos triângulos, nas mesmas distâncias a menos
+//   de DISTANCE_TOLERANCE (relativa: compiladores podem fundir multiplicações e somas em FMA em um caminho e não em
+//   outro). Triângulos diferentes na mesma distância são empates em arestas compartilhadas, contados à parte.
+// Retorna 1 se algum resultado diferir.
+// Uso: triangle_bvh_bench [threads] [OBJ...] (padrão: 0 = núcleos da máquina, couch.obj e desk.obj de
+// ../../3D_Models/Novos)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+#include "ObjLoader.h"
+#include "ThreadPool.h"
+#include "TriangleBvh.h"
+
+using namespace std;
+
+template <typename Step>
+static double best_ms(int runs, Step step) {
+	double best = 1e30;
+	for (int run = 0; run < runs; run++) {
+		auto start = chrono::steady_clock::now();
+		step();
+		best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+struct Hit {
+	float distance;
+	uint32_t triangle;
+	bool found;
+};
+
+const float DISTANCE_TOLERANCE = 1e-5f;
+
+// Acertos de todos os raios com o caminho simd; retorna o tempo da melhor de 3 passadas.
+static double trace(const TriangleBvh& bvh, const vector<Ray>& rays, TriangleSimd simd, vector<Hit>& hits) {
+	hits.resize(rays.size());
+	return best_ms(3, [&] {
+		for (size_t r = 0; r < rays.size(); r++) {
+			float distance = 1e30f;
+			uint32_t triangle = 0;
+			hits[r].found = bvh.intersect(rays[r], distance, triangle, simd);
+			hits[r].distance = distance;
+			hits[r].triangle = triangle;
+		}
+	});
+}
+
+struct Differences {
+	size_t count = 0;
+	size_t ties = 0;
+};
+
+static Differences count_differences(const vector<Hit>& a, const vector<Hit>& b) {
+	Differences differences;
+	for (size_t r = 0; r < a.size(); r++) {
+		if (a[r].found != b[r].found) {
+			differences.count++;
+		} else if (a[r].found) {
+			float tolerance = DISTANCE_TOLERANCE * max(a[r].distance, b[r].distance);
+			if (fabs(a[r].distance - b[r].distance) > tolerance) {
+				differences.count++;
+			} else if (a[r].triangle != b[r].triangle) {
+				differences.ties++;
+			}
+		}
+	}
+	return differences;
+}
+
+static bool run(const string& path, ThreadPool& pool) {
+	ObjData data;
+	if (!load_obj(path, data)) {
+		printf("%s: nao encontrado\n", path.c_str());
+		return true;
+	}
+	vector<float> vertices;
+	vector<uint32_t> indices;
+	build_indexed_vertex_buffer(data, glm::vec3(1.0f), vertices, indices);
+	const uint8_t* positions = (const uint8_t*)vertices.data();
+	const size_t STRIDE = 11 * sizeof(float);
+	size_t triangleCount = indices.size() / 3;
+	printf("%s: %zu triangulos, %zu vertices\n", path.c_str(), triangleCount, vertices.size() / 11);
+
+	// Montagem.
+	TriangleBvh serial, parallel;
+	double serialMs = best_ms(3, [&] { serial.build(positions, STRIDE, indices.data(), triangleCount); });
+	double parallelMs = best_ms(3, [&] { parallel.build(positions, STRIDE, indices.data(), triangleCount, &pool); });
+	printf("  montagem: 1 thread %8.2f ms | pool de %d %8.2f ms (%.2fx)   %zu nos, profundidade %d, %.1f Mtri/s\n",
+		   serialMs, pool.size(), parallelMs, serialMs / parallelMs, serial.getNodeCount(), serial.getDepth(),
+		   triangleCount / serialMs / 1000.0);
+	bool same = serial.getNodeCount() == parallel.getNodeCount() && serial.getDepth() == parallel.getDepth();
+
+	// Raios de uma esfera com o dobro do raio da malha para pontos da caixa envolvente.
+	glm::vec3 boundsMin(vertices[0], vertices[1], vertices[2]), boundsMax = boundsMin;
+	for (size_t i = 0; i + 11 <= vertices.size(); i += 11) {
+		glm::vec3 position(vertices[i], vertices[i + 1], vertices[i + 2]);
+		boundsMin = glm::min(boundsMin, position);
+		boundsMax = glm::max(boundsMax, position);
+	}
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+	float radius = glm::length(boundsMax - boundsMin);
+	uint32_t seed = 12345;
+	auto random = [&seed]() {
+		seed = seed * 1664525u + 1013904223u;
+		return (seed >> 8) / 16777216.0f;
+	};
+	const size_t RAYS = 200000;
+	vector<Ray> rays(RAYS);
+	for (Ray& ray : rays) {
+		float z = 2.0f * random() - 1.0f, angle = 6.2832f * random();
+		float ring = sqrt(max(0.0f, 1.0f - z * z));
+		ray.origin = center + radius * glm::vec3(ring * cos(angle), ring * sin(angle), z);
+		glm::vec3 target = boundsMin + (boundsMax - boundsMin) * glm::vec3(random(), random(), random());
+		ray.direction = glm::normalize(target - ray.origin);
+	}
+
+	vector<Hit> reference, hits;
+	double scalarMs = trace(serial, rays, TRIANGLE_SIMD_SCALAR, reference);
+	size_t found = 0;
+	for (const Hit& hit : reference) {
+		found += hit.found ? 1 : 0;
+	}
+	trace(parallel, rays, TRIANGLE_SIMD_SCALAR, hits);
+	Differences poolDifferences = count_differences(reference, hits);
+	same &= poolDifferences.count == 0 && poolDifferences.ties == 0;
+	if (!same) {
+		printf("  montagem com o pool DIFERENTE da montagem em uma thread\n");
+	}
+	printf("  %-28s %8.2f Mraios/s   (%zu acertos em %zu)\n", "binaria, escalar", RAYS / scalarMs / 1000.0, found,
+		   RAYS);
+
+	double sseMs = trace(serial, rays, TRIANGLE_SIMD_SSE2, hits);
+	Differences sseDifferences = count_differences(reference, hits);
+	size_t differences = sseDifferences.count;
+	printf("  %-28s %8.2f Mraios/s   %zu diferencas, %zu empates\n", "binaria, SSE2", RAYS / sseMs / 1000.0,
+		   sseDifferences.count, sseDifferences.ties);
+
+	const int WIDTHS[] = {4, 8};
+	const TriangleSimd PATHS[] = {TRIANGLE_SIMD_SSE2, TRIANGLE_SIMD_AVX2};
+	for (int w = 0; w < 2; w++) {
+		double collapseMs = best_ms(3, [&] { serial.collapse(WIDTHS[w]); });
+		double wideMs = trace(serial, rays, PATHS[w], hits);
+		Differences wideDifferences = count_differences(reference, hits);
+		differences += wideDifferences.count;
+		char name[64];
+		snprintf(name, sizeof(name), "%d filhos, %s", WIDTHS[w], triangle_simd_name(PATHS[w]));
+		printf("  %-28s %8.2f Mraios/s   %zu diferencas, %zu empates; colapso %.2f ms, %zu nos, profundidade %d, "
+			   "%.1f MB\n",
+			   name, RAYS / wideMs / 1000.0, wideDifferences.count, wideDifferences.ties, collapseMs,
+			   serial.getWideNodeCount(), serial.getWideDepth(), serial.getMemoryBytes() / 1048576.0);
+	}
+	printf("\n");
+	return same && differences == 0;
+}
+
+int main(int argc, char** argv) {
+	int threads = argc > 1 ? atoi(argv[1]) : 0;
+	vector<string> paths;
+	for (int i = 2; i < argc; i++) {
+		paths.push_back(argv[i]);
+	}
+	if (paths.empty()) {
+		paths = {"../../3D_Models/Novos/couch.obj", "../../3D_Models/Novos/desk.obj"};
+	}
+
+	ThreadPool pool(threads);
+	printf("Teste vetorizado: %s (caminhos nao suportados usam o melhor disponivel)\n\n",
+		   triangle_simd_name(triangle_simd_supported()));
+	bool ok = true;
+	for (const string& path : paths) {
+		ok &= run(path, pool);
+	}
+	return ok ? 0 : 1;
+}
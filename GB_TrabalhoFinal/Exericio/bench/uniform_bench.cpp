@@ -0,0 +1,265 @@
+// Benchmark do custo de envio de uniforms por desenho, em uma janela oculta.
+// Com o shader de uniforms soltos (o Shader.vs/.fs anterior aos blocos, embutido abaixo), cada desenho envia os 12
+// uniforms do caminho por objeto (model, projection, diffuseMap, tex_buffer e os 8 do material) de três formas:
+//  - consulta: glGetUniformLocation a cada envio, com std::string criada do literal (Shader antes da tabela);
+//  - tabela: Shader::setX por nome, resolvido na tabela ordenada montada após a ligação;
+//  - handles: Uniform* resolvidos uma vez, sem strings nem consultas ao driver.
+// Com o shader atual (blocos uniformes e dados por instância), o FrameBlock é atualizado uma vez por quadro e:
+//  - blocos: cada desenho passa por um MeshBatch com uma única instância (envio da instância + rangeMaterial);
+//  - instanciado: todos os desenhos do quadro viram instâncias de um MeshBatch, desenhadas em uma única chamada.
+// Uso: uniform_bench [desenhos_por_quadro] [vertex_shader fragment_shader]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+#include "MeshBatch.h"
+#include "Shader.h"
+#include "UniformBlocks.h"
+
+// Shader com os uniforms soltos, como antes dos blocos uniformes.
+static const char* LOOSE_VERTEX_SHADER = R"(#version 410
+layout (location = 0) in vec3 position;
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+out vec3 fragPos;
+void main()
+{
+	gl_Position = projection * view * model * vec4(position, 1.0);
+	fragPos = vec3(model * vec4(position, 1.0));
+}
+)";
+
+static const char* LOOSE_FRAGMENT_SHADER = R"(#version 410
+in vec3 fragPos;
+out vec4 color;
+uniform sampler2D tex_buffer;
+uniform vec3 ka;
+uniform vec3 kd;
+uniform vec3 ks;
+uniform vec3 ke;
+uniform float ns;
+uniform float ni;
+uniform float d;
+uniform int illum;
+void main()
+{
+	vec3 result = (ka + kd * fragPos.x + ks * pow(max(fragPos.y, 0.0), d + ns + ni)) *
+				  texture(tex_buffer, fragPos.xy).rgb;
+	color = vec4(result + ke + float(illum), 1.0);
+}
+)";
+
+static std::string write_temporary(const char* name, const char* source) {
+	std::string path = (std::filesystem::temp_directory_path() / name).string();
+	std::ofstream(path) << source;
+	return path;
+}
+
+// Envio de uniforms como o Shader fazia antes da tabela de localizações.
+struct LegacyUniforms {
+	GLuint program;
+
+	void setInt(const std::string& name, int value) const {
+		glUniform1i(glGetUniformLocation(program, name.c_str()), value);
+	}
+	void setFloat(const std::string& name, float value) const {
+		glUniform1f(glGetUniformLocation(program, name.c_str()), value);
+	}
+	void setVec3(const std::string& name, float v1, float v2, float v3) const {
+		glUniform3f(glGetUniformLocation(program, name.c_str()), v1, v2, v3);
+	}
+	void setMat4(const std::string& name, const float* v) const {
+		glUniformMatrix4fv(glGetUniformLocation(program, name.c_str()), 1, GL_FALSE, v);
+	}
+};
+
+enum Mode { MODE_NONE, MODE_QUERY, MODE_TABLE, MODE_HANDLES, MODE_BLOCKS, MODE_INSTANCED };
+
+int main(int argc, char** argv) {
+	int draws = argc > 1 ? atoi(argv[1]) : 10000;
+	const char* vertexPath = argc > 3 ? argv[2] : "../shaders_archives/Shader.vs";
+	const char* fragmentPath = argc > 3 ? argv[3] : "../shaders_archives/Shader.fs";
+
+	glfwInit();
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "uniform_bench", nullptr, nullptr);
+	if (window == nullptr) {
+		printf("Nao foi possivel criar o contexto OpenGL\n");
+		glfwTerminate();
+		return EXIT_FAILURE;
+	}
+	glfwMakeContextCurrent(window);
+	glfwSwapInterval(0);
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+		printf("Failed to initialize GLAD\n");
+		return EXIT_FAILURE;
+	}
+
+	std::string looseVertexPath = write_temporary("uniform_bench.vs", LOOSE_VERTEX_SHADER);
+	std::string looseFragmentPath = write_temporary("uniform_bench.fs", LOOSE_FRAGMENT_SHADER);
+	Shader shader(looseVertexPath.c_str(), looseFragmentPath.c_str());
+	Shader blockShader(vertexPath, fragmentPath);
+	blockShader.bindUniformBlock("FrameBlock", FRAME_BLOCK_BINDING);
+	blockShader.bindUniformBlock("MaterialBlock", MATERIAL_BLOCK_BINDING);
+	FrameBlockData frameBlock = {};
+	UniformBuffer frameBuffer, materialBuffer;
+	frameBuffer.initialize(FRAME_BLOCK_BINDING, sizeof(FrameBlockData));
+	std::vector<MaterialBlockData> materials(MAX_MATERIALS, MaterialBlockData(Material()));
+	materialBuffer.initialize(MATERIAL_BLOCK_BINDING, materials.size() * sizeof(MaterialBlockData), materials.data());
+
+	// Um triângulo degenerado: o custo medido é o da CPU/driver, não o de rasterização.
+	GLuint VAO, VBO;
+	float vertices[9] = {0.0f};
+	glGenVertexArrays(1, &VAO);
+	glBindVertexArray(VAO);
+	glGenBuffers(1, &VBO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
+	glEnableVertexAttribArray(0);
+	MeshGeometry geometry;
+	geometry.VAO = VAO;
+	geometry.nVertices = 3;
+	MeshBatch batch;
+	batch.initialize(geometry, 0, GL_TEXTURE_2D, blockShader);
+	RenderQueue queue;
+	GlStateCache state;
+	auto drawBatch = [&]() {
+		state.reset();
+		queue.clear();
+		batch.enqueue(queue, state);
+		draw_render_queue(queue, state);
+	};
+
+	LegacyUniforms legacy = {shader.ID};
+	UniformMat4 model = shader.getUniform<UniformMat4>("model");
+	UniformMat4 projection = shader.getUniform<UniformMat4>("projection");
+	UniformInt diffuseMap = shader.getUniform<UniformInt>("diffuseMap");
+	UniformInt texBuffer = shader.getUniform<UniformInt>("tex_buffer");
+	UniformVec3 ka = shader.getUniform<UniformVec3>("ka");
+	UniformVec3 kd = shader.getUniform<UniformVec3>("kd");
+	UniformVec3 ks = shader.getUniform<UniformVec3>("ks");
+	UniformVec3 ke = shader.getUniform<UniformVec3>("ke");
+	UniformFloat ns = shader.getUniform<UniformFloat>("ns");
+	UniformFloat ni = shader.getUniform<UniformFloat>("ni");
+	UniformFloat d = shader.getUniform<UniformFloat>("d");
+	UniformInt illum = shader.getUniform<UniformInt>("illum");
+
+	float matrix[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+	const char* names[] = {"somente desenho", "consulta", "tabela", "handles", "blocos", "instanciado"};
+	const int uniformsPerDraw[] = {0, 12, 12, 12, 1, 0};
+	glm::mat4 instanceModel(1.0f);
+
+	printf("%d desenhos por quadro\n", draws);
+	printf("%-16s %10s %12s %14s %14s\n", "modo", "uniforms", "ms/quadro", "ns/desenho", "ns/uniform");
+	double baseline = 0.0;
+	for (int mode = MODE_NONE; mode <= MODE_INSTANCED; mode++) {
+		glUseProgram(mode >= MODE_BLOCKS ? blockShader.ID : shader.ID);
+		double best = 1e30;
+		for (int frame = 0; frame < 20; frame++) {
+			glFinish();
+			auto start = std::chrono::steady_clock::now();
+			if (mode >= MODE_BLOCKS) {
+				frameBuffer.update(&frameBlock, sizeof(frameBlock));
+			}
+			for (int i = 0; i < draws; i++) {
+				float value = (float)(i & 7) * 0.125f;
+				switch (mode) {
+					case MODE_QUERY:
+						legacy.setMat4("model", matrix);
+						legacy.setMat4("projection", matrix);
+						legacy.setInt("diffuseMap", 1);
+						legacy.setInt("tex_buffer", 0);
+						legacy.setVec3("ka", value, value, value);
+						legacy.setVec3("kd", value, value, value);
+						legacy.setVec3("ks", value, value, value);
+						legacy.setVec3("ke", value, value, value);
+						legacy.setFloat("ns", value);
+						legacy.setFloat("ni", value);
+						legacy.setFloat("d", value);
+						legacy.setInt("illum", 2);
+						break;
+					case MODE_TABLE:
+						shader.setMat4("model", matrix);
+						shader.setMat4("projection", matrix);
+						shader.setInt("diffuseMap", 1);
+						shader.setInt("tex_buffer", 0);
+						shader.setVec3("ka", value, value, value);
+						shader.setVec3("kd", value, value, value);
+						shader.setVec3("ks", value, value, value);
+						shader.setVec3("ke", value, value, value);
+						shader.setFloat("ns", value);
+						shader.setFloat("ni", value);
+						shader.setFloat("d", value);
+						shader.setInt("illum", 2);
+						break;
+					case MODE_HANDLES:
+						model.set(matrix);
+						projection.set(matrix);
+						diffuseMap.set(1);
+						texBuffer.set(0);
+						ka.set(value, value, value);
+						kd.set(value, value, value);
+						ks.set(value, value, value);
+						ke.set(value, value, value);
+						ns.set(value);
+						ni.set(value);
+						d.set(value);
+						illum.set(2);
+						break;
+					case MODE_BLOCKS:
+						batch.add(instanceModel, false, 1.0f);
+						drawBatch();
+						continue;
+					case MODE_INSTANCED:
+						batch.add(instanceModel, false, 1.0f);
+						continue;
+					default:
+						break;
+				}
+				glDrawArrays(GL_TRIANGLES, 0, 3);
+			}
+			if (mode == MODE_INSTANCED) {
+				drawBatch();
+			}
+			glFinish();
+			best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		if (mode == MODE_NONE) {
+			baseline = best;
+		}
+		double perDraw = best * 1e9 / draws;
+		double perUniform =
+			uniformsPerDraw[mode] == 0 ? 0.0 : (best - baseline) * 1e9 / draws / uniformsPerDraw[mode];
+		printf("%-16s %10d %12.2f %14.1f %14.1f\n", names[mode], uniformsPerDraw[mode], best * 1000.0, perDraw,
+			   perUniform);
+	}
+
+	batch.destroy();
+	frameBuffer.destroy();
+	materialBuffer.destroy();
+
+	glDeleteBuffers(1, &VBO);
+	glDeleteVertexArrays(1, &VAO);
+	glfwTerminate();
+	return EXIT_SUCCESS;
+}
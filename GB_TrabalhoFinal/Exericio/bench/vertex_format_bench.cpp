@@ -0,0 +1,163 @@
+// Benchmark dos formatos de vértice: para cada OBJ compara o VBO em float (8 floats, 32 bytes; o caminho sem cache usa
+// 11 floats com a cor, 44 bytes), o quantizado (quantize_mesh, 20 bytes) e o compactado (pack_mesh, 16 bytes), com o
+// erro máximo de cada um depois de decodificado como no vertex shader (posição relativa ao maior lado da caixa
+// envolvente, ângulo da normal e coordenada de textura).
+// A banda é medida lendo os vértices de todos os modelos, repetidos até passar de 256 MB no formato float, em ordem
+// (como a busca de vértices depois de optimize_vertex_fetch): com o volume fora do cache o tempo acompanha os bytes.
+// Uso: vertex_format_bench [diretório...] (padrão: ../../3D_Models)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+
+using namespace std;
+
+struct Format {
+	const char* name;
+	void (*convert)(MeshData& mesh);
+	size_t bytes = 0;		// soma dos VBOs
+	float position = 0.0f;	// maiores erros
+	float normalDegrees = 0.0f;
+	float texCoord = 0.0f;
+	vector<uint8_t> stream;	 // vértices de todos os modelos, para a medida de banda
+};
+
+static void keep_float(MeshData&) {}
+
+// Erros máximos de converted em relação a original (mesmos vértices, na mesma ordem).
+static void accumulate_error(const MeshData& original, const MeshData& converted, Format& format) {
+	float extent = 0.0f;
+	for (int axis = 0; axis < 3; axis++) {
+		extent = max(extent, original.boundsMax[axis] - original.boundsMin[axis]);
+	}
+	for (uint32_t v = 0; v < original.vertexCount; v++) {
+		float p0[3], t0[2], n0[3], p1[3], t1[2], n1[3];
+		decode_vertex(original, v, p0, t0, n0);
+		decode_vertex(converted, v, p1, t1, n1);
+
+		float distance = sqrtf((p0[0] - p1[0]) * (p0[0] - p1[0]) + (p0[1] - p1[1]) * (p0[1] - p1[1]) +
+							   (p0[2] - p1[2]) * (p0[2] - p1[2]));
+		if (extent > 0.0f) {
+			format.position = max(format.position, distance / extent);
+		}
+		float length0 = sqrtf(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+		float length1 = sqrtf(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+		if (length0 > 0.0f && length1 > 0.0f) {
+			float cosine = (n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2]) / (length0 * length1);
+			float degrees = acosf(max(-1.0f, min(1.0f, cosine))) * 57.29578f;
+			format.normalDegrees = max(format.normalDegrees, degrees);
+		}
+		format.texCoord = max(format.texCoord, max(fabsf(t0[0] - t1[0]), fabsf(t0[1] - t1[1])));
+	}
+}
+
+// Lê todo o buffer em palavras de 32 bits (a soma impede que o compilador descarte a leitura).
+static uint32_t read_stream(const vector<uint8_t>& stream) {
+	const uint32_t* words = (const uint32_t*)stream.data();
+	size_t count = stream.size() / sizeof(uint32_t);
+	uint32_t sum = 0;
+	for (size_t i = 0; i < count; i++) {
+		sum += words[i];
+	}
+	return sum;
+}
+
+int main(int argc, char** argv) {
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		roots.push_back(argv[i]);
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		for (const auto& entry : filesystem::recursive_directory_iterator(root)) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back(entry.path());
+			}
+		}
+	}
+	sort(files.begin(), files.end());
+
+	vector<Format> formats(3);
+	formats[0].name = "float";
+	formats[0].convert = keep_float;
+	formats[1].name = "quantizado";
+	formats[1].convert = quantize_mesh;
+	formats[2].name = "compactado";
+	formats[2].convert = pack_mesh;
+
+	printf("%-46s %8s | %10s %10s %10s\n", "arquivo", "vertices", "float KB", "quant. KB", "compac. KB");
+	size_t totalVertices = 0;
+	for (const filesystem::path& file : files) {
+		ObjData data;
+		if (!load_obj(file.string(), data)) {
+			printf("%-46s falha ao ler o arquivo\n", file.string().c_str());
+			continue;
+		}
+		MeshData mesh;
+		build_mesh_data(data, mesh);
+		optimize_vertex_fetch(mesh);
+		if (mesh.vertexCount == 0) {
+			continue;
+		}
+
+		printf("%-46s %8u |", file.string().c_str(), mesh.vertexCount);
+		for (Format& format : formats) {
+			MeshData converted = mesh;
+			format.convert(converted);
+			accumulate_error(mesh, converted, format);
+			format.bytes += converted.vertices.size();
+			format.stream.insert(format.stream.end(), converted.vertices.begin(), converted.vertices.end());
+			printf(" %10.1f", converted.vertices.size() / 1024.0);
+		}
+		printf("\n");
+		totalVertices += mesh.vertexCount;
+	}
+	if (totalVertices == 0) {
+		return 0;
+	}
+
+	// Repete os vértices da cena até o buffer em float passar de 256 MB (bem além do cache do processador).
+	const size_t STREAM_BYTES = (size_t)256 << 20;
+	size_t copies = (STREAM_BYTES + formats[0].stream.size() - 1) / formats[0].stream.size();
+	for (Format& format : formats) {
+		size_t size = format.stream.size();
+		format.stream.resize(size * copies);
+		for (size_t copy = 1; copy < copies; copy++) {
+			memcpy(&format.stream[copy * size], format.stream.data(), size);
+		}
+	}
+
+	printf("\n%-11s %7s %10s %10s %12s %14s %9s %10s\n", "formato", "B/vert", "VBOs KB", "memoria", "erro pos.",
+		   "normal (graus)", "erro uv", "ms leitura");
+	double floatMs = 0.0;
+	uint32_t checksum = 0;
+	for (Format& format : formats) {
+		double best = 1e30;
+		for (int run = 0; run < 5; run++) {
+			auto start = chrono::steady_clock::now();
+			checksum += read_stream(format.stream);
+			best = min(best, chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+		}
+		if (floatMs == 0.0) {
+			floatMs = best;
+		}
+		printf("%-11s %7zu %10.1f %9.0f%% %12.2e %14.4f %9.2e %10.2f  (%.1f GB/s, %.2fx)\n", format.name,
+			   format.bytes / totalVertices, format.bytes / 1024.0, 100.0 * format.bytes / formats[0].bytes,
+			   format.position, format.normalDegrees, format.texCoord, best, format.stream.size() / (best * 1e6),
+			   floatMs / best);
+	}
+	printf("(caminho sem cache: 44 bytes por vertice, %.1f KB; checksum %u)\n", totalVertices * 44 / 1024.0, checksum);
+	return 0;
+}
@@ -0,0 +1,228 @@
+// assetcook: prepara offline os modelos e texturas do trabalho.
+// - OBJ -> .gbmesh indexado, com níveis de detalhe simplificados, em ordem de cache de vértices e de menor overdraw e
+//   com vértices compactados;
+// - PNG/JPG -> .gbtex com a cadeia de mipmaps já filtrada e comprimida em blocos.
+// Os arquivos gerados ficam ao lado dos originais e são usados pelo app no lugar do texto/imagem.
+// Um arquivo só é refeito quando o hash do conteúdo de origem ou o formato pedido (formato dos vértices, formato ou
+// filtro dos mipmaps) mudam, ou com --force.
+//
+// Uso: assetcook [--force] [--threads N] [--format auto|rgba8|bc1|bc3|bc7] [--filter box|kaiser] [--linear]
+//                 [--vertex packed|quantized] [diretório...]
+//      (padrão: --format auto --filter box --vertex packed, ../../3D_Models ../models_archives)
+// auto = BC1 nas imagens opacas e BC3 nas com transparência; bc7 tem mais qualidade, mas exige
+// ARB_texture_compression_bptc (sem ele o app descomprime a textura ao carregar).
+// Os mipmaps são filtrados em luz linear (as imagens são sRGB); --linear filtra direto nos bytes, como antes, e
+// kaiser preserva mais detalhe que a caixa 2x2 nos níveis menores.
+// packed grava vértices de 16 bytes (posição em 16 bits na caixa envolvente, normal octaédrica) e quantized os de
+// 20 bytes com a posição em float (MeshOptimizer.h: pack_mesh e quantize_mesh).
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "MipGenerator.h"
+#include "ObjLoader.h"
+#include "TextureCompressor.h"
+#include "TextureFile.h"
+#include "ThreadPool.h"
+
+// STB_IMAGE.
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+using namespace std;
+
+enum CookResult { COOK_DONE, COOK_SKIPPED, COOK_FAILED };
+
+// Formato pedido com --format (além dos de TextureFormat).
+const int FORMAT_AUTO = -1;
+
+static bool parse_format(const string& name, int& format) {
+	static const pair<const char*, int> FORMATS[] = {{"auto", FORMAT_AUTO},
+													 {"rgba8", TEXTURE_RGBA8},
+													 {"bc1", TEXTURE_BC1},
+													 {"bc3", TEXTURE_BC3},
+													 {"bc7", TEXTURE_BC7}};
+	for (const auto& known : FORMATS) {
+		if (name == known.first) {
+			format = known.second;
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool is_image(const filesystem::path& path) {
+	string extension = path.extension().string();
+	transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+	return extension == ".png" || extension == ".jpg" || extension == ".jpeg";
+}
+
+static CookResult cook_mesh(const string& objPath, bool force, bool packed) {
+	SourceStamp source;
+	if (!stat_source(objPath, source)) {
+		return COOK_FAILED;
+	}
+	source.hash = hash_file(objPath);
+
+	string outputPath = mesh_cache_path(objPath);
+	if (!force) {
+		MeshCacheFile existing;
+		uint32_t stride = packed ? 16 : 20;
+		if (existing.open(outputPath) && (existing.getHeader().flags & MESH_CACHE_COOKED) &&
+			existing.getHeader().source.hash == source.hash && existing.getHeader().vertexStride == stride) {
+			return COOK_SKIPPED;
+		}
+	}
+
+	ObjData data;
+	if (!load_obj(objPath, data)) {
+		return COOK_FAILED;
+	}
+	MeshData mesh;
+	build_mesh_data(data, mesh);
+	generate_mesh_lods(mesh);
+	optimize_mesh_vertex_cache(mesh);
+	optimize_mesh_overdraw(mesh);
+	optimize_vertex_fetch(mesh);
+	if (packed) {
+		pack_mesh(mesh);
+	} else {
+		quantize_mesh(mesh);
+	}
+	return write_mesh_cache(outputPath, mesh, source, MESH_CACHE_COOKED) ? COOK_DONE : COOK_FAILED;
+}
+
+static CookResult cook_texture(const string& imagePath, bool force, int format, const MipOptions& mipOptions) {
+	SourceStamp source;
+	if (!stat_source(imagePath, source)) {
+		return COOK_FAILED;
+	}
+	source.hash = hash_file(imagePath);
+
+	string outputPath = texture_file_path(imagePath);
+	uint32_t flags = (mipOptions.filter == MIP_FILTER_KAISER ? TEXTURE_MIP_KAISER : 0) |
+					 (mipOptions.srgb ? 0 : TEXTURE_MIP_LINEAR);
+	if (!force) {
+		TextureFile existing;
+		if (existing.open(outputPath) && existing.getHeader().source.hash == source.hash &&
+			existing.getHeader().flags == flags) {
+			uint32_t cooked = existing.getHeader().format;
+			bool sameFormat = format == FORMAT_AUTO ? cooked == TEXTURE_BC1 || cooked == TEXTURE_BC3
+													 : cooked == (uint32_t)format;
+			if (sameFormat) {
+				return COOK_SKIPPED;
+			}
+		}
+	}
+
+	int width, height, nrChannels;
+	unsigned char* pixels = stbi_load(imagePath.c_str(), &width, &height, &nrChannels, 4);
+	if (pixels == nullptr) {
+		return COOK_FAILED;
+	}
+	TextureData texture;
+	build_mip_chain(pixels, (uint32_t)width, (uint32_t)height, 4, texture, mipOptions);
+	stbi_image_free(pixels);
+
+	if (format == FORMAT_AUTO) {
+		format = texture_has_alpha(texture) ? TEXTURE_BC3 : TEXTURE_BC1;
+	}
+	TextureData compressed;
+	compress_texture(texture, (uint32_t)format, compressed);
+	return write_texture_file(outputPath, compressed, source, flags) ? COOK_DONE : COOK_FAILED;
+}
+
+int main(int argc, char** argv) {
+	bool force = false;
+	int threads = 0;
+	int format = FORMAT_AUTO;
+	MipOptions mipOptions;
+	bool packed = true;
+	vector<string> roots;
+	for (int i = 1; i < argc; i++) {
+		string argument = argv[i];
+		if (argument == "--force") {
+			force = true;
+		} else if (argument == "--threads" && i + 1 < argc) {
+			threads = atoi(argv[++i]);
+		} else if (argument == "--format" && i + 1 < argc) {
+			if (!parse_format(argv[++i], format)) {
+				fprintf(stderr, "Formato desconhecido: %s (use auto, rgba8, bc1, bc3 ou bc7)\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+		} else if (argument == "--filter" && i + 1 < argc) {
+			string filter = argv[++i];
+			if (filter != "box" && filter != "kaiser") {
+				fprintf(stderr, "Filtro desconhecido: %s (use box ou kaiser)\n", filter.c_str());
+				return EXIT_FAILURE;
+			}
+			mipOptions.filter = filter == "box" ? MIP_FILTER_BOX : MIP_FILTER_KAISER;
+		} else if (argument == "--linear") {
+			mipOptions.srgb = false;
+		} else if (argument == "--vertex" && i + 1 < argc) {
+			string vertex = argv[++i];
+			if (vertex != "packed" && vertex != "quantized") {
+				fprintf(stderr, "Formato de vertice desconhecido: %s (use packed ou quantized)\n", vertex.c_str());
+				return EXIT_FAILURE;
+			}
+			packed = vertex == "packed";
+		} else {
+			roots.push_back(argument);
+		}
+	}
+	if (roots.empty()) {
+		roots.push_back("../../3D_Models");
+		roots.push_back("../models_archives");
+	}
+
+	vector<filesystem::path> files;
+	for (const string& root : roots) {
+		error_code error;
+		for (filesystem::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+			if (it->is_regular_file() && (it->path().extension() == ".obj" || is_image(it->path()))) {
+				files.push_back(it->path());
+			}
+		}
+		if (error) {
+			fprintf(stderr, "Nao foi possivel percorrer %s: %s\n", root.c_str(), error.message().c_str());
+		}
+	}
+	sort(files.begin(), files.end());
+
+	ThreadPool pool(threads);
+	mipOptions.pool = &pool;
+	mutex outputMutex;
+	atomic<int> done(0), skipped(0), failed(0);
+	auto start = chrono::steady_clock::now();
+
+	// Um arquivo por tarefa; os arquivos maiores vão primeiro para equilibrar as threads.
+	stable_sort(files.begin(), files.end(), [](const filesystem::path& a, const filesystem::path& b) {
+		return filesystem::file_size(a) > filesystem::file_size(b);
+	});
+	pool.parallelFor((int)files.size(), [&](int i) {
+		string path = files[i].string();
+		auto fileStart = chrono::steady_clock::now();
+		CookResult result = files[i].extension() == ".obj" ? cook_mesh(path, force, packed)
+															: cook_texture(path, force, format, mipOptions);
+		double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - fileStart).count();
+
+		const char* status = result == COOK_DONE ? "preparado" : result == COOK_SKIPPED ? "sem mudancas" : "FALHOU";
+		(result == COOK_DONE ? done : result == COOK_SKIPPED ? skipped : failed)++;
+		lock_guard<mutex> lock(outputMutex);
+		printf("%-12s %8.1f ms  %s\n", status, ms, path.c_str());
+	});
+
+	double totalMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+	printf("%d preparados, %d sem mudancas, %d falhas em %.1f ms (%d threads)\n", done.load(), skipped.load(),
+		   failed.load(), totalMs, pool.size());
+	return failed.load() > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -4,51 +4,70 @@ in vec3 finalColor;
 in vec3 fragPos;
 in vec3 scaledNormal;
 in vec2 texCoord;
+flat in int materialIndex; // índice no MaterialBlock
+flat in float selected;
+flat in float textureLayer; // camada em tex_array (-1 = tex_buffer)
 
 out vec4 color;
 
-// Textura
+// Textura: 2D ou camada de um array de texturas com o mesmo formato e dimensões
 uniform sampler2D tex_buffer;
+uniform sampler2DArray tex_array;
 
-// Propriedades da superfície
-uniform vec3 ka; // Ambient reflectivity
-uniform vec3 kd; // Diffuse reflectivity
-uniform vec3 ks; // Specular reflectivity
-uniform vec3 ke; // Emissive color
-uniform float d;
+// Dados por quadro (UniformBlocks.h: FrameBlockData)
+layout (std140) uniform FrameBlock
+{
+    mat4 view;
+    mat4 projection;
+    vec4 cameraPos; // Posição da Câmera
+    vec4 lightPos;  // Propriedades da fonte de luz
+    vec4 lightColor;
+};
 
-// Propriedades da fonte de luz
-uniform vec3 lightPos;
-uniform vec3 lightColor;
+// Propriedades da superfície (UniformBlocks.h: MaterialBlockData)
+#define MAX_MATERIALS 128
 
-// Posição da Câmera
-uniform vec3 cameraPos;
+struct MaterialData
+{
+    vec4 ka; // Ambient reflectivity
+    vec4 kd; // Diffuse reflectivity
+    vec4 ks; // Specular reflectivity
+    vec4 ke; // Emissive color
+    vec4 params; // x = ns, y = ni, z = d, w = illum
+};
+
+layout (std140) uniform MaterialBlock
+{
+    MaterialData materials[MAX_MATERIALS];
+};
 
 void main()
 {
+    MaterialData material = materials[materialIndex];
+
     // Cálculo da parcela de iluminação ambiente
-    vec3 ambient = ka * lightColor;
+    vec3 ambient = material.ka.rgb * lightColor.rgb;
 
     // Cálculo da parcela de iluminação difusa
     vec3 N = normalize(scaledNormal);
-    vec3 L = normalize(lightPos - fragPos);
+    vec3 L = normalize(lightPos.xyz - fragPos);
     float diff = max(dot(N, L), 0.0);
-    vec3 diffuse = kd * diff * lightColor;
+    vec3 diffuse = material.kd.rgb * diff * lightColor.rgb;
 
     // Cálculo da parcela de iluminação especular
-    vec3 V = normalize(cameraPos - fragPos);
+    vec3 V = normalize(cameraPos.xyz - fragPos);
     vec3 R = reflect(-L, N);
-    float spec = pow(max(dot(R, V), 0.0), d);
-    vec3 specular = ks * spec * lightColor;
+    float spec = pow(max(dot(R, V), 0.0), material.params.z);
+    vec3 specular = material.ks.rgb * spec * lightColor.rgb;
 
     // Sample the texture color
-    vec4 texColor = texture(tex_buffer, texCoord);
+    vec4 texColor = textureLayer >= 0.0 ? texture(tex_array, vec3(texCoord, textureLayer)) : texture(tex_buffer, texCoord);
 
     // Combine the texture color with the lighting calculations
     vec3 result = (ambient + diffuse) * texColor.rgb + specular;
 
-    // Add emissive color
-    result += ke;
+    // Add emissive color (o objeto selecionado recebe um destaque fixo)
+    result += selected > 0.5 ? vec3(0.2, 0.1, 0.0) : material.ke.rgb;
 
     // Set the final color
     color = vec4(result, 1.0);
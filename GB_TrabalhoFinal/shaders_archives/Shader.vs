@@ -3,22 +3,60 @@
 layout (location = 0) in vec3 position;
 layout (location = 1) in vec3 color;
 layout (location = 2) in vec2 texc;
-layout (location = 3) in vec3 normal;
+layout (location = 3) in vec3 normal; // nas malhas compactadas: x, y octaédricos
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Dados por instância (MeshBatch.h: MeshInstance), avançam uma vez por instância
+layout (location = 4) in mat4 model; // ocupa as localizações 4 a 7
+layout (location = 8) in vec4 instanceParams; // x = primeiro material do objeto, y = selecionado, z = escala do zoom em clip space, w = camada da textura (-1 = textura 2D)
+
+// Dados por quadro (UniformBlocks.h: FrameBlockData)
+layout (std140) uniform FrameBlock
+{
+	mat4 view;
+	mat4 projection;
+	vec4 cameraPos;
+	vec4 lightPos;
+	vec4 lightColor;
+};
+
+// Índice do material da faixa desenhada, relativo ao primeiro material do objeto
+uniform int rangeMaterial;
+
+// Decodificação dos vértices do lote (MeshBatch.h: VertexDecode): nas malhas compactadas a posição chega em [0, 1]
+// dentro da caixa envolvente e a normal em coordenadas octaédricas
+uniform vec3 positionOffset = vec3(0.0);
+uniform vec3 positionScale = vec3(1.0);
+uniform bool octahedralNormal = false;
 
 out vec3 finalColor;
 out vec3 fragPos;
 out vec3 scaledNormal;
 out vec2 texCoord;
+flat out int materialIndex;
+flat out float selected;
+flat out float textureLayer;
+
+vec3 decode_octahedral(vec2 e)
+{
+	vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
 
 void main()
 {
-	gl_Position = projection * view * model * vec4(position, 1.0);
+	vec3 localPos = positionOffset + position * positionScale;
+	vec3 localNormal = octahedralNormal ? decode_octahedral(normal.xy) : normal;
+	gl_Position = projection * view * model * vec4(localPos, 1.0);
+	// O zoom do objeto troca o campo de visão da projeção, o que equivale a escalar x e y em clip space.
+	gl_Position.xy *= instanceParams.z;
 	finalColor = color;
-	fragPos = vec3(model * vec4(position, 1.0));
-	scaledNormal = vec3(model * vec4(normal, 1.0));
+	fragPos = vec3(model * vec4(localPos, 1.0));
+	scaledNormal = vec3(model * vec4(localNormal, 1.0));
 	texCoord = vec2(texc.x, 1 - texc.y);
-}
\ No newline at end of file
+	materialIndex = int(instanceParams.x) + rangeMaterial;
+	selected = instanceParams.y;
+	textureLayer = instanceParams.w;
+}